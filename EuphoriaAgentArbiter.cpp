@@ -0,0 +1,178 @@
+#include "EuphoriaAgentArbiter.h"
+#include "LECLog.h"
+
+#include <string.h>
+
+namespace euphoria
+{
+    // USING DECLARATIONS
+    using lec::LecTraceChannel;
+    using namespace RavenMath;
+
+    // LOCAL CONST INITIALIZATION
+    namespace
+    {
+        const float kArbiterHalfValueDistance = 15.0f;  //!< A body this far from the viewer is worth half as much
+        const float kArbiterHalfValueTime = 3.0f;       //!< A performance this old is worth half as much
+        const float kArbiterOffScreenWeight = 0.4f;
+        const float kArbiterOnScreenDot = 0.64f;        //!< About 50 degrees either side of the view direction
+    }
+
+    // Define statics
+    const float AgentArbiter::kPreemptMargin = 1.5f;
+
+    // Direct hits first, the player sees those land. Must be in ePerformanceType order.
+    const float AgentArbiter::msTypeWeights[] = {
+        0.5f,   // eEPA
+        0.8f,   // eExplosion
+        1.0f,   // ePunch
+        0.9f,   // eShove
+        0.9f,   // eThrow
+        0.7f,   // eHitReact
+        0.6f,   // eFalling
+        0.8f,   // eGunshot
+        0.4f,   // eBalance
+        0.2f    // eBlend
+    };
+
+    AgentArbiter::AgentArbiter()
+        : mbHasViewer(false), mbHasViewerForward(false), mbIsEnabled(true), mCapacity(0), mbStarvedThisFrame(false)
+    {
+        Vec3Set(mViewerPos, 0.0f, 0.0f, 0.0f);
+        Vec3Set(mViewerForward, 0.0f, 0.0f, 1.0f);
+        ResetStats();
+    }
+
+    void AgentArbiter::SetViewerPosition(const Vec3& position)
+    {
+        Vec3Set(mViewerPos, position);
+        mbHasViewer = true;
+    }
+
+    void AgentArbiter::SetViewerForward(const Vec3& forward)
+    {
+        Vec3 previous;
+        Vec3Set(previous, mViewerForward);
+        Vec3NormalizeSafe(mViewerForward, forward, previous);
+        mbHasViewerForward = true;
+    }
+
+    /*!
+     * Scores a body for an agent. Without a viewer only the performance type and
+     * its age count.
+     */
+    float AgentArbiter::Score(ePerformanceType type, const Vec3& position, float timeInPerformance) const
+    {
+        LECASSERT(type > eInvalid && type < eSize);
+        float score = msTypeWeights[type] / (1.0f + timeInPerformance / kArbiterHalfValueTime);
+
+        if (mbHasViewer)
+        {
+            Vec3 toBody;
+            Vec3Sub(toBody, position, mViewerPos);
+            const float distance = Vec3Mag(toBody);
+            score /= 1.0f + distance / kArbiterHalfValueDistance;
+
+            if (mbHasViewerForward && distance > 0.0f && Vec3Dot(toBody, mViewerForward) < kArbiterOnScreenDot * distance)
+            {
+                score *= kArbiterOffScreenWeight;
+            }
+        }
+        return score;
+    }
+
+    /*!
+     * A request found no agent free. numHeld is what the components hold right
+     * now, which is as many as the engine has.
+     */
+    void AgentArbiter::CountContested(uint32 numHeld)
+    {
+        ++mNumContested;
+        mCapacity = numHeld;
+    }
+
+    /*!
+     * A request found no agent free and nothing worth preempting
+     */
+    void AgentArbiter::CountStarved()
+    {
+        ++mNumStarved;
+        mbStarvedThisFrame = true;
+    }
+
+    /*!
+     * Called from ThinkAll with the number of components holding an agent
+     */
+    void AgentArbiter::EndFrame(uint32 numHeld)
+    {
+        ++mNumFrames;
+        mTotalHeld += numHeld;
+        if (mCapacity > 0 && numHeld >= mCapacity)
+        {
+            ++mNumSaturatedFrames;
+        }
+        if (mbStarvedThisFrame)
+        {
+            ++mNumStarvedFrames;
+            mbStarvedThisFrame = false;
+        }
+    }
+
+    void AgentArbiter::ResetStats()
+    {
+        mNumContested = 0;
+        mNumPreempted = 0;
+        mNumStarved = 0;
+        mNumFrames = 0;
+        mNumSaturatedFrames = 0;
+        mNumStarvedFrames = 0;
+        mTotalHeld = 0;
+    }
+
+    void AgentArbiter::TraceStats() const
+    {
+        const float meanHeld = (mNumFrames > 0) ? static_cast<float>(mTotalHeld) / mNumFrames : 0.0f;
+        if (mCapacity > 0)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaArbiter: %.1f agents held on average of %u (%.0f%%), saturated %u of %u frames\n",
+                       meanHeld, mCapacity, 100.0f * meanHeld / mCapacity, mNumSaturatedFrames, mNumFrames);
+        }
+        else
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaArbiter: %.1f agents held on average over %u frames, never ran out\n", meanHeld, mNumFrames);
+        }
+        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaArbiter: %u contested, %u preempted, %u starved (in %u frames)%s\n",
+                   mNumContested, mNumPreempted, mNumStarved, mNumStarvedFrames, mbIsEnabled ? "" : ", preemption off");
+    }
+
+    /*!
+     * Handles "EuphoriaArbiter stats|reset|on|off". Returns true if the message was ours.
+     */
+    bool AgentArbiter::HandleMessage(const char* msg)
+    {
+        static const char kPrefix[] = "EuphoriaArbiter ";
+        if (strncmp(msg, kPrefix, sizeof(kPrefix) - 1) != 0)
+        {
+            return false;
+        }
+
+        const char* pCommand = msg + sizeof(kPrefix) - 1;
+        if (strcmp(pCommand, "stats") == 0)
+        {
+            TraceStats();
+        }
+        else if (strcmp(pCommand, "reset") == 0)
+        {
+            ResetStats();
+        }
+        else if (strcmp(pCommand, "on") == 0 || strcmp(pCommand, "off") == 0)
+        {
+            mbIsEnabled = (pCommand[1] == 'n');
+        }
+        else
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaArbiter: unknown command %s\n", pCommand);
+        }
+        return true;
+    }
+}
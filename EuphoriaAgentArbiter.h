@@ -0,0 +1,92 @@
+#ifndef EUPHORIA_AGENT_ARBITER_H
+#define EUPHORIA_AGENT_ARBITER_H
+
+#include "RoninConfig.h"
+#include "RavenMath.h"
+#include "EuphoriaParams.h"
+
+namespace euphoria
+{
+    /*!
+     * Decides who gets an agent when the engine has none left. Requests and
+     * running performances are scored on the same scale from how far the body
+     * is from the viewer, whether it is in front of the viewer, what kind of
+     * performance it is and, for running ones, how long it has been running.
+     * A request that is worth more than kPreemptMargin times the lowest running
+     * performance takes that performance's agent; the loser carries on as a
+     * passive ragdoll.
+     *
+     * Performances that are blending back to animation are never preempted,
+     * they are about to give their agent back anyway.
+     *
+     * The arbiter also keeps the utilisation figures. Capacity is learned: it is
+     * the number of agents held the last time a request found none free.
+     *
+     *   EuphoriaArbiter stats|reset|on|off
+     */
+    class AgentArbiter
+    {
+    public:
+        static const float kPreemptMargin;
+
+    private:
+        // STATIC MEMBERS
+        static const float msTypeWeights[eSize];
+
+        // MEMBERS
+        RavenMath::Vec3 mViewerPos;
+        RavenMath::Vec3 mViewerForward;
+        bool mbHasViewer;
+        bool mbHasViewerForward;
+        bool mbIsEnabled;
+
+        uint32 mCapacity;
+        bool mbStarvedThisFrame;
+
+        // Stats since the last reset
+        uint32 mNumContested;
+        uint32 mNumPreempted;
+        uint32 mNumStarved;
+        uint32 mNumFrames;
+        uint32 mNumSaturatedFrames;
+        uint32 mNumStarvedFrames;
+        uint32 mTotalHeld;
+
+        // NOT IMPLEMENTED
+        AgentArbiter(const AgentArbiter&);
+        AgentArbiter& operator=(const AgentArbiter&);
+
+    public:
+        // CREATORS
+        AgentArbiter();
+
+        // MANIPULATORS
+        void SetViewerPosition(const RavenMath::Vec3& position);
+        void SetViewerForward(const RavenMath::Vec3& forward);
+        void CountContested(uint32 numHeld);
+        inline void CountPreempted();
+        void CountStarved();
+        void EndFrame(uint32 numHeld);
+        void ResetStats();
+        bool HandleMessage(const char* msg);
+
+        // ACCESSORS
+        float Score(ePerformanceType type, const RavenMath::Vec3& position, float timeInPerformance) const;
+        inline bool IsEnabled() const;
+        void TraceStats() const;
+    };
+
+    // INLINES
+    void AgentArbiter::CountPreempted()
+    {
+        ++mNumPreempted;
+    }
+
+    bool AgentArbiter::IsEnabled() const
+    {
+        return mbIsEnabled;
+    }
+}
+
+// EUPHORIA_AGENT_ARBITER_H
+#endif
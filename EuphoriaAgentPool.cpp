@@ -0,0 +1,295 @@
+#include "EuphoriaAgentPool.h"
+#include "LECLog.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace euphoria
+{
+    // USING DECLARATIONS
+    using lec::LecTraceChannel;
+
+    // Define statics
+    // Close enough that the player sees the death blend
+    const float AgentPool::kDefaultReleaseDistance = 10.0f;
+
+    AgentPool::AgentPool()
+        : mPendingHead(0), mNumPending(0), mHistoryIndex(0), mFrame(0), mDemandThisFrame(0), mBindsThisFrame(0), mBindBudget(kMinBindsPerFrame), mbIsBudgetEnabled(false),
+          mpReleasePolicy(&DefaultReleasePolicy), mfReleaseDistance(kDefaultReleaseDistance), mbIsReleaseEnabled(false)
+    {
+        memset(mDemandHistory, 0, sizeof(mDemandHistory));
+        ResetStats();
+    }
+
+    /*!
+     * Called from ThinkAll before the queue is served. Closes off last frame's
+     * demand and sizes this frame's bind budget from the window.
+     */
+    void AgentPool::BeginFrame()
+    {
+        mDemandHistory[mHistoryIndex] = mDemandThisFrame;
+        mHistoryIndex = (mHistoryIndex + 1) % kDemandWindowFrames;
+
+        uint32 peakDemand = 0;
+        for (uint32 i = 0; i < kDemandWindowFrames; ++i)
+        {
+            if (mDemandHistory[i] > peakDemand)
+            {
+                peakDemand = mDemandHistory[i];
+            }
+        }
+
+        mBindBudget = (peakDemand + kSpreadFrames - 1) / kSpreadFrames;
+        if (mBindBudget < kMinBindsPerFrame)
+        {
+            mBindBudget = kMinBindsPerFrame;
+        }
+
+        mDemandThisFrame = 0;
+        mBindsThisFrame = 0;
+        ++mFrame;
+    }
+
+    /*!
+     * Asks for a new agent for renID. With the budget on, queued requests go
+     * first, so nothing is granted directly while the queue is non-empty.
+     */
+    AgentPool::Grant AgentPool::Request(Ronin::RenID renID, bool bAgentAvailable)
+    {
+        ++mDemandThisFrame;
+
+        // Nothing to bind without a free agent, and nothing to spread without the budget
+        if (!mbIsBudgetEnabled || !bAgentAvailable)
+        {
+            ++mNumGranted;
+            return eGranted;
+        }
+
+        if (mNumPending == 0 && mBindsThisFrame < mBindBudget)
+        {
+            ++mBindsThisFrame;
+            ++mNumGranted;
+            return eGranted;
+        }
+
+        // Late rather than never
+        if (mNumPending == kMaxPending)
+        {
+            ++mBindsThisFrame;
+            ++mNumOverBudget;
+            return eGranted;
+        }
+
+        Queue(renID);
+        return eDeferred;
+    }
+
+    /*!
+     * Queues a start that has been granted but found no agent free yet, such as
+     * one waiting on a preempted agent the engine has not given back. It is
+     * served from ThinkAll next frame like any other. Returns false if the
+     * queue is full.
+     */
+    bool AgentPool::Defer(Ronin::RenID renID)
+    {
+        if (mNumPending == kMaxPending)
+        {
+            return false;
+        }
+
+        Queue(renID);
+        return true;
+    }
+
+    /*!
+     * Grants an agent only if nothing is queued and the budget has room. Used to
+     * upgrade passive ragdolls, which are not counted as demand.
+     */
+    bool AgentPool::TryGrant()
+    {
+        if (!mbIsBudgetEnabled || (mNumPending == 0 && mBindsThisFrame < mBindBudget))
+        {
+            ++mBindsThisFrame;
+            ++mNumUpgraded;
+            return true;
+        }
+        return false;
+    }
+
+    /*!
+     * Takes the oldest queued request if this frame's budget allows it to bind,
+     * or if it has waited kMaxDeferFrames. Everything is served once the budget
+     * is switched off. Returns false when there is nothing more to do this frame.
+     */
+    void AgentPool::Queue(Ronin::RenID renID)
+    {
+        LECASSERT(mNumPending < kMaxPending);
+        PendingStart& rPending = mPending[(mPendingHead + mNumPending) % kMaxPending];
+        rPending.mRenID = renID;
+        rPending.mRequestFrame = mFrame;
+        ++mNumPending;
+        ++mNumDeferred;
+    }
+
+    bool AgentPool::PopPending(Ronin::RenID& outRenID)
+    {
+        if (mNumPending == 0)
+        {
+            return false;
+        }
+
+        const PendingStart& rPending = mPending[mPendingHead];
+        const uint32 deferFrames = mFrame - rPending.mRequestFrame;
+        if (mbIsBudgetEnabled && mBindsThisFrame >= mBindBudget)
+        {
+            if (deferFrames < kMaxDeferFrames)
+            {
+                return false;
+            }
+            ++mNumOverBudget;
+        }
+        ++mBindsThisFrame;
+        ++mNumServed;
+        mTotalDeferFrames += deferFrames;
+
+        outRenID = rPending.mRenID;
+        mPendingHead = (mPendingHead + 1) % kMaxPending;
+        --mNumPending;
+        return true;
+    }
+
+    /*!
+     * Installs the game's release policy. NULL puts back the default.
+     */
+    void AgentPool::SetReleasePolicy(ReleasePolicy pPolicy)
+    {
+        mpReleasePolicy = (pPolicy != NULL) ? pPolicy : &DefaultReleasePolicy;
+    }
+
+    /*!
+     * Asks the release policy about a body that has come to rest, and counts
+     * the bodies it lets go. Only the dead are ever asked about: a released
+     * body is frozen in the static dead pose, which a knocked out NPC that is
+     * still alive must never be left in.
+     */
+    bool AgentPool::ShouldRelease(const SettledBody& rBody)
+    {
+        if (!mbIsReleaseEnabled || !rBody.mbIsDead || !mpReleasePolicy(rBody, mfReleaseDistance))
+        {
+            return false;
+        }
+        ++mNumReleased;
+        return true;
+    }
+
+    /*!
+     * Near the viewer the dead still blend into the dead pose; at the release
+     * distance or further they are frozen straight away. Nothing is released
+     * until the game has set a viewer, as there is no telling what is seen.
+     */
+    bool AgentPool::DefaultReleasePolicy(const SettledBody& rBody, float releaseDistance)
+    {
+        return rBody.mfViewerDistance >= 0.0f && rBody.mfViewerDistance >= releaseDistance;
+    }
+
+    /*!
+     * Called from ThinkAll with the number of components holding an agent
+     */
+    void AgentPool::EndFrame(uint32 numHeld)
+    {
+        mNumHeld = numHeld;
+        if (numHeld > mPeakHeld)
+        {
+            mPeakHeld = numHeld;
+        }
+        if (mDemandThisFrame > mPeakDemand)
+        {
+            mPeakDemand = mDemandThisFrame;
+        }
+    }
+
+    void AgentPool::ResetStats()
+    {
+        mNumGranted = 0;
+        mNumDeferred = 0;
+        mNumServed = 0;
+        mNumOverBudget = 0;
+        mNumPassive = 0;
+        mNumUpgraded = 0;
+        mNumReleased = 0;
+        mTotalDeferFrames = 0;
+        mNumHeld = 0;
+        mPeakHeld = 0;
+        mPeakDemand = 0;
+    }
+
+    void AgentPool::TraceStats() const
+    {
+        if (mbIsBudgetEnabled)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaAgents: %u held (peak %u), budget %u/frame, %u queued, peak demand %u/frame\n",
+                       mNumHeld, mPeakHeld, mBindBudget, mNumPending, mPeakDemand);
+        }
+        else
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaAgents: %u held (peak %u), no bind budget, peak demand %u/frame\n",
+                       mNumHeld, mPeakHeld, mPeakDemand);
+        }
+        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaAgents: %u granted, %u deferred (%u started, mean wait %.1f frames), %u started over budget\n",
+                   mNumGranted, mNumDeferred, mNumServed, (mNumServed > 0) ? static_cast<float>(mTotalDeferFrames) / mNumServed : 0.0f, mNumOverBudget);
+        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaAgents: %u passive ragdoll fallbacks, %u upgraded to an agent\n", mNumPassive, mNumUpgraded);
+        if (mbIsReleaseEnabled)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaAgents: %u released early (release distance %.1f)\n", mNumReleased, mfReleaseDistance);
+        }
+        else
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaAgents: early release off\n");
+        }
+    }
+
+    /*!
+     * Handles "EuphoriaAgents stats|reset|budget on|budget off|release <metres>|release off".
+     * Returns true if the message was ours.
+     */
+    bool AgentPool::HandleMessage(const char* msg)
+    {
+        static const char kPrefix[] = "EuphoriaAgents ";
+        if (strncmp(msg, kPrefix, sizeof(kPrefix) - 1) != 0)
+        {
+            return false;
+        }
+
+        const char* pCommand = msg + sizeof(kPrefix) - 1;
+        if (strcmp(pCommand, "stats") == 0)
+        {
+            TraceStats();
+        }
+        else if (strcmp(pCommand, "reset") == 0)
+        {
+            ResetStats();
+        }
+        else if (strcmp(pCommand, "budget on") == 0)
+        {
+            mbIsBudgetEnabled = true;
+        }
+        else if (strcmp(pCommand, "budget off") == 0)
+        {
+            // Whatever is queued is served at the top of the next frame
+            mbIsBudgetEnabled = false;
+        }
+        else if (strcmp(pCommand, "release off") == 0)
+        {
+            mbIsReleaseEnabled = false;
+        }
+        else if (sscanf(pCommand, "release %f", &mfReleaseDistance) == 1)
+        {
+            mbIsReleaseEnabled = true;
+        }
+        else
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaAgents: unknown command %s\n", pCommand);
+        }
+        return true;
+    }
+}
@@ -0,0 +1,178 @@
+#ifndef EUPHORIA_AGENT_POOL_H
+#define EUPHORIA_AGENT_POOL_H
+
+#include "RoninConfig.h"
+#include "Rens/RenTypes.h"
+
+namespace euphoria
+{
+    /*!
+     * What a release policy is told about a dead body that has come to rest
+     */
+    struct SettledBody
+    {
+        Ronin::RenID mRenID;
+        bool mbIsDead;
+        bool mbIsRecoveryEnabled;       //!< False when the script is keeping the NPC down
+        float mfViewerDistance;         //!< Negative if the game has not set a viewer
+    };
+
+    /*!
+     * Returns true if a settled body should be frozen and its agent released
+     * rather than blended back to animation
+     */
+    typedef bool (*ReleasePolicy)(const SettledBody& rBody, float releaseDistance);
+
+    /*!
+     * Hands out Euphoria agents to components starting a performance. By default
+     * every request is granted straight away.
+     *
+     * Binding a fresh agent to a ragdoll is the expensive part of the first
+     * StartBehavior, so a bind budget can be switched on to spread bursts out.
+     * With it on, requests over the budget wait in a queue and are started,
+     * oldest first, at the top of the following frames. Nothing is dropped: a
+     * request that has waited kMaxDeferFrames, or that finds the queue full, is
+     * started over budget. Requests made while no agent is free are never
+     * queued, as there is nothing to bind; the component preempts or falls back.
+     *
+     * The budget is sized from recent demand: enough to serve the busiest frame
+     * of the last kDemandWindowFrames over kSpreadFrames frames, and never below
+     * kMinBindsPerFrame. A burst after a quiet spell is spread thinly at first
+     * and drains faster as the pool sees it.
+     *
+     * Components that already hold an agent do not come through the pool. Ones
+     * that cannot get an agent fall back to a passive ragdoll, on the ProxyRagdoll
+     * away from the viewer and the engine's own ragdoll near it, and ask again
+     * with TryGrant until it settles.
+     *
+     * Agents can also be given back early. This is off until switched on with
+     * "EuphoriaAgents release", and does nothing until the game has set the
+     * viewer position through EuphoriaManager. A dead body that has come to
+     * rest then asks ShouldRelease before it starts its death blend, and one
+     * the release policy no longer cares about is frozen in the static dead
+     * pose there and then. The default policy releases bodies at least the
+     * release distance from the viewer. The living, knocked out or not, are
+     * never released.
+     *
+     *   EuphoriaAgents budget on|off
+     *   EuphoriaAgents release <metres>|off
+     */
+    class AgentPool
+    {
+    public:
+        enum Grant
+        {
+            eGranted,       //!< Bind now
+            eDeferred       //!< Queued, the component will be started from ThinkAll
+        };
+
+        enum
+        {
+            kMaxPending = 256,
+            kMaxDeferFrames = 8,        //!< Queued requests are started over budget after this long
+            kDemandWindowFrames = 120,
+            kSpreadFrames = 4,
+            kMinBindsPerFrame = 4
+        };
+
+        static const float kDefaultReleaseDistance;
+
+    private:
+        struct PendingStart
+        {
+            Ronin::RenID mRenID;
+            uint32 mRequestFrame;
+        };
+
+        // MEMBERS
+        PendingStart mPending[kMaxPending];         //!< Ring buffer, oldest at mPendingHead
+        uint32 mPendingHead;
+        uint32 mNumPending;
+
+        uint32 mDemandHistory[kDemandWindowFrames]; //!< Agent requests per frame, ring buffer
+        uint32 mHistoryIndex;
+        uint32 mFrame;
+        uint32 mDemandThisFrame;
+        uint32 mBindsThisFrame;
+        uint32 mBindBudget;
+        bool mbIsBudgetEnabled;
+
+        ReleasePolicy mpReleasePolicy;
+        float mfReleaseDistance;
+        bool mbIsReleaseEnabled;
+
+        // Stats since the last reset
+        uint32 mNumGranted;
+        uint32 mNumDeferred;
+        uint32 mNumServed;
+        uint32 mNumOverBudget;
+        uint32 mNumPassive;
+        uint32 mNumUpgraded;
+        uint32 mNumReleased;
+        uint32 mTotalDeferFrames;
+        uint32 mNumHeld;
+        uint32 mPeakHeld;
+        uint32 mPeakDemand;
+
+        // NOT IMPLEMENTED
+        AgentPool(const AgentPool&);
+        AgentPool& operator=(const AgentPool&);
+
+        // METHODS
+        static bool DefaultReleasePolicy(const SettledBody& rBody, float releaseDistance);
+        void Queue(Ronin::RenID renID);
+
+    public:
+        // CREATORS
+        AgentPool();
+
+        // MANIPULATORS
+        void BeginFrame();
+        Grant Request(Ronin::RenID renID, bool bAgentAvailable);
+        bool Defer(Ronin::RenID renID);
+        bool TryGrant();
+        inline void CountPassiveFallback();
+        void SetReleasePolicy(ReleasePolicy pPolicy);
+        bool ShouldRelease(const SettledBody& rBody);
+        bool PopPending(Ronin::RenID& outRenID);
+        void EndFrame(uint32 numHeld);
+        void ResetStats();
+        bool HandleMessage(const char* msg);
+
+        // ACCESSORS
+        inline uint32 GetNumPending() const;
+        inline uint32 GetBindBudget() const;
+        inline bool IsBudgetEnabled() const;
+        inline bool IsReleaseEnabled() const;
+        void TraceStats() const;
+    };
+
+    // INLINES
+    void AgentPool::CountPassiveFallback()
+    {
+        ++mNumPassive;
+    }
+
+    uint32 AgentPool::GetNumPending() const
+    {
+        return mNumPending;
+    }
+
+    uint32 AgentPool::GetBindBudget() const
+    {
+        return mBindBudget;
+    }
+
+    bool AgentPool::IsBudgetEnabled() const
+    {
+        return mbIsBudgetEnabled;
+    }
+
+    bool AgentPool::IsReleaseEnabled() const
+    {
+        return mbIsReleaseEnabled;
+    }
+}
+
+// EUPHORIA_AGENT_POOL_H
+#endif
@@ -36,7 +36,7 @@ struct EuphoriaBehaviorCRC
     {
         // Balance Performance
         eBlockWithArms  = 0x56e4d202, //  1457836546, "BlockWithArms_BalancingAct"
-        eStaggerBalance = 0x51c41231, //  1371804209, "StaggerBalance6_BalancingAct"
+        eStaggerBalance = 0x9ca06ae9, // -1667208471, "StaggerBalance6_BalancingAct"
         eBalanceArms    = 0xafc45887, // -1346086777, "BalanceArms_BalancingAct"
         eLandingFall    = 0x574d62a9, //  1464689321, "LandingFallWindmill_BalancingAct"
         eFallDown       = 0xa6344d61, // -1506521759, "FallDown_BalancingAct"
@@ -62,10 +62,10 @@ struct EuphoriaBehaviorCRC
         eImpactReaction = 0xd8791725, //  -663152859, "ImpactReaction_DropZone"
 
         // Hit React Performance
-        eReact          = 0xe7d41823, //  -405530589, "React_PerfHitReact2"
-        eTransfer_HR    = 0x513f2d38, //  1363094840, "Transfer_PerfHitReact2"
-        eCrunch_HR      = 0x9433ac99, // -1808552807, "Crunch_PerfHitReact2"
-        eImpact_HR      = 0xb014c5fa, // -1340815878, "Impact_PerfHitReact2"
+        eReact          = 0xdcba38eb, //  -591775509, "React_PerfHitReact2"
+        eTransfer_HR    = 0x6a510df0, //  1783696880, "Transfer_PerfHitReact2"
+        eCrunch_HR      = 0xaf5d8c51, // -1352823727, "Crunch_PerfHitReact2"
+        eImpact_HR      = 0x8b7ae532, // -1954880206, "Impact_PerfHitReact2"
 
         // Punch Performance
         ePunch          = 0x5c868676, //  1552320118, "Force_Punch"
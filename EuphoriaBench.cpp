@@ -0,0 +1,354 @@
+#include "EuphoriaBench.h"
+
+#if EUPHORIA_PROFILE_ENABLED
+
+#include "BoneCRC.h"
+#include "EuphoriaComp.h"
+#include "EuphoriaEvent.h"
+#include "EuphoriaManager.h"
+#include "EuphoriaReplay.h"
+#include "EuphoriaStruct.h"
+#include "EuphoriaUtilities.h"
+#include "LECLog.h"
+#include "Performances/FallingPerformance.h"
+// Component Interfaces
+#include "AnimationComponentPlugInInterface.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace euphoria
+{
+    // USING DECLARATIONS
+    using lec::LecTraceChannel;
+    using Ronin::EuphoriaComp;
+    using Ronin::gpEuphoriaManager;
+
+    /*!
+     * Inputs shared by every call of a run. Results go to mSink so the calls are
+     * not optimized away.
+     */
+    struct Bench::Context
+    {
+        EuphoriaComp* mpEuphoriaComp;
+        FallingPerformance* mpFalling;
+        RavenMath::Vec3 mvLeftHandPos;
+        uint32 mCall;
+        volatile float mSink;
+    };
+
+    // Define statics
+    Bench::Entry Bench::msEntries[] =
+    {
+        { "DetermineGetupPosition", &Bench::BenchDetermineGetupPosition, false, 0, 0, 0 },
+        { "CheckBodyForMovement", &Bench::BenchCheckBodyForMovement, false, 0, 0, 0 },
+        { "SearchForGrabbableEdge", &Bench::BenchSearchForGrabbableEdge, false, 0, 0, 0 },
+        { "CreateEuphoriaBehaviorEvent", &Bench::BenchCreateEuphoriaBehaviorEvent, false, 0, 0, 0 },
+        { "Falling::IsMovingFast", &Bench::BenchFallingIsMovingFast, false, 0, 0, 0 },
+        { "Falling::IsLayingOnBack", &Bench::BenchFallingIsLayingOnBack, false, 0, 0, 0 },
+        { "Falling::IsFallingFeetFirst", &Bench::BenchFallingIsFallingFeetFirst, false, 0, 0, 0 },
+        { "Falling::GetAverageSpeedOfBody", &Bench::BenchFallingGetAverageSpeedOfBody, false, 0, 0, 0 },
+        { "Falling::GetHeightFromGround", &Bench::BenchFallingGetHeightFromGround, false, 0, 0, 0 },
+        { "Falling::GetTimeAndDistanceToImpact", &Bench::BenchFallingGetTimeAndDistanceToImpact, false, 0, 0, 0 }
+    };
+    const uint32 Bench::mskNumEntries = sizeof(Bench::msEntries) / sizeof(Bench::msEntries[0]);
+
+    // LOCAL CONST INITIALIZATION
+    namespace
+    {
+        //! Cycled through so every case of the conversion is exercised
+        const BehaviorFeedback::BehaviorEventType kBenchBehaviorEvents[] =
+        {
+            BehaviorFeedback::BET_LeftArmReached,
+            BehaviorFeedback::BET_Relaxed,
+            BehaviorFeedback::BET_Flail,
+            BehaviorFeedback::BET_StaggerBalanced,
+            BehaviorFeedback::BET_StaggerStartedFalling,
+            BehaviorFeedback::BET_Collision,
+            BehaviorFeedback::BET_ConstrainLeftHand,
+            BehaviorFeedback::BET_HangFall
+        };
+        const uint32 kNumBenchBehaviorEvents = sizeof(kBenchBehaviorEvents) / sizeof(kBenchBehaviorEvents[0]);
+
+        const float kBenchFrameTime = 1.0f / 30.0f;
+
+        int CompareSamples(const void* pA, const void* pB)
+        {
+            const uint32 a = *static_cast<const uint32*>(pA);
+            const uint32 b = *static_cast<const uint32*>(pB);
+            return (a < b) ? -1 : ((a > b) ? 1 : 0);
+        }
+    }
+
+    void Bench::BenchDetermineGetupPosition(Context& rContext)
+    {
+        rContext.mSink += static_cast<float>(rContext.mpEuphoriaComp->DetermineGetupPosition());
+    }
+
+    /*!
+     * The stationary timer is put back afterwards, see Run
+     */
+    void Bench::BenchCheckBodyForMovement(Context& rContext)
+    {
+        rContext.mpEuphoriaComp->CheckBodyForMovement(kBenchFrameTime);
+    }
+
+    void Bench::BenchSearchForGrabbableEdge(Context& rContext)
+    {
+        GrabbedEdgeInfo grabbedEdge;
+        RavenMath::Vec3 closestPoint;
+        float distanceToEdge;
+        euphoria::SearchForGrabbableEdge(rContext.mvLeftHandPos, grabbedEdge, closestPoint, distanceToEdge);
+        rContext.mSink += distanceToEdge;
+    }
+
+    void Bench::BenchCreateEuphoriaBehaviorEvent(Context& rContext)
+    {
+        const BehaviorFeedback::BehaviorEventType eventType = kBenchBehaviorEvents[rContext.mCall % kNumBenchBehaviorEvents];
+        const EuphoriaBehaviorEvent event = euphoria::CreateEuphoriaBehaviorEvent(eventType, NULL, NULL);
+        rContext.mSink += static_cast<float>(event.GetType());
+    }
+
+    void Bench::BenchFallingIsMovingFast(Context& rContext)
+    {
+        rContext.mSink += rContext.mpFalling->IsMovingFast() ? 1.0f : 0.0f;
+    }
+
+    void Bench::BenchFallingIsLayingOnBack(Context& rContext)
+    {
+        rContext.mSink += rContext.mpFalling->IsLayingOnBack() ? 1.0f : 0.0f;
+    }
+
+    void Bench::BenchFallingIsFallingFeetFirst(Context& rContext)
+    {
+        rContext.mSink += rContext.mpFalling->IsFallingFeetFirst() ? 1.0f : 0.0f;
+    }
+
+    void Bench::BenchFallingGetAverageSpeedOfBody(Context& rContext)
+    {
+        rContext.mSink += rContext.mpFalling->GetAverageSpeedOfBody();
+    }
+
+    void Bench::BenchFallingGetHeightFromGround(Context& rContext)
+    {
+        float hitDist;
+        RavenMath::Vec3 hitNormal;
+        rContext.mpFalling->GetHeightFromGround(hitDist, hitNormal);
+        rContext.mSink += hitDist;
+    }
+
+    void Bench::BenchFallingGetTimeAndDistanceToImpact(Context& rContext)
+    {
+        float time;
+        float hitDist;
+        rContext.mpFalling->GetTimeAndDistanceToImpact(time, hitDist);
+        rContext.mSink += time;
+    }
+
+    /*!
+     * Times iterations calls in samples of kCallsPerSample, so calls far shorter
+     * than the clock's resolution still measure
+     */
+    void Bench::RunEntry(Entry& rEntry, Context& rContext, uint32 iterations)
+    {
+        static uint32 sSamples[kMaxSamples];
+
+        uint32 numSamples = iterations / kCallsPerSample;
+        numSamples = (numSamples < 1) ? 1 : ((numSamples > kMaxSamples) ? kMaxSamples : numSamples);
+
+        // One untimed pass to warm the caches
+        rContext.mCall = 0;
+        for (uint32 i = 0; i < kCallsPerSample; ++i)
+        {
+            rEntry.mpFunction(rContext);
+            ++rContext.mCall;
+        }
+
+        for (uint32 s = 0; s < numSamples; ++s)
+        {
+            const ProfileTicks start = Profiler::ReadTicks();
+            for (uint32 i = 0; i < kCallsPerSample; ++i)
+            {
+                rEntry.mpFunction(rContext);
+                ++rContext.mCall;
+            }
+            const ProfileTicks elapsed = Profiler::ReadTicks() - start;
+            sSamples[s] = Profiler::TicksToMicroseconds(elapsed * 1000) / kCallsPerSample;
+        }
+
+        qsort(sSamples, numSamples, sizeof(sSamples[0]), CompareSamples);
+        rEntry.mbHasResult = true;
+        rEntry.mMin = sSamples[0];
+        rEntry.mMedian = sSamples[numSamples / 2];
+        rEntry.mMax = sSamples[numSamples - 1];
+
+        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaBench: %-36s %8u calls  min %7u  p50 %7u  max %7u ns\n",
+                   rEntry.mpName, numSamples * kCallsPerSample, rEntry.mMin, rEntry.mMedian, rEntry.mMax);
+    }
+
+    /*!
+     * Runs the named benchmark, or all of them, against target's component. The
+     * target must be ragdolled: most of these read the Euphoria body parts.
+     */
+    bool Bench::Run(const char* pName, Ronin::RenID target, uint32 iterations)
+    {
+        EuphoriaComp* pEuphoriaComp = gpEuphoriaManager->GetEuphoriaComp(target);
+        if (pEuphoriaComp == NULL || !pEuphoriaComp->IsEuphoriaActive())
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaBench: target has no active Euphoria component\n");
+            return false;
+        }
+
+        // The queries made here would go into the stream
+        if (Replay::IsRecording() || Replay::IsReplaying())
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaBench: stop the replay recording first\n");
+            return false;
+        }
+
+        Context context;
+        context.mpEuphoriaComp = pEuphoriaComp;
+        context.mpFalling = pEuphoriaComp->GetFallingPerformance();
+        context.mCall = 0;
+        context.mSink = 0.0f;
+        pEuphoriaComp->GetAnimationInterface()->GetBodyPartByBone(BoneCRC::eLeftHand0)->GetPosition(context.mvLeftHandPos);
+
+        const float stationaryElapsedTime = pEuphoriaComp->GetStationaryElapsedTime();
+
+        const bool bAll = (strcmp(pName, "all") == 0);
+        bool bFound = false;
+        for (uint32 i = 0; i < mskNumEntries; ++i)
+        {
+            if (bAll || strcmp(pName, msEntries[i].mpName) == 0)
+            {
+                RunEntry(msEntries[i], context, iterations);
+                bFound = true;
+            }
+        }
+
+        pEuphoriaComp->SetStationaryElapsedTime(stationaryElapsedTime);
+
+        if (!bFound)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaBench: no benchmark called %s\n", pName);
+        }
+        return bFound;
+    }
+
+    /*!
+     * Writes name,median lines for every benchmark that has been run
+     */
+    bool Bench::Save(const char* pPath)
+    {
+        FILE* pFile = fopen(pPath, "w");
+        if (pFile == NULL)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaBench: could not open %s\n", pPath);
+            return false;
+        }
+
+        for (uint32 i = 0; i < mskNumEntries; ++i)
+        {
+            if (msEntries[i].mbHasResult)
+            {
+                fprintf(pFile, "%s,%u\n", msEntries[i].mpName, msEntries[i].mMedian);
+            }
+        }
+
+        fclose(pFile);
+        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaBench: baseline written to %s\n", pPath);
+        return true;
+    }
+
+    /*!
+     * Checks the last results against a baseline written by Save. Returns false if
+     * any median is more than percent over its baseline.
+     */
+    bool Bench::Compare(const char* pPath, float percent)
+    {
+        FILE* pFile = fopen(pPath, "r");
+        if (pFile == NULL)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaBench: could not open %s\n", pPath);
+            return false;
+        }
+
+        uint32 numRegressed = 0;
+        char name[128];
+        uint32 baseline;
+        while (fscanf(pFile, " %127[^,],%u", name, &baseline) == 2)
+        {
+            for (uint32 i = 0; i < mskNumEntries; ++i)
+            {
+                const Entry& rEntry = msEntries[i];
+                if (!rEntry.mbHasResult || strcmp(name, rEntry.mpName) != 0)
+                {
+                    continue;
+                }
+
+                const bool bRegressed = static_cast<float>(rEntry.mMedian) > static_cast<float>(baseline) * (1.0f + percent / 100.0f);
+                if (bRegressed)
+                {
+                    ++numRegressed;
+                }
+                LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaBench: %-36s p50 %7u ns  baseline %7u ns  %s\n",
+                           rEntry.mpName, rEntry.mMedian, baseline, bRegressed ? "REGRESSED" : "ok");
+            }
+        }
+
+        fclose(pFile);
+        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaBench: %u regressed by more than %.0f%%\n", numRegressed, percent);
+        return numRegressed == 0;
+    }
+
+    void Bench::List()
+    {
+        for (uint32 i = 0; i < mskNumEntries; ++i)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaBench: %s\n", msEntries[i].mpName);
+        }
+    }
+
+    /*!
+     * Returns true if the message was a benchmark message. See the class comment.
+     */
+    bool Bench::HandleMessage(const char* msg, Ronin::RenID target)
+    {
+        static const char kPrefix[] = "EuphoriaBench ";
+        if (strncmp(msg, kPrefix, sizeof(kPrefix) - 1) != 0)
+        {
+            return false;
+        }
+
+        const char* pCommand = msg + sizeof(kPrefix) - 1;
+        char arg[256];
+        uint32 iterations = kDefaultIterations;
+        float percent = 10.0f;
+        if (strcmp(pCommand, "list") == 0)
+        {
+            List();
+        }
+        else if (sscanf(pCommand, "run %255s %u", arg, &iterations) >= 1)
+        {
+            Run(arg, target, iterations);
+        }
+        else if (sscanf(pCommand, "save %255s", arg) == 1)
+        {
+            Save(arg);
+        }
+        else if (sscanf(pCommand, "compare %255s %f", arg, &percent) >= 1)
+        {
+            Compare(arg, percent);
+        }
+        else
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaBench: unknown command %s\n", pCommand);
+        }
+
+        return true;
+    }
+}
+
+// EUPHORIA_PROFILE_ENABLED
+#endif
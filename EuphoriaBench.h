@@ -0,0 +1,92 @@
+#ifndef EUPHORIA_BENCH_H
+#define EUPHORIA_BENCH_H
+
+#include "EuphoriaProfiler.h"
+
+#if EUPHORIA_PROFILE_ENABLED
+
+#include "Rens/RenTypes.h"
+
+namespace euphoria
+{
+    /*!
+     * Micro-benchmarks for the functions the frame timings keep pointing at, run
+     * against a live component so the engine queries inside them are the real ones.
+     * Each benchmark calls its function with the same inputs every time: body state
+     * does not change while a message is being handled, and inputs such as the hand
+     * position are read once per run. Results are per call, in nanoseconds.
+     *
+     * Only functions without side effects on the engine are covered.
+     * TryToGrabNearbyEdges, RerouteSystem::CallMappedMethod and
+     * BlendPerformance::InitiateBlend create constraints or start behaviors, so they
+     * are left to the ThinkAll/state timings; SearchForGrabbableEdge is the search
+     * half of TryToGrabNearbyEdges.
+     *
+     * Driven from EuphoriaManager::HandleMessage, targeting a ragdolled NPC:
+     *
+     *   EuphoriaBench list
+     *   EuphoriaBench run <name|all> [iterations]
+     *   EuphoriaBench save <path>                  writes the last results as a baseline
+     *   EuphoriaBench compare <path> [percent]     flags medians over the baseline by more than percent (default 10)
+     *
+     * @note There is no headless build of this layer yet. It needs stand-ins for the
+     *       animation, physics, edge system and game plugin interfaces and for
+     *       AssetCatalog, and those must be compiled against the engine's own headers,
+     *       which live outside this plugin. Until then these benchmarks and
+     *       EuphoriaScenario are how the layer gets timed, inside the engine.
+     */
+    class Bench
+    {
+    public:
+        enum
+        {
+            kCallsPerSample = 16,
+            kMaxSamples = 1024,
+            kDefaultIterations = 2048
+        };
+
+        static bool Run(const char* pName, Ronin::RenID target, uint32 iterations);
+        static bool Save(const char* pPath);
+        static bool Compare(const char* pPath, float percent);
+        static void List();
+        static bool HandleMessage(const char* msg, Ronin::RenID target);
+
+    private:
+        struct Context;
+        typedef void (*BenchFunction)(Context& rContext);
+
+        struct Entry
+        {
+            const char* mpName;
+            BenchFunction mpFunction;
+            bool mbHasResult;
+            uint32 mMin;                //!< Nanoseconds per call
+            uint32 mMedian;
+            uint32 mMax;
+        };
+
+        static void RunEntry(Entry& rEntry, Context& rContext, uint32 iterations);
+
+        // Benchmarks
+        static void BenchDetermineGetupPosition(Context& rContext);
+        static void BenchCheckBodyForMovement(Context& rContext);
+        static void BenchSearchForGrabbableEdge(Context& rContext);
+        static void BenchCreateEuphoriaBehaviorEvent(Context& rContext);
+        static void BenchFallingIsMovingFast(Context& rContext);
+        static void BenchFallingIsLayingOnBack(Context& rContext);
+        static void BenchFallingIsFallingFeetFirst(Context& rContext);
+        static void BenchFallingGetAverageSpeedOfBody(Context& rContext);
+        static void BenchFallingGetHeightFromGround(Context& rContext);
+        static void BenchFallingGetTimeAndDistanceToImpact(Context& rContext);
+
+        // STATIC MEMBERS
+        static Entry msEntries[];
+        static const uint32 mskNumEntries;
+    };
+}
+
+// EUPHORIA_PROFILE_ENABLED
+#endif
+
+// EUPHORIA_BENCH_H
+#endif
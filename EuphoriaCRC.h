@@ -0,0 +1,64 @@
+#ifndef EUPHORIA_CRC_H
+#define EUPHORIA_CRC_H
+
+/*!
+ * Compile-time version of stricrc32, used to check the hand-maintained CRC enums in
+ * EuphoriaBehaviorCRC.h and EuphoriaNameCRC.h against their strings. The algorithm must
+ * match stricrc32 exactly: reflected CRC32 (0xEDB88320), zero seed, no final xor,
+ * computed over the upper-cased string.
+ *
+ * The PS3 and older Microsoft compilers have no constexpr. There the checks fall back to
+ * LECASSERTs in debug builds, and the enums still load as immediates everywhere.
+ */
+
+#if (defined(__cplusplus) && __cplusplus >= 201103L) || (defined(_MSC_VER) && _MSC_VER >= 1900)
+#define EUPHORIA_HAS_CONSTEXPR 1
+#else
+#define EUPHORIA_HAS_CONSTEXPR 0
+#endif
+
+#if EUPHORIA_HAS_CONSTEXPR
+
+namespace euphoria
+{
+    namespace crc_detail
+    {
+        constexpr unsigned int Upper(char c)
+        {
+            return (c >= 'a' && c <= 'z') ? static_cast<unsigned int>(c - 'a' + 'A') : static_cast<unsigned int>(static_cast<unsigned char>(c));
+        }
+
+        constexpr unsigned int Step(unsigned int crc, int bits)
+        {
+            return (bits == 0) ? crc : Step((crc >> 1) ^ ((crc & 1u) ? 0xEDB88320u : 0u), bits - 1);
+        }
+
+        constexpr unsigned int Stri(const char* str, unsigned int crc)
+        {
+            return (*str == '\0') ? crc : Stri(str + 1, Step(crc ^ Upper(*str), 8));
+        }
+    }
+
+    /*! Same result as stricrc32(str), folded by the compiler. */
+    constexpr unsigned int ConstStriCRC32(const char* str)
+    {
+        return crc_detail::Stri(str, 0u);
+    }
+}
+
+#define EUPHORIA_VERIFY_CRC(value, str) \
+    static_assert(static_cast<unsigned int>(value) == euphoria::ConstStriCRC32(str), "CRC enum out of date: " str)
+
+#elif defined(_DEBUG)
+
+#define EUPHORIA_VERIFY_CRC(value, str) \
+    LECASSERTMSG(static_cast<crc32_t>(value) == CRCINIT(str), "CRC enum out of date: " str)
+
+#else
+
+#define EUPHORIA_VERIFY_CRC(value, str) ((void)0)
+
+#endif
+
+// EUPHORIA_CRC_H
+#endif
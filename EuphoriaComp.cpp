@@ -1,8 +1,16 @@
 #include "EuphoriaComp.h"
 #include "BoneCRC.h"
+#include "CollisionCastStructs.h"
+#include "CollisionManagerPlugInInterface.h"
+#include "EuphoriaDebugDraw.h"
 #include "EuphoriaEvent.h"
 #include "EuphoriaManager.h"
+#include "EuphoriaNameCRC.h"
 #include "EuphoriaParams.h"
+#include "EuphoriaProfiler.h"
+#include "EuphoriaReplay.h"
+#include "EuphoriaTimeline.h"
+#include "EuphoriaTrace.h"
 #include "Performances/BalancePerformance.h"
 #include "Performances/BlendPerformance.h"
 #include "Performances/EPAPerformance.h"
@@ -17,6 +25,7 @@
 #include "RoninPhysics_Base.h"
 // Component Interfaces
 #include "AnimationComponentPlugInInterface.h"
+#include "AnimParamsInterface.h"
 #include "EdgeSystemManagerPlugInInterface.h"
 #include "FortuneGameCompPlugInInterface.h"
 #include "PhysicsComponentPlugInInterface.h"
@@ -24,6 +33,13 @@
 // Schemas
 #include "DefEuphoriaPerformance.schema.h"
 
+// Skips the stationary velocity poll while the ragdoll's island is asleep. Off
+// until RoninPhysicsEntity::IsActive is confirmed against the physics layer;
+// the plugin has no sleep notification to subscribe to instead.
+#ifndef EUPHORIA_RAGDOLL_SLEEP_QUERY
+#define EUPHORIA_RAGDOLL_SLEEP_QUERY 0
+#endif
+
 #define EUPHORIA_MILESTONE_HACK
 #ifdef EUPHORIA_MILESTONE_HACK
     // Declare any state variables supporting the MILESTONE HACK
@@ -42,6 +58,15 @@ namespace Ronin
     using namespace lec;
     using lec::AssetKey;                // Here to avoid ambiguous symbol errors
 
+    EUPHORIA_PROFILE_DEFINE_SCOPE(EuphoriaComp, Think);
+    EUPHORIA_PROFILE_DEFINE_SCOPE(EuphoriaComp, OnEvent);
+
+    // The manager's pass over idle components reads one cache line each
+    typedef char EuphoriaCompHotFitsCacheLine[(sizeof(EuphoriaCompHot) <= 64) ? 1 : -1];
+
+    // Tuned so the clamped explosion impulse launches a proxy ragdoll at up to 10m/s
+    static const float kfProxyImpulseToVelocity = 0.1f;
+
     /*!
      * This private class provides the infrastructure to map performance parameter types
      * to the methods in the Euphoria component which handle them.
@@ -52,6 +77,13 @@ namespace Ronin
         // TYPEDEFS
         typedef void (*RerouteFunction)(EuphoriaComp* euphoriaComp, const EuphoriaParamsBase* const pParams);
 
+        // Every parameter class has to fit in the hot load state. Using kSize checks it.
+        template<class PARAM> struct ParamsFit
+        {
+            typedef char Check[(sizeof(PARAM) <= EuphoriaCompHotLoadState::kMaxParamsSize) ? 1 : -1];
+            enum { kSize = sizeof(PARAM) };
+        };
+
         // PRIVATE STRUCTS
         /*!
          * This structure provides a mapping between performance type and the specific method
@@ -61,6 +93,7 @@ namespace Ronin
         {
             ePerformanceType type;
             RerouteFunction func;
+            size_t size;
         };
 
         // STATIC MEMBERS
@@ -86,6 +119,23 @@ namespace Ronin
             LECASSERT(pParams->mType == mskReroutePtrs[pParams->mType].type);
             (mskReroutePtrs[pParams->mType].func)(pEuphoriaComp, pParams);
         }
+
+        /*!
+         * Copies the parameters into pDest so the performance can be restarted
+         * after a hot load. The parameter classes are plain data, so a byte copy
+         * is enough.
+         */
+        static void RecordParams(unsigned char* pDest, const EuphoriaParamsBase* const pParams)
+        {
+            LECASSERT(pParams->mType == mskReroutePtrs[pParams->mType].type);
+            memcpy(pDest, pParams, mskReroutePtrs[pParams->mType].size);
+        }
+
+        static size_t ParamsSize(const EuphoriaParamsBase* const pParams)
+        {
+            LECASSERT(pParams->mType == mskReroutePtrs[pParams->mType].type);
+            return mskReroutePtrs[pParams->mType].size;
+        }
     };
 
     /*!
@@ -98,43 +148,63 @@ namespace Ronin
     const RerouteSystem::Reroute RerouteSystem::mskReroutePtrs[eSize] =
     {
         // See above NOTE before adding to this table!
-        { eEPA, &RerouteSystem::StartSpecificPerformance<EPAParams> },
-        { eExplosion, &RerouteSystem::StartSpecificPerformance<ExplosionParams> },
-        { ePunch, &RerouteSystem::StartSpecificPerformance<PunchParams> },
-        { eShove, &RerouteSystem::StartSpecificPerformance<ShoveParams> },
-        { eThrow, &RerouteSystem::StartSpecificPerformance<ThrowParams> },
-        { eHitReact, &RerouteSystem::StartSpecificPerformance<HitReactParams> },
-        { eFalling, &RerouteSystem::StartSpecificPerformance<FallingParams> },
-        { eGunshot, &RerouteSystem::StartSpecificPerformance<GunshotParams> },
-        { eBalance, &RerouteSystem::StartSpecificPerformance<BalanceParams> },
-        { eBlend, &RerouteSystem::StartSpecificPerformance<BlendParams> }
+        { eEPA, &RerouteSystem::StartSpecificPerformance<EPAParams>, RerouteSystem::ParamsFit<EPAParams>::kSize },
+        { eExplosion, &RerouteSystem::StartSpecificPerformance<ExplosionParams>, RerouteSystem::ParamsFit<ExplosionParams>::kSize },
+        { ePunch, &RerouteSystem::StartSpecificPerformance<PunchParams>, RerouteSystem::ParamsFit<PunchParams>::kSize },
+        { eShove, &RerouteSystem::StartSpecificPerformance<ShoveParams>, RerouteSystem::ParamsFit<ShoveParams>::kSize },
+        { eThrow, &RerouteSystem::StartSpecificPerformance<ThrowParams>, RerouteSystem::ParamsFit<ThrowParams>::kSize },
+        { eHitReact, &RerouteSystem::StartSpecificPerformance<HitReactParams>, RerouteSystem::ParamsFit<HitReactParams>::kSize },
+        { eFalling, &RerouteSystem::StartSpecificPerformance<FallingParams>, RerouteSystem::ParamsFit<FallingParams>::kSize },
+        { eGunshot, &RerouteSystem::StartSpecificPerformance<GunshotParams>, RerouteSystem::ParamsFit<GunshotParams>::kSize },
+        { eBalance, &RerouteSystem::StartSpecificPerformance<BalanceParams>, RerouteSystem::ParamsFit<BalanceParams>::kSize },
+        { eBlend, &RerouteSystem::StartSpecificPerformance<BlendParams>, RerouteSystem::ParamsFit<BlendParams>::kSize }
     };
 
 
     /*!
      * Constructor
      */
-    EuphoriaComp::EuphoriaComp(RenID renID):   
+    EuphoriaComp::EuphoriaComp(RenID renID, EuphoriaCompHot* pHot):   
     mRenID(renID),
         mAttackerRenID(RENID_NULL),
         mpAnimationComp(NULL),
         mpPhysicsComp(NULL),
         mpScriptComp(NULL),
-        mpCurrentPerformance(NULL),
+        mpHot(pHot),
+        mpResumeState(NULL),
+        mbAwaitingPreempt(false),
         mkConstraintBreakThreshold(100.0f),
-        mGrabDelayTimer(0.0f),
-        mkGrabDelayThreshold(0.25),
-        mbIsRecoveryEnabled(true),
-        mbIsTransitioning(false),
-        mbTruncateMovementEnable(true)
+        mkGrabDelayThreshold(0.25)
     {
         mPlugInInterface.Set(this);
 
+        LECASSERT(mpHot);
+        mpHot->mpComp = this;
+        mpHot->mpCurrentPerformance = NULL;
+        mpHot->mRenID = renID;
+        mpHot->mfStationaryWaitTime = 0.0f;
+        mpHot->mfStationaryElapsedTime = 0.0f;
+        mpHot->mfStationaryMinSpeed = 0.0f;
+        mpHot->mfTimeInPerformance = 0.0f;
+        mpHot->mGrabDelayTimer = 0.0f;
+        mpHot->mProxyHandle = ProxyRagdoll::kInvalidHandle;
+        mpHot->mbIsRecoveryEnabled = true;
+        mpHot->mbIsTransitioning = false;
+        mpHot->mbTruncateMovementEnable = true;
+        mpHot->mbSettingsPending = false;
+        mpHot->mbStartPending = false;
+        mpHot->mbAgentGranted = false;
+        mpHot->mbIsPassive = false;
+        mpHot->mbMayBeDriving = false;
+
         mpHandConstraint[eLeftArm] = NULL;
         mpHandConstraint[eRightArm] = NULL;
 
-        mbIsGrabbingWith[eLeftArm] = false;
-        mbIsGrabbingWith[eRightArm] = false;
+        mpHot->mbIsGrabbingWith[eLeftArm] = false;
+        mpHot->mbIsGrabbingWith[eRightArm] = false;
+
+        memset(mCurrentParams, 0, sizeof(mCurrentParams));
+        memset(mPendingParams, 0, sizeof(mPendingParams));
     }
 
     /*!
@@ -171,6 +241,52 @@ namespace Ronin
             return;
         }
 
+        // Prefer the prebuilt bundle, read in place
+        const ArchetypeSettingsRecord* pRecord = gpEuphoriaManager->GetSettingsBundle().Find(static_cast<uint32>(key));
+        if (pRecord != NULL)
+        {
+            EuphoriaPerformance* const pPerformances[eSize] = {    // In ePerformanceType order
+                mpPerfEPA, mpPerfExplosion, mpPerfPunch, mpPerfShove, mpPerfThrow,
+                mpPerfHitReact, mpPerfFalling, mpPerfGunshot, mpPerfBalance, mpPerfBlend
+            };
+            for (int i = 0; i < eSize; ++i)
+            {
+                // Gunshot and Balance keep their defaults, as LoadPendingSettings leaves them
+                if (i == eGunshot || i == eBalance)
+                {
+                    continue;
+                }
+
+                const PerformanceSettingsRecord& rSettings = pRecord->mPerformances[i];
+                pPerformances[i]->SetStationarySettings(rSettings.mStationarySpeedThreshold, rSettings.mStationaryWaitTime);
+            }
+            return;
+        }
+
+        // Leave the asset load for later so spawning never waits on it. The load
+        // itself still blocks: the manager runs one per frame, and StartPerformance
+        // runs it on the spot if a performance is needed first.
+        mpHot->mbSettingsPending = true;
+    }
+
+    /*!
+     * Loads the settings asset deferred by CreatePerformances and initializes
+     * the performances from it. Until this runs, the performances use their
+     * built-in defaults.
+     *
+     * @note This is a blocking LoadAssetKey. AssetCatalog has no streaming
+     *       request or completion callback here, so deferring only moves the
+     *       wait out of spawn and spreads it over frames.
+     */
+    void EuphoriaComp::LoadPendingSettings()
+    {
+        LECASSERT(mpHot->mbSettingsPending);
+        mpHot->mbSettingsPending = false;
+
+        FortuneGameRenPlugInInterface* ri = gpEuphoriaManager->GetFortuneGamePlugIn()->GetRenInterface();
+        const AssetKey key = ri->RenAttribGetAsset(mRenID, ATTRIB_FORTUNE_EUPHORIA_SETTINGS);
+        LECASSERT(key != ASSETKEY_NONE);
+
         // Check for settings
         AssetHandle ah = AssetCatalog::LoadAssetKey(key, ASSET_TYPE_FORTUNE_PERFORMANCE_SETTINGS);
         if (ah == ASSETHANDLE_NONE)
@@ -237,7 +353,7 @@ namespace Ronin
     void EuphoriaComp::Destroy()
     {
         // End behavior control as early as possible to avoid dangling ptr problems
-        if (mpCurrentPerformance != NULL)
+        if (mpHot->mpCurrentPerformance != NULL || IsProxyRagdoll() || mpHot->mbIsPassive)
         {
             StopPerformance();
         }
@@ -245,6 +361,125 @@ namespace Ronin
         DestroyPerformances();
     }
 
+    /*!
+     * Captures everything needed to carry this component across a plugin swap.
+     * The agent, physics entities and constraints all belong to the engine and
+     * are left running.
+     */
+    void EuphoriaComp::SaveHotLoadState(EuphoriaCompHotLoadState& rState) const
+    {
+        rState.mbHasPerformance = (mpHot->mpCurrentPerformance != NULL);
+        memcpy(rState.mParams, mCurrentParams, sizeof(rState.mParams));
+        if (rState.mbHasPerformance)
+        {
+            mpHot->mpCurrentPerformance->SaveResumeState(rState.mPerformance);
+        }
+
+        rState.mRenID = mRenID;
+        rState.mAttackerRenID = mAttackerRenID;
+
+        rState.mfStationaryWaitTime = mpHot->mfStationaryWaitTime;
+        rState.mfStationaryElapsedTime = mpHot->mfStationaryElapsedTime;
+        rState.mfStationaryMinSpeed = mpHot->mfStationaryMinSpeed;
+
+        Vec3Set(rState.mvGrabbedEdgeStart, mGrabbedEdge.mvStart);
+        Vec3Set(rState.mvGrabbedEdgeEnd, mGrabbedEdge.mvEnd);
+        rState.mGrabbedEdgeHandle = mGrabbedEdge.mHandle;
+        rState.mpGrabbedEdgeOwnerRPE = mGrabbedEdge.mpOwnerRPE;
+        for (int i = 0; i < eNumArms; ++i)
+        {
+            rState.mbIsGrabbingWith[i] = mpHot->mbIsGrabbingWith[i];
+            rState.mpHandConstraint[i] = mpHandConstraint[i];
+        }
+        rState.mGrabDelayTimer = mpHot->mGrabDelayTimer;
+
+        rState.mbHasProxyBody = IsProxyRagdoll();
+        rState.mbIsPassive = mpHot->mbIsPassive;
+        if (rState.mbHasProxyBody)
+        {
+            gpEuphoriaManager->GetProxyRagdoll().SaveBody(mpHot->mProxyHandle, rState.mProxyBody);
+        }
+
+        rState.mbIsRecoveryEnabled = mpHot->mbIsRecoveryEnabled;
+        rState.mbIsTransitioning = mpHot->mbIsTransitioning;
+        rState.mbTruncateMovementEnable = mpHot->mbTruncateMovementEnable;
+    }
+
+    /*!
+     * Restores a component that was carried across a plugin swap. InitCrossComp
+     * must already have been called so the interfaces and settings are fresh.
+     *
+     * The running performance is recreated from its saved parameters on the agent
+     * that is still driving the character, and resumes in the state it was in with
+     * that state's timers. Nothing the state did on entry (impulses, behavior
+     * starts) is repeated. The component timers and flags are then put back as
+     * they were.
+     */
+    void EuphoriaComp::RestoreHotLoadState(const EuphoriaCompHotLoadState& rState)
+    {
+        LECASSERT(rState.mRenID == mRenID);
+
+        mAttackerRenID = rState.mAttackerRenID;
+
+        Vec3Set(mGrabbedEdge.mvStart, rState.mvGrabbedEdgeStart);
+        Vec3Set(mGrabbedEdge.mvEnd, rState.mvGrabbedEdgeEnd);
+        mGrabbedEdge.mHandle = rState.mGrabbedEdgeHandle;
+        mGrabbedEdge.mpOwnerRPE = rState.mpGrabbedEdgeOwnerRPE;
+        for (int i = 0; i < eNumArms; ++i)
+        {
+            mpHot->mbIsGrabbingWith[i] = rState.mbIsGrabbingWith[i];
+            mpHandConstraint[i] = rState.mpHandConstraint[i];
+        }
+
+        if (rState.mbHasPerformance)
+        {
+            if (mpHot->mbSettingsPending)
+            {
+                LoadPendingSettings();
+            }
+
+            const EuphoriaParamsBase* pParams = reinterpret_cast<const EuphoriaParamsBase*>(rState.mParams);
+            RerouteSystem::RecordParams(mCurrentParams, pParams);
+            mpResumeState = &rState.mPerformance;
+            RerouteSystem::CallMappedMethod(this, pParams);
+            mpResumeState = NULL;
+        }
+
+        // A passive or proxy ragdoll carries on in this module's proxy, and the
+        // engine's passive ragdoll was never stopped
+        if (rState.mbHasProxyBody)
+        {
+            mpHot->mProxyHandle = gpEuphoriaManager->GetProxyRagdoll().RestoreBody(rState.mProxyBody);
+            mpHot->mbIsPassive = rState.mbIsPassive && IsProxyRagdoll();
+        }
+        else
+        {
+            mpHot->mbIsPassive = rState.mbIsPassive;
+        }
+
+        // Put back the component side of the performance
+        mpHot->mfStationaryWaitTime = rState.mfStationaryWaitTime;
+        mpHot->mfStationaryElapsedTime = rState.mfStationaryElapsedTime;
+        mpHot->mfStationaryMinSpeed = rState.mfStationaryMinSpeed;
+        mpHot->mGrabDelayTimer = rState.mGrabDelayTimer;
+        mpHot->mbIsRecoveryEnabled = rState.mbIsRecoveryEnabled;
+        mpHot->mbIsTransitioning = rState.mbIsTransitioning;
+        mpHot->mbTruncateMovementEnable = rState.mbTruncateMovementEnable;
+    }
+
+    /*!
+     * Tears down the performances without stopping them. Used on hot unload, where
+     * the agent and constraints must keep running for the replacement module.
+     */
+    void EuphoriaComp::DetachForHotLoad()
+    {
+        mpHot->mpCurrentPerformance = NULL;
+        mpHandConstraint[eLeftArm] = NULL;
+        mpHandConstraint[eRightArm] = NULL;
+
+        DestroyPerformances();
+    }
+
     /*!
      * Acquires and verifies pointers to the following component interfaces:
      * Animation, Physics, Script, Game and Ren (not really a comp)
@@ -291,14 +526,18 @@ namespace Ronin
      */
     void EuphoriaComp::Think(float elapsedTime)
     {
-        if (mpCurrentPerformance != NULL)
+        EUPHORIA_PROFILE_TRACK(mRenID);
+        EUPHORIA_PROFILE_SCOPE(EuphoriaComp, Think);
+
+        if (mpHot->mpCurrentPerformance != NULL)
         {
             CheckForBrokenConstraints();
 
-            mpCurrentPerformance->Think(elapsedTime);
+            mpHot->mpCurrentPerformance->Think(elapsedTime);
 
             // Increment delay timer
-            mGrabDelayTimer += elapsedTime;
+            mpHot->mGrabDelayTimer += elapsedTime;
+            mpHot->mfTimeInPerformance += elapsedTime;
 
 #define EUPHORIA_MILESTONE_HACK
 #ifdef EUPHORIA_MILESTONE_HACK
@@ -326,6 +565,15 @@ namespace Ronin
 #endif
         }
 
+        if (IsProxyRagdoll())
+        {
+            ThinkProxyRagdoll();
+        }
+        else if (IsEnginePassiveRagdoll())
+        {
+            ThinkPassiveRagdoll(elapsedTime);
+        }
+
         if (mpAnimationComp->IsBehaviorActiveAndDriving())
         {
             //! @note The block below is outside the mpCurrentPerformance != NULL block
@@ -335,12 +583,14 @@ namespace Ronin
             //        call because it's possible that Think will EndBehaviorControl which will
             //        cause things to fail when RPEs are NULL as a result. This code should
             //        be relocated once Lua is gone for good.
-            if (!mbIsTransitioning && mbIsRecoveryEnabled)
+            // Bodies kept down by the script never blend, but the dead are still
+            // watched so the release policy can free their agents
+            if (!mpHot->mbIsTransitioning && (mpHot->mbIsRecoveryEnabled || (gpEuphoriaManager->GetAgentPool().IsReleaseEnabled() && mpGameComp->IsDead())))
             {
                 CheckBodyForMovement(elapsedTime);
-                if (IsBodyStationary())
+                if (IsBodyStationary() && !ReleaseIfIrrelevant() && mpHot->mbIsRecoveryEnabled)
                 {
-                    mbIsTransitioning = true;
+                    mpHot->mbIsTransitioning = true;
 #define EUPHORIA_USE_CPP_BLEND_PERFORMANCE
 #ifndef EUPHORIA_USE_CPP_BLEND_PERFORMANCE
                     // Get recover position, and use the Lua version of the blend, for now
@@ -349,7 +599,7 @@ namespace Ronin
                     char params[64];
                     sprintf(params, "name=EuphoriaStationary,position=%d", static_cast<int>(position));
                     gpEuphoriaManager->GetFortuneGamePlugIn()->RoninLua_SendMsg(params, RENID_NULL, mRenID, 0.0f);
-                    mpCurrentPerformance = NULL;
+                    mpHot->mpCurrentPerformance = NULL;
 #else
                     BlendParams rParams;
                     rParams.mAttacker = mAttackerRenID;
@@ -359,11 +609,158 @@ namespace Ronin
                 }
             }
         }
+
+        // Once nothing is left driving the body the manager can skip this component
+        mpHot->mbMayBeDriving = (mpHot->mpCurrentPerformance != NULL) || mpAnimationComp->IsBehaviorActiveAndDriving();
+
+#if EUPHORIA_DEBUG_DRAW_ENABLED
+        DebugDraw();
+#endif
+    }
+
+    /*!
+     * For an idle component, asks the animation component whether something
+     * else has started a behavior on the body since it was last thought.
+     * Returns true if so, and it will be thought until the behavior lets go.
+     */
+    bool EuphoriaComp::CheckMayBeDriving()
+    {
+        if (mpAnimationComp != NULL && mpAnimationComp->IsBehaviorActiveAndDriving())
+        {
+            mpHot->mbMayBeDriving = true;
+        }
+        return mpHot->mbMayBeDriving;
     }
 
+    /*!
+     * Adds this frame's body lines to the debug draw buffer. Probe rays and grab
+     * searches add their own lines as they run.
+     *
+     * @note The getup line is coloured from the spine's orientation alone, as
+     *       DetermineGetupPosition makes queries that would show in profiles and replays
+     */
     void EuphoriaComp::DebugDraw() const
     {
-        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaComp::DebugDraw\n");
+#if EUPHORIA_DEBUG_DRAW_ENABLED
+        const bool bDrawVelocity = EUPHORIA_DEBUG_DRAW_ON(eDrawVelocity);
+        const bool bDrawGetup = EUPHORIA_DEBUG_DRAW_ON(eDrawGetup);
+        const bool bDrawConstraints = EUPHORIA_DEBUG_DRAW_ON(eDrawHandConstraints);
+        if (!(bDrawVelocity || bDrawGetup || bDrawConstraints) || !IsEuphoriaActive())
+        {
+            return;
+        }
+
+        RoninPhysicsEntity* pSpineRPE = mpAnimationComp->GetBodyPartByBone(BoneCRC::eSpine0);
+        Mat44 spineTransform;
+        if (!pSpineRPE->GetTransform(spineTransform))
+        {
+            return;
+        }
+        Vec3 spinePos;
+        Vec3Set(spinePos, ROW_TRANSLATION(spineTransform));
+
+        if (bDrawVelocity)
+        {
+            Vec3 velocity;
+            pSpineRPE->GetLinearVelocity(velocity);
+            Vec3 lineEnd;
+            Vec3AddScaled(lineEnd, spinePos, velocity, 0.25f);
+            EUPHORIA_DEBUG_LINE(eDrawVelocity, spinePos, lineEnd, kDebugColorBlue);
+        }
+
+        if (bDrawGetup)
+        {
+            // Same thresholds as DetermineGetupPosition: upright, front, side or back
+            static const Vec3 kUpIdentityVec = { 0.0f, 1.0f, 0.0f };
+            static const Vec3 kForwardIdentityVec = { 0.0f, 0.0f, 1.0f };
+
+            Vec3 rootUpVec;
+            Mat33MulVec3(rootUpVec, spineTransform, kUpIdentityVec);
+            Vec3 rootForwardVec;
+            Mat33MulVec3(rootForwardVec, spineTransform, kForwardIdentityVec);
+
+            Vec3 postTop;
+            Vec3AddScaled(postTop, spinePos, kUpIdentityVec, 0.5f);
+            const float fForwardDot = Vec3Dot(kUpIdentityVec, rootForwardVec);
+            if (Vec3Dot(rootUpVec, kUpIdentityVec) >= kfGetupCos45)
+            {
+                EUPHORIA_DEBUG_LINE(eDrawGetup, spinePos, postTop, kDebugColorGreen);
+            }
+            else if (fForwardDot <= kfGetupCos125)
+            {
+                EUPHORIA_DEBUG_LINE(eDrawGetup, spinePos, postTop, kDebugColorRed);
+            }
+            else if (fForwardDot <= kfGetupCos55)
+            {
+                EUPHORIA_DEBUG_LINE(eDrawGetup, spinePos, postTop, kDebugColorYellow);
+            }
+            else
+            {
+                EUPHORIA_DEBUG_LINE(eDrawGetup, spinePos, postTop, kDebugColorCyan);
+            }
+        }
+
+        if (bDrawConstraints && (IsHandConstrained(eLeftArm) || IsHandConstrained(eRightArm)))
+        {
+            // The held edge is kept relative to whatever owns it
+            Vec3 edgeStart;
+            Vec3 edgeEnd;
+            Vec3Set(edgeStart, mGrabbedEdge.mvStart);
+            Vec3Set(edgeEnd, mGrabbedEdge.mvEnd);
+            if (mGrabbedEdge.mpOwnerRPE != NULL)
+            {
+                Mat44 ownerTransform;
+                mGrabbedEdge.mpOwnerRPE->GetTransform(ownerTransform);
+                Mat44MulPoint3(edgeStart, ownerTransform, edgeStart);
+                Mat44MulPoint3(edgeEnd, ownerTransform, edgeEnd);
+            }
+            EUPHORIA_DEBUG_LINE(eDrawHandConstraints, edgeStart, edgeEnd, kDebugColorMagenta);
+
+            Vec3 edgeDir;
+            Vec3Sub(edgeDir, edgeEnd, edgeStart);
+            const float fEdgeLengthSq = Vec3MagSqr(edgeDir);
+            for (int arm = 0; arm < eNumArms; ++arm)
+            {
+                if (!IsHandConstrained(static_cast<ReachingArm>(arm)))
+                {
+                    continue;
+                }
+
+                RoninPhysicsEntity* pHand = mpAnimationComp->GetBodyPartByBone((arm == eLeftArm) ? BoneCRC::eLeftMiddle0 : BoneCRC::eRightMiddle0);
+                Vec3 handPos;
+                pHand->GetPosition(handPos);
+
+                // Closest point on the edge
+                float t = 0.0f;
+                if (fEdgeLengthSq > 0.0f)
+                {
+                    Vec3 startToHand;
+                    Vec3Sub(startToHand, handPos, edgeStart);
+                    t = Vec3Dot(startToHand, edgeDir) / fEdgeLengthSq;
+                    t = (t < 0.0f) ? 0.0f : ((t > 1.0f) ? 1.0f : t);
+                }
+                Vec3 heldPos;
+                Vec3AddScaled(heldPos, edgeStart, edgeDir, t);
+                EUPHORIA_DEBUG_LINE(eDrawHandConstraints, handPos, heldPos, kDebugColorMagenta);
+            }
+        }
+#endif
+    }
+
+    /*!
+     * Starts mpCurrentPerformance once its parameters are set. During a hot load
+     * restore the performance resumes in its saved state instead.
+     */
+    void EuphoriaComp::StartCurrentPerformance()
+    {
+        if (mpResumeState != NULL)
+        {
+            mpHot->mpCurrentPerformance->Resume(*mpResumeState);
+        }
+        else
+        {
+            mpHot->mpCurrentPerformance->Start();
+        }
     }
 
     /*!
@@ -374,9 +771,8 @@ namespace Ronin
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Blending back to animation!\n");
 
         mpPerfBlend->SetParams(rParams);
-        mpCurrentPerformance = mpPerfBlend;
-        // @note NO NEED FOR START TO BE VIRTUAL IF CALLED HERE...
-        mpCurrentPerformance->Start();
+        mpHot->mpCurrentPerformance = mpPerfBlend;
+        StartCurrentPerformance();
     }
 
     /*!
@@ -387,9 +783,8 @@ namespace Ronin
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EPA'd!\n");
 
         mpPerfEPA->SetParams(rParams);
-        mpCurrentPerformance = mpPerfEPA;
-        // @note NO NEED FOR START TO BE VIRTUAL IF CALLED HERE...
-        mpCurrentPerformance->Start();
+        mpHot->mpCurrentPerformance = mpPerfEPA;
+        StartCurrentPerformance();
     }
 
     /*!
@@ -416,9 +811,8 @@ namespace Ronin
         gpEuphoriaManager->GetFortuneGamePlugIn()->RoninLua_SendMsg(params, RENID_NULL, mRenID, 0.0f);
 #else
         mpPerfExplosion->SetParams(rParams);
-        mpCurrentPerformance = mpPerfExplosion;
-        // @note NO NEED FOR START TO BE VIRTUAL IF CALLED HERE...
-        mpCurrentPerformance->Start();
+        mpHot->mpCurrentPerformance = mpPerfExplosion;
+        StartCurrentPerformance();
 #endif
     }
 
@@ -447,9 +841,8 @@ namespace Ronin
         gpEuphoriaManager->GetFortuneGamePlugIn()->RoninLua_SendMsg(params, RENID_NULL, mRenID, 0.0f);
 #else
         mpPerfPunch->SetParams(rParams);
-        mpCurrentPerformance = mpPerfPunch;
-        // @note NO NEED FOR START TO BE VIRTUAL IF CALLED HERE...
-        mpCurrentPerformance->Start();
+        mpHot->mpCurrentPerformance = mpPerfPunch;
+        StartCurrentPerformance();
 #endif
     }
 
@@ -478,9 +871,8 @@ namespace Ronin
         gpEuphoriaManager->GetFortuneGamePlugIn()->RoninLua_SendMsg(params, RENID_NULL, mRenID, 0.0f);
 #else
         mpPerfShove->SetParams(rParams);
-        mpCurrentPerformance = mpPerfShove;
-        // @note NO NEED FOR START TO BE VIRTUAL IF CALLED HERE...
-        mpCurrentPerformance->Start();
+        mpHot->mpCurrentPerformance = mpPerfShove;
+        StartCurrentPerformance();
 #endif
     }
 
@@ -502,9 +894,8 @@ namespace Ronin
         gpEuphoriaManager->GetFortuneGamePlugIn()->RoninLua_SendMsg(params, RENID_NULL, mRenID, 0.0f);
 #else
         mpPerfThrow->SetParams(rParams);
-        mpCurrentPerformance = mpPerfThrow;
-        // @note NO NEED FOR START TO BE VIRTUAL IF CALLED HERE...
-        mpCurrentPerformance->Start();
+        mpHot->mpCurrentPerformance = mpPerfThrow;
+        StartCurrentPerformance();
 #endif
     }
 
@@ -526,9 +917,8 @@ namespace Ronin
         gpEuphoriaManager->GetFortuneGamePlugIn()->RoninLua_SendMsg(params, RENID_NULL, mRenID, 0.0f);
 #else
         mpPerfHitReact->SetParams(rParams);
-        mpCurrentPerformance = mpPerfHitReact;
-        // @note NO NEED FOR START TO BE VIRTUAL IF CALLED HERE...
-        mpCurrentPerformance->Start();
+        mpHot->mpCurrentPerformance = mpPerfHitReact;
+        StartCurrentPerformance();
 #endif
 
     }
@@ -541,9 +931,8 @@ namespace Ronin
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Falling!\n");
 
         mpPerfFalling->SetParams(rParams);
-        mpCurrentPerformance = mpPerfFalling;
-        // @note NO NEED FOR START TO BE VIRTUAL IF CALLED HERE...
-        mpCurrentPerformance->Start();
+        mpHot->mpCurrentPerformance = mpPerfFalling;
+        StartCurrentPerformance();
     }
 
     /*!
@@ -554,9 +943,8 @@ namespace Ronin
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Shot!\n");
 
         mpPerfGunshot->SetParams(rParams);
-        mpCurrentPerformance = mpPerfGunshot;
-        // @note NO NEED FOR START TO BE VIRTUAL IF CALLED HERE...
-        mpCurrentPerformance->Start();
+        mpHot->mpCurrentPerformance = mpPerfGunshot;
+        StartCurrentPerformance();
     }
 
     void EuphoriaComp::StartSpecificPerformance(const BalanceParams& rParams)
@@ -564,9 +952,8 @@ namespace Ronin
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Balancing!\n");
 
         mpPerfBalance->SetParams(rParams);
-        mpCurrentPerformance = mpPerfBalance;
-        // @note NO NEED FOR START TO BE VIRTUAL IF CALLED HERE...
-        mpCurrentPerformance->Start();
+        mpHot->mpCurrentPerformance = mpPerfBalance;
+        StartCurrentPerformance();
     }
 
     /*!
@@ -580,6 +967,51 @@ namespace Ronin
      */
     void EuphoriaComp::StartPerformance(const EuphoriaParamsBase& rParams)
     {
+        // A grant from the agent pool is good for this start only, whichever way it goes
+        const bool bAgentGranted = mpHot->mbAgentGranted;
+        const bool bAwaitingPreempt = mbAwaitingPreempt;
+        mpHot->mbAgentGranted = false;
+        mbAwaitingPreempt = false;
+
+#if EUPHORIA_PROFILE_ENABLED
+        ReplayInputScope replayInput;
+        if (replayInput.IsOutermost())
+        {
+            if (!Replay::AcceptInput())
+            {
+                return;
+            }
+            Replay::RecordStartPerformance(static_cast<uint32>(mRenID), &rParams, static_cast<uint32>(RerouteSystem::ParamsSize(&rParams)));
+        }
+#endif
+
+        // Already queued for an agent, the latest params win
+        if (mpHot->mbStartPending)
+        {
+            RerouteSystem::RecordParams(mPendingParams, &rParams);
+            return;
+        }
+
+        // Far from the viewer, knockdowns run on a proxy and need no agent. A
+        // granted start is coming off the proxy or the queue, and must not go
+        // back onto it.
+        if (!bAgentGranted && StartProxyRagdoll(rParams))
+        {
+            return;
+        }
+
+        // With the pool's bind budget on, a start over budget waits in its queue
+        // and the manager calls StartPendingPerformance later
+        if (!bAgentGranted && !mpAnimationComp->IsBehaviorActiveAndDriving())
+        {
+            if (gpEuphoriaManager->GetAgentPool().Request(mRenID, mpAnimationComp->IsAgentAvailable()) == AgentPool::eDeferred)
+            {
+                RerouteSystem::RecordParams(mPendingParams, &rParams);
+                mpHot->mbStartPending = true;
+                return;
+            }
+        }
+
 #define EUPHORIA_MILESTONE_HACK
 #ifdef EUPHORIA_MILESTONE_HACK
         // Reset any state variable supporting the MILESTONE HACK
@@ -587,39 +1019,484 @@ namespace Ronin
 // EUPHORIA_MILESTONE_HACK
 #endif
 
+        // Whether this component already holds an agent has to be asked before
+        // the running performance is stopped
+        const bool bOwnsAgent = IsEuphoriaActive() || mpAnimationComp->IsBehaviorActiveAndDriving();
+
         // Stop any currently executing performance
-        if (mpCurrentPerformance != NULL)
+        if (mpHot->mpCurrentPerformance != NULL)
+        {
+            mpHot->mpCurrentPerformance->Stop();
+            mpHot->mpCurrentPerformance = NULL;
+        }
+
+        // The manager has not got to this component's settings yet, the performance needs them now
+        if (mpHot->mbSettingsPending)
         {
-            mpCurrentPerformance->Stop();
-            mpCurrentPerformance = NULL;
+            LoadPendingSettings();
         }
 
         // Reset the transitioning flag to enable stationary checking, ONLY for non-Blend performances
         if (rParams.mType != eBlend)
         {
-            mbIsTransitioning = false;
+            mpHot->mbIsTransitioning = false;
             ResetStationaryTimer();
         }
 
         // Reset grab timer for performances that can grab
-        mGrabDelayTimer = 0.0f;
+        mpHot->mGrabDelayTimer = 0.0f;
 
         // Make sure the required resources are available. If euphoria is already
-        // running then no agent is needed (since we already have one.)
-        if (IsEuphoriaActive() || mpAnimationComp->IsAgentAvailable())
+        // running then no agent is needed (since we already have one.) If none
+        // are left, the arbiter may take one from a less important performance.
+        bool bHasAgent = bOwnsAgent || mpAnimationComp->IsAgentAvailable();
+        if (!bHasAgent && !bAwaitingPreempt)
+        {
+            const AgentArbiter& rArbiter = gpEuphoriaManager->GetAgentArbiter();
+            const float requestScore = rArbiter.Score(rParams.mType, mpRenInterface->RenGetPosition(mRenID), 0.0f);
+            if (gpEuphoriaManager->PreemptAgentFor(mRenID, requestScore))
+            {
+                bHasAgent = mpAnimationComp->IsAgentAvailable();
+
+                // The victim's EndBehaviorControl only queues its agent's release,
+                // and the engine may not hand it back until its next update. The
+                // start waits in the pool's queue and is retried next frame.
+                if (!bHasAgent && gpEuphoriaManager->GetAgentPool().Defer(mRenID))
+                {
+                    LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Preempted agent not back yet, start retried next frame\n");
+                    RerouteSystem::RecordParams(mPendingParams, &rParams);
+                    mpHot->mbStartPending = true;
+                    mbAwaitingPreempt = true;
+                    return;
+                }
+            }
+        }
+
+        if (bHasAgent)
         {
             // Set attacker
             mAttackerRenID = rParams.mAttacker;
+            if (IsProxyRagdoll())
+            {
+                StopProxyRagdoll(true);
+            }
+            else if (IsEnginePassiveRagdoll())
+            {
+                StopPassiveRagdoll(true);
+            }
+            mpHot->mbMayBeDriving = true;
+            mpHot->mfTimeInPerformance = 0.0f;
 
             // Start the requested performance
+            RerouteSystem::RecordParams(mCurrentParams, &rParams);
             RerouteSystem::CallMappedMethod(this, &rParams);
         }
-        else
+        else if (!StartPassiveRagdoll(rParams))
         {
             LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "No Agents Available! Performance ABORTED!\n");
         }
     }
 
+    /*!
+     * Called by the manager when the agent pool serves this component's queued start
+     */
+    void EuphoriaComp::StartPendingPerformance()
+    {
+        if (!mpHot->mbStartPending)
+        {
+            // Stopped while it waited
+            return;
+        }
+
+        mpHot->mbStartPending = false;
+        mpHot->mbAgentGranted = true;
+        StartPerformance(*reinterpret_cast<const EuphoriaParamsBase*>(mPendingParams));
+    }
+
+    /*!
+     * Runs Explosion, Shove and Falling on the manager's ProxyRagdoll instead of
+     * an agent when the NPC is far from the viewer. A second hit while on the
+     * proxy adds to its velocity. Returns false if the real performance should run.
+     */
+    bool EuphoriaComp::StartProxyRagdoll(const EuphoriaParamsBase& rParams)
+    {
+        Vec3 vVelocity;
+        const EuphoriaPerformance* pPerformance;
+        switch (rParams.mType)
+        {
+        case eExplosion:
+            ExplosionPerformance::ComputeImpulse(*rParams.Get<ExplosionParams>(), vVelocity);
+            Vec3Mul(vVelocity, vVelocity, kfProxyImpulseToVelocity);
+            pPerformance = mpPerfExplosion;
+            break;
+
+        case eShove:
+            {
+                const ShoveParams* pParams = rParams.Get<ShoveParams>();
+                Vec3Mul(vVelocity, pParams->mForceNormal, pParams->mForceMagnitude * kfProxyImpulseToVelocity);
+                pPerformance = mpPerfShove;
+            }
+            break;
+
+        case eFalling:
+            Vec3Set(vVelocity, 0.0f, 0.0f, 0.0f);
+            pPerformance = mpPerfFalling;
+            break;
+
+        default:
+            return false;
+        }
+
+        ProxyRagdoll& rProxy = gpEuphoriaManager->GetProxyRagdoll();
+        if (IsProxyRagdoll())
+        {
+            mAttackerRenID = rParams.mAttacker;
+            rProxy.AddVelocity(mpHot->mProxyHandle, vVelocity);
+            return true;
+        }
+
+        if (mpAnimationComp->IsBehaviorActiveAndDriving() || mpHot->mbIsPassive || !rProxy.IsDistant(mpRenInterface->RenGetPosition(mRenID)))
+        {
+            return false;
+        }
+
+        // A getup Blend still running gives the body up first
+        if (mpHot->mpCurrentPerformance != NULL)
+        {
+            StopPerformance();
+        }
+
+        if (!StartProxyBody(vVelocity))
+        {
+            return false;
+        }
+
+        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Far from the viewer, proxy ragdoll instead\n");
+        mAttackerRenID = rParams.mAttacker;
+        SetStationaryTimer(pPerformance->GetStationarySpeedThreshold(), pPerformance->GetStationaryWaitTime());
+        return true;
+    }
+
+    /*!
+     * Puts the Ren on the manager's ProxyRagdoll, launched at vVelocity. The
+     * ground under the NPC is found with one ray cast here; the proxy never
+     * queries the world after that. Returns false if the proxy is full.
+     */
+    bool EuphoriaComp::StartProxyBody(const Vec3& vVelocity)
+    {
+        static const float kfMaxDrop = 20.0f;
+
+        const Mat44& renTransform = mpRenInterface->RenGetMatrix(mRenID);
+
+        // Ground below the feet
+        Vec3 rayFrom;
+        Vec3AddScaled(rayFrom, ROW_TRANSLATION(renTransform), kVecUnitY, 1.0f);
+        Vec3 rayTo;
+        Vec3AddScaled(rayTo, rayFrom, kVecUnitY, -kfMaxDrop);
+
+        CollisionManagerPlugInInterface* pCollisionSystem = mpEngineInterface->GetCollisionManagerInterface();
+        RoninPhysics::CastInput ci;
+        uint32 flags = RoninPhysics::kAllPhysical & (~RoninPhysics::kDMMTetExact);
+        SETUP_CASTINPUT(ci, rayFrom, rayTo, NULL, flags, flags, false);
+        pCollisionSystem->AddRenToIgnore(mRenID, ci);
+
+        CollisionSystem::CollisionResult cr;
+        EUPHORIA_COUNT(eCountRayCastClosest);
+        bool bHit = EUPHORIA_REPLAY_RESULT(bool, pCollisionSystem->RayCastClosest(ci, cr));
+        EUPHORIA_REPLAY_DATA(cr.mOutHitDist);
+        EUPHORIA_DEBUG_LINE(eDrawProbeRays, rayFrom, rayTo, bHit ? kDebugColorRed : kDebugColorGreen);
+        const float groundHeight = rayFrom.y - (bHit ? cr.mOutHitDist : kfMaxDrop);
+
+        const int handle = gpEuphoriaManager->GetProxyRagdoll().Start(renTransform, vVelocity, groundHeight);
+        if (handle == ProxyRagdoll::kInvalidHandle)
+        {
+            return false;
+        }
+
+        mpHot->mProxyHandle = handle;
+        mpHot->mbIsTransitioning = false;
+        ResetStationaryTimer();
+        return true;
+    }
+
+    /*!
+     * Poses the Ren from the proxy. Hands over to a Falling performance once an
+     * agent is free, straight away for a passive ragdoll and once the viewer
+     * comes close otherwise. When the proxy has been still for the stationary
+     * wait time the NPC plays its getup chore, or with recovery disabled is
+     * offered to the agent pool's release policy.
+     *
+     * @note The real ragdoll starts from the animated pose at the proxy's Ren
+     *       transform. The proxy's velocity is carried over as an impulse.
+     */
+    void EuphoriaComp::ThinkProxyRagdoll()
+    {
+        ProxyRagdoll& rProxy = gpEuphoriaManager->GetProxyRagdoll();
+
+        Mat44 transform;
+        rProxy.GetRenTransform(mpHot->mProxyHandle, transform);
+        mpRenInterface->RenSetMatrix(mRenID, transform);
+
+        if ((mpHot->mbIsPassive || rProxy.IsNear(ROW_TRANSLATION(transform))) && mpAnimationComp->IsAgentAvailable() && gpEuphoriaManager->GetAgentPool().TryGrant())
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "%s, proxy ragdoll handed to Falling\n", mpHot->mbIsPassive ? "Agent freed up" : "Viewer close");
+            FallingParams params;
+            params.mAttacker = mAttackerRenID;
+            rProxy.GetVelocity(mpHot->mProxyHandle, params.mCarryImpulse);
+            Vec3Mul(params.mCarryImpulse, params.mCarryImpulse, 1.0f / kfProxyImpulseToVelocity);
+
+            StopProxyRagdoll(true);
+            mpHot->mbAgentGranted = true;
+            StartPerformance(params);
+            return;
+        }
+
+        if (!rProxy.IsSettled(mpHot->mProxyHandle, mpHot->mfStationaryWaitTime))
+        {
+            return;
+        }
+
+        const GetupPosition position = rProxy.ClassifyGetup(mpHot->mProxyHandle);
+        StopProxyRagdoll(false);
+
+        if (mpHot->mbIsRecoveryEnabled)
+        {
+            BlendParams params;
+            params.mAttacker = mAttackerRenID;
+            params.mInitialPosition = position;
+            mpPerfBlend->StartGetupChore(params);
+        }
+        else
+        {
+            ReleaseIfIrrelevant();
+        }
+    }
+
+    void EuphoriaComp::StopProxyRagdoll(bool bHandedOff)
+    {
+        gpEuphoriaManager->GetProxyRagdoll().Stop(mpHot->mProxyHandle, bHandedOff);
+        mpHot->mProxyHandle = ProxyRagdoll::kInvalidHandle;
+        mpHot->mbIsPassive = false;
+    }
+
+    /*!
+     * Asks the agent pool's release policy about a body that has just come to
+     * rest. If it lets go, the body is frozen in the static dead pose and any
+     * agent released now, rather than after a getup or death blend. Passive and
+     * proxy ragdolls come here too when they settle with recovery disabled.
+     *
+     * @note The pose is snapped, not blended, so the default policy only
+     *       releases bodies away from the viewer
+     */
+    bool EuphoriaComp::ReleaseIfIrrelevant()
+    {
+        SettledBody body;
+        body.mRenID = mRenID;
+        body.mbIsDead = mpGameComp->IsDead();
+        body.mbIsRecoveryEnabled = mpHot->mbIsRecoveryEnabled;
+        body.mfViewerDistance = gpEuphoriaManager->GetProxyRagdoll().GetViewerDistance(mpRenInterface->RenGetPosition(mRenID));
+        if (!gpEuphoriaManager->GetAgentPool().ShouldRelease(body))
+        {
+            return false;
+        }
+
+        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Settled and irrelevant, frozen in the dead pose\n");
+        StopPerformance();
+
+        AnimAngleParamsInterface* pAngleParams = mpAnimationComp->GetAnimAngleParamsInterface();
+        pAngleParams->SetAngle(0.0f);
+        EUPHORIA_COUNT(eCountStartBlock);
+        mpAnimationComp->StartBlock(EuphoriaNameCRC::eChoreDeath, EuphoriaNameCRC::eBlockStaticDeadPose, pAngleParams->GetAnimParams(), NULL, true);
+        return true;
+    }
+
+    /*!
+     * Fallback for a hit that cannot get an agent. No behaviors run, the hit's
+     * impulse is applied at its impact bone and the body is left to physics (see
+     * StartPassiveBody). ThinkProxyRagdoll or ThinkPassiveRagdoll upgrades it to
+     * a Falling performance as soon as an agent is free. A second hit adds to
+     * the ragdoll already running.
+     *
+     * Returns false for performances that have no impulse to apply, or if no
+     * ragdoll could be started.
+     */
+    bool EuphoriaComp::StartPassiveRagdoll(const EuphoriaParamsBase& rParams)
+    {
+        Vec3 vImpulse;
+        crc32_t impulseBone;
+        const EuphoriaPerformance* pPerformance;
+        switch (rParams.mType)
+        {
+        case eExplosion:
+            ExplosionPerformance::ComputeImpulse(*rParams.Get<ExplosionParams>(), vImpulse);
+            impulseBone = BoneCRC::eSpine3;
+            pPerformance = mpPerfExplosion;
+            break;
+
+        case ePunch:
+            {
+                const PunchParams* pParams = rParams.Get<PunchParams>();
+                Vec3Mul(vImpulse, pParams->mForceNormal, pParams->mForceMagnitude);
+                impulseBone = pParams->mImpactBone;
+                pPerformance = mpPerfPunch;
+            }
+            break;
+
+        case eShove:
+            {
+                const ShoveParams* pParams = rParams.Get<ShoveParams>();
+                Vec3Mul(vImpulse, pParams->mForceNormal, pParams->mForceMagnitude);
+                impulseBone = pParams->mImpactBone;
+                pPerformance = mpPerfShove;
+            }
+            break;
+
+        default:
+            return false;
+        }
+
+        mAttackerRenID = rParams.mAttacker;
+        if (IsProxyRagdoll())
+        {
+            Vec3 vVelocity;
+            Vec3Mul(vVelocity, vImpulse, kfProxyImpulseToVelocity);
+            gpEuphoriaManager->GetProxyRagdoll().AddVelocity(mpHot->mProxyHandle, vVelocity);
+            return true;
+        }
+
+        if (IsEnginePassiveRagdoll())
+        {
+            gpEuphoriaManager->GetFortuneGamePlugIn()->StartPassiveRagdollEuphoria(impulseBone, vImpulse, mpPhysicsComp, mRenID);
+            return true;
+        }
+
+        // A getup Blend still running gives the body up first
+        if (mpHot->mpCurrentPerformance != NULL)
+        {
+            StopPerformance();
+        }
+
+        if (!StartPassiveBody(impulseBone, vImpulse))
+        {
+            return false;
+        }
+
+        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "No Agents Available! Passive ragdoll instead\n");
+        gpEuphoriaManager->GetAgentPool().CountPassiveFallback();
+
+        // Recover on the same terms as the performance would have
+        SetStationaryTimer(pPerformance->GetStationarySpeedThreshold(), pPerformance->GetStationaryWaitTime());
+        return true;
+    }
+
+    /*!
+     * Lets the body go limp with no agent, pushed by vImpulse at impulseBone.
+     * Far from the viewer it goes onto the manager's ProxyRagdoll. Near the
+     * viewer, or with the proxy full, the game puts it into the engine's passive
+     * ragdoll, which is a full physics body with no behaviors driving it.
+     * Returns false if neither could be started.
+     */
+    bool EuphoriaComp::StartPassiveBody(crc32_t impulseBone, const Vec3& vImpulse)
+    {
+        if (gpEuphoriaManager->GetProxyRagdoll().IsDistant(mpRenInterface->RenGetPosition(mRenID)))
+        {
+            Vec3 vVelocity;
+            Vec3Mul(vVelocity, vImpulse, kfProxyImpulseToVelocity);
+            if (StartProxyBody(vVelocity))
+            {
+                mpHot->mbIsPassive = true;
+                return true;
+            }
+        }
+
+        if (!EUPHORIA_REPLAY_RESULT(bool, gpEuphoriaManager->GetFortuneGamePlugIn()->StartPassiveRagdollEuphoria(impulseBone, vImpulse, mpPhysicsComp, mRenID)))
+        {
+            return false;
+        }
+
+        mpHot->mbIsPassive = true;
+        mpHot->mbIsTransitioning = false;
+        ResetStationaryTimer();
+        return true;
+    }
+
+    /*!
+     * Watches a body in the engine's passive ragdoll as a performance would.
+     * While it is still moving, a free agent turns it into a Falling performance
+     * that takes the body over as it is. Once it is stationary it plays the
+     * getup chore, or with recovery disabled is offered to the agent pool's
+     * release policy and otherwise lies where it is.
+     */
+    void EuphoriaComp::ThinkPassiveRagdoll(float elapsedTime)
+    {
+        CheckBodyForMovement(elapsedTime);
+        if (!IsBodyStationary())
+        {
+            if (mpAnimationComp->IsAgentAvailable() && gpEuphoriaManager->GetAgentPool().TryGrant())
+            {
+                LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Agent freed up, passive ragdoll handed to Falling\n");
+                mpHot->mbAgentGranted = true;
+
+                // StartPerformance hands the ragdoll over once it has the agent
+                FallingParams params;
+                params.mAttacker = mAttackerRenID;
+                StartPerformance(params);
+            }
+            return;
+        }
+
+        if (mpHot->mbIsRecoveryEnabled)
+        {
+            BlendParams params;
+            params.mAttacker = mAttackerRenID;
+            params.mInitialPosition = DetermineGetupPosition();
+            StopPassiveRagdoll(false);
+            mpPerfBlend->StartGetupChore(params);
+        }
+        else if (!ReleaseIfIrrelevant())
+        {
+            // Kept down by the script, ask again after another wait
+            ResetStationaryTimer();
+        }
+    }
+
+    /*!
+     * Takes the body out of the engine's passive ragdoll, either to an agent
+     * that is about to drive it or back to animation
+     */
+    void EuphoriaComp::StopPassiveRagdoll(bool bHandedOff)
+    {
+        LECASSERT(IsEnginePassiveRagdoll());
+        gpEuphoriaManager->GetFortuneGamePlugIn()->StopPassiveRagdollEuphoria(bHandedOff, mpPhysicsComp, mRenID);
+        mpHot->mbIsPassive = false;
+    }
+
+    /*!
+     * Gives this component's agent to a more important request. The body carries
+     * on as a passive ragdoll from where it lies, with no extra push, and gets
+     * up on the stationary timer the performance had set.
+     */
+    void EuphoriaComp::Preempt()
+    {
+        LECASSERT(IsPreemptible());
+        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Agent preempted, passive ragdoll instead\n");
+        StopPerformance();
+
+        Vec3 vNoImpulse;
+        Vec3SetZero(vNoImpulse);
+        StartPassiveBody(BoneCRC::eSpine0, vNoImpulse);
+    }
+
+    /*!
+     * What the running performance is worth to the agent arbiter
+     */
+    float EuphoriaComp::ScoreRunningPerformance() const
+    {
+        LECASSERT(mpHot->mpCurrentPerformance != NULL);
+        const EuphoriaParamsBase* pParams = reinterpret_cast<const EuphoriaParamsBase*>(mCurrentParams);
+        return gpEuphoriaManager->GetAgentArbiter().Score(pParams->mType, mpRenInterface->RenGetPosition(mRenID), mpHot->mfTimeInPerformance);
+    }
+
     /*!
      * EXPOSED METHOD
      *
@@ -627,27 +1504,40 @@ namespace Ronin
      */
     void EuphoriaComp::StopPerformance()
     {
-        if (mpCurrentPerformance != NULL)
+        // A start still waiting for an agent is dropped too, as is a passive
+        // or proxy ragdoll
+        mpHot->mbStartPending = false;
+        mbAwaitingPreempt = false;
+        if (IsProxyRagdoll())
+        {
+            StopProxyRagdoll(false);
+        }
+        else if (IsEnginePassiveRagdoll())
+        {
+            StopPassiveRagdoll(false);
+        }
+
+        if (mpHot->mpCurrentPerformance != NULL)
         {
             // Allow any currently running performance to cleanup
-            mpCurrentPerformance->Stop();
-            mpCurrentPerformance = NULL;
+            mpHot->mpCurrentPerformance->Stop();
+            mpHot->mpCurrentPerformance = NULL;
 
             // Force behaviors to stop running
             mpAnimationComp->EndBehaviorControl();
 
             // Clean up any grabbing
-            if (mbIsGrabbingWith[eLeftArm])
+            if (mpHot->mbIsGrabbingWith[eLeftArm])
             {
                 ReleaseConstraint(eLeftArm);
             }
-            if (mbIsGrabbingWith[eRightArm])
+            if (mpHot->mbIsGrabbingWith[eRightArm])
             {
                 ReleaseConstraint(eRightArm);
             }
 
             // Make sure transitioning is reset
-            mbIsTransitioning = false;
+            mpHot->mbIsTransitioning = false;
         }
     }
 
@@ -659,12 +1549,12 @@ namespace Ronin
      */
     void EuphoriaComp::DisconnectPerformance()
     {
-        if (mpCurrentPerformance != NULL)
+        if (mpHot->mpCurrentPerformance != NULL)
         {
-            mpCurrentPerformance = NULL;
+            mpHot->mpCurrentPerformance = NULL;
 
             // Make sure transitioning is reset
-            mbIsTransitioning = false;
+            mpHot->mbIsTransitioning = false;
         }
     }
 
@@ -673,18 +1563,13 @@ namespace Ronin
      *
      * Determines if we should get up from front, back, left, right or upright
      *
-     * @todo Get rid of the local static constants
      * @note Is the "Not in Euphoria" block necessary?
      * @todo Can this be moved to the BlendPerformance?
      */
     GetupPosition EuphoriaComp::DetermineGetupPosition() const
     {
         // Constants
-        static const float kf45Dot = Cosine(DegToRad(45.0f));
-        static const float kf55Dot = Cosine(DegToRad(55.0f));
-        static const float kf90Dot = Cosine(DegToRad(90.0f));
-        static const float kf125Dot = Cosine(DegToRad(125.0f));
-        static const float kfMinUprightDot = kf45Dot;
+        static const float kfMinUprightDot = kfGetupCos45;
         static const Vec3 kUpIdentityVec = { 0.0f, 1.0f, 0.0f };
         static const Vec3 kForwardIdentityVec = { 0.0f, 0.0f, 1.0f };
 
@@ -694,14 +1579,14 @@ namespace Ronin
         if (!pRPE->GetTransform(spineTransform))
         {
             // Not in Euphoria, don't need to getup
-            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Getup: None\n");
+            EUPHORIA_TRACE0(eTraceGetup, eTraceVerbose, "Getup: None, not in Euphoria\n");
             return eGetupNone;
         }
 
         // Check for death
         if (mpGameComp->IsDead())
         {
-            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Getup: DEAD\n");
+            EUPHORIA_TRACE0(eTraceGetup, eTraceVerbose, "Getup: DEAD\n");
             return eGetupDead;
         }
 
@@ -722,11 +1607,12 @@ namespace Ronin
             // Vertical
             // Determine whether the agent is in the air
             float32 distanceToCheck = 1.2f;
-            bool bSolidBeneath = gpEuphoriaManager->GetFortuneGamePlugIn()->IsSupportedEuphoria(BoneCRC::eSpine0, distanceToCheck, mpPhysicsComp, mRenID);
+            EUPHORIA_COUNT(eCountIsSupported);
+            bool bSolidBeneath = EUPHORIA_REPLAY_RESULT(bool, gpEuphoriaManager->GetFortuneGamePlugIn()->IsSupportedEuphoria(BoneCRC::eSpine0, distanceToCheck, mpPhysicsComp, mRenID));
             if (!bSolidBeneath)
             {
                 // We're floating in the air, how can we get up?
-                LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Getup: None\n");
+                EUPHORIA_TRACE1(eTraceGetup, eTraceVerbose, "Getup: None, nothing within %.2f below\n", distanceToCheck);
                 return eGetupNone;
             }
 
@@ -744,7 +1630,7 @@ namespace Ronin
             if (fYDiff < kfUprightFootDiff)
             {
                 // Our root is upright, but our right foot is above our hips, which we can't handle yet
-                LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Getup: None\n");
+                EUPHORIA_TRACE1(eTraceGetup, eTraceVerbose, "Getup: None, right foot only %.2f below root\n", fYDiff);
                 return eGetupNone;
             }
 
@@ -752,7 +1638,7 @@ namespace Ronin
             if (fYDiff < kfUprightFootDiff)
             {           
                 // Our root is upright, but our left foot is above our hips, which we can't handle yet
-                LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Getup: None\n");
+                EUPHORIA_TRACE1(eTraceGetup, eTraceVerbose, "Getup: None, left foot only %.2f below root\n", fYDiff);
                 return eGetupNone;
             }
 
@@ -780,7 +1666,7 @@ namespace Ronin
             Vec3Normalize(rootForwardXZ, rootForwardXZ);
             float fDot = Vec3Dot(rootToHeadXZ, rootForwardXZ);
             float fMaxXZDistSq = (0.25f * 0.25f);
-            if (fDot > kf45Dot)
+            if (fDot > kfGetupCos45)
             {
                 // The head is leaning forward, so give it some additional room
                 fMaxXZDistSq = (0.4f * 0.4f);
@@ -790,7 +1676,7 @@ namespace Ronin
             if (fSqDiff > fMaxXZDistSq)
             {
                 // TODO: make this a better spine check
-                LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Getup: None\n");
+                EUPHORIA_TRACE2(eTraceGetup, eTraceVerbose, "Getup: None, spine bent %.3f past %.3f (sq)\n", fSqDiff, fMaxXZDistSq);
                 return eGetupNone;
             }
             // We're upright
@@ -801,28 +1687,29 @@ namespace Ronin
             // Horizontal
             // Determine whether the agent is in the air
             float32 distanceToCheck = 0.5f;
-            bool bSolidBeneath = gpEuphoriaManager->GetFortuneGamePlugIn()->IsSupportedEuphoria(BoneCRC::eSpine0, distanceToCheck, mpPhysicsComp, mRenID);
+            EUPHORIA_COUNT(eCountIsSupported);
+            bool bSolidBeneath = EUPHORIA_REPLAY_RESULT(bool, gpEuphoriaManager->GetFortuneGamePlugIn()->IsSupportedEuphoria(BoneCRC::eSpine0, distanceToCheck, mpPhysicsComp, mRenID));
             if (!bSolidBeneath)
             {
                 // We're floating in the air, how can we get up?
-                LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Getup: None\n");
+                EUPHORIA_TRACE1(eTraceGetup, eTraceVerbose, "Getup: None, nothing within %.2f below\n", distanceToCheck);
                 return eGetupNone;
             }
 
             // Test the root forward vector to determine if we're laying on our front, side or back
             fDot = Vec3Dot(kUpIdentityVec, rootForwardVec);
-            if (fDot <= kf125Dot)
+            if (fDot <= kfGetupCos125)
             {
                 // We're on our stomach
                 return eGetupFront;
             }
-            else if (fDot <= kf55Dot)
+            else if (fDot <= kfGetupCos55)
             {
                 // On the side...now determine which side
                 Vec3 tmp;
                 Vec3Cross(tmp, rootUpVec, rootForwardVec);
                 float fSideDot = Vec3Dot(tmp, kUpIdentityVec);
-                if (fSideDot >= kf90Dot)
+                if (fSideDot >= kfGetupCos90)
                 {
                     return eGetupRight;
                 }
@@ -837,7 +1724,7 @@ namespace Ronin
                 return eGetupBack;
             }
         }
-        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Getup: None\n");
+        EUPHORIA_TRACE0(eTraceGetup, eTraceVerbose, "Getup: None\n");
         return eGetupNone;
     }
 
@@ -888,14 +1775,14 @@ namespace Ronin
             LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Constraining Left Hand! (EuphoriaComp::ConstrainLimb)\n");
             Vec3Set(vHandOffset, 0.0f, -0.05f, -0.05f);
             pHand = mpAnimationComp->GetBodyPartByBone(BoneCRC::eLeftMiddle0);     // BoneCRC::eLeftHand0
-            mpAnimationComp->StartOverlay(OverlayParameters::eLeftHand, CRCINIT("LEFT_HAND_HANG"), CRC32_NULL);
+            mpAnimationComp->StartOverlay(OverlayParameters::eLeftHand, EuphoriaNameCRC::eLeftHandHang, CRC32_NULL);
             break;
 
         case eRightArm:
             LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Constraining RIGHT Hand! (EuphoriaComp::ConstrainLimb)\n");
             Vec3Set(vHandOffset, 0.0f, 0.05f, 0.05f);
             pHand = mpAnimationComp->GetBodyPartByBone(BoneCRC::eRightMiddle0);    // BoneCRC::eRightHand0
-            mpAnimationComp->StartOverlay(OverlayParameters::eRightHand, CRCINIT("RIGHT_HAND_HANG"), CRC32_NULL);
+            mpAnimationComp->StartOverlay(OverlayParameters::eRightHand, EuphoriaNameCRC::eRightHandHang, CRC32_NULL);
             break;
 
         default:
@@ -925,11 +1812,19 @@ namespace Ronin
         Vec3Set_UA(bsInfo.mEntity1Offset, vHandOffset);
         Vec3Set_UA(bsInfo.mEntity2Offset, vFinalEntityOffset);
         bsInfo.mfBreakThreshold = mkConstraintBreakThreshold;
+        EUPHORIA_COUNT(eCountCreateConstraint);
         mpHandConstraint[reachingArm] = mpEngineInterface->CreateBallAndSocketConstraint(bsInfo);
-        mbIsGrabbingWith[reachingArm] = true;
+        mpHot->mbIsGrabbingWith[reachingArm] = true;
+
+        if (EUPHORIA_DEBUG_DRAW_ON(eDrawHandConstraints))
+        {
+            Vec3 handPos;
+            pHand->GetPosition(handPos);
+            EUPHORIA_DEBUG_LINE(eDrawHandConstraints, handPos, vWorldReachForPos, kDebugColorWhite);
+        }
 
         // Reset the grab delay timer to prevent dithering (grab-release-grab-release-etc)
-        mGrabDelayTimer = 0.0f;
+        mpHot->mGrabDelayTimer = 0.0f;
     }
 
     /*!
@@ -942,10 +1837,10 @@ namespace Ronin
             lec_delete mpHandConstraint[reachingArm];
             mpHandConstraint[reachingArm] = NULL;
 
-            mbIsGrabbingWith[reachingArm] = false;
+            mpHot->mbIsGrabbingWith[reachingArm] = false;
 
             // Reset grab delay timer
-            mGrabDelayTimer = 0.0f;
+            mpHot->mGrabDelayTimer = 0.0f;
         }
 
         switch (reachingArm)
@@ -987,7 +1882,9 @@ namespace Ronin
 
             pHand = mpAnimationComp->GetBodyPartByBone(BoneCRC::eLeftHand0);
             pHand->GetPosition(handPosition);
-            distanceToEdge = pEdgeMgr->DistanceToEdge(mGrabbedEdge.mHandle, handPosition, closestPoint);
+            EUPHORIA_COUNT(eCountDistanceToEdge);
+            distanceToEdge = EUPHORIA_REPLAY_RESULT(float, pEdgeMgr->DistanceToEdge(mGrabbedEdge.mHandle, handPosition, closestPoint));
+            EUPHORIA_REPLAY_DATA(closestPoint);
             ConstrainLimb(eLeftArm, mGrabbedEdge.mpOwnerRPE, closestPoint);
             break;
 
@@ -996,7 +1893,9 @@ namespace Ronin
 
             pHand = mpAnimationComp->GetBodyPartByBone(BoneCRC::eRightHand0);
             pHand->GetPosition(handPosition);
-            distanceToEdge = pEdgeMgr->DistanceToEdge(mGrabbedEdge.mHandle, handPosition, closestPoint);
+            EUPHORIA_COUNT(eCountDistanceToEdge);
+            distanceToEdge = EUPHORIA_REPLAY_RESULT(float, pEdgeMgr->DistanceToEdge(mGrabbedEdge.mHandle, handPosition, closestPoint));
+            EUPHORIA_REPLAY_DATA(closestPoint);
             ConstrainLimb(eRightArm, mGrabbedEdge.mpOwnerRPE, closestPoint);
             break;
 
@@ -1018,11 +1917,30 @@ namespace Ronin
         }
     }
 
+#if EUPHORIA_RAGDOLL_SLEEP_QUERY
+    /*!
+     * Returns true when the physics system has deactivated the ragdoll's simulation
+     * island. All of the ragdoll bodies are linked by constraints and therefore
+     * share an island, so testing the root body is enough to know whether the
+     * whole body has gone to sleep.
+     */
+    bool EuphoriaComp::IsRagdollIslandAsleep() const
+    {
+        RoninPhysicsEntity* pRPE = mpAnimationComp->GetBodyPartByBone(BoneCRC::eSpine0);
+        return (pRPE != NULL) && !pRPE->IsActive();
+    }
+// EUPHORIA_RAGDOLL_SLEEP_QUERY
+#endif
+
     /*!
      * If the body is stationary (within a tolerance specified by mfStationaryMinSpeed)
      * then the elapsed time is added to the total time the body has been stationary.
      * If the body is NOT stationary, the time spent stationary is reset to zero.
      *
+     * With EUPHORIA_RAGDOLL_SLEEP_QUERY, a body whose island has been deactivated
+     * by the physics system is stationary by definition, so the velocity poll is
+     * skipped entirely while the ragdoll sleeps.
+     *
      * @note This method (as opposed to the Scum version) assumes that the bones
      *       have RPEs because the character is in Euphoria (or else we would not
      *       be calling this.) Also, we insist that these bones exist in the rig
@@ -1030,6 +1948,16 @@ namespace Ronin
      */
     void EuphoriaComp::CheckBodyForMovement(float elapsedTime)
     {
+#if EUPHORIA_RAGDOLL_SLEEP_QUERY
+        // Sleeping islands cost nothing, just count the time
+        if (IsRagdollIslandAsleep())
+        {
+            mpHot->mfStationaryElapsedTime += elapsedTime;
+            return;
+        }
+// EUPHORIA_RAGDOLL_SLEEP_QUERY
+#endif
+
         // Use a sampling of bones to test whether the body is stationary
         // Sum the velocities of the sample bones...
         Vec3 averageVelocity = { 0.0f, 0.0f, 0.0f };
@@ -1061,13 +1989,13 @@ namespace Ronin
         float32 fSpeed = Vec3Mag(averageVelocity);
 
         // If the speed is slow enough count the elapsed time, otherwise reset the timer
-        if (fSpeed < mfStationaryMinSpeed)
+        if (fSpeed < mpHot->mfStationaryMinSpeed)
         {
-            mfStationaryElapsedTime += elapsedTime;
+            mpHot->mfStationaryElapsedTime += elapsedTime;
         }
         else
         {
-            mfStationaryElapsedTime = 0.0f;
+            mpHot->mfStationaryElapsedTime = 0.0f;
         }
     }
 
@@ -1076,10 +2004,25 @@ namespace Ronin
      */
     void EuphoriaComp::HandleAnimationEvent(crc32_t eventNameCRC)
     {
-        if (mpCurrentPerformance != NULL)
+#if EUPHORIA_PROFILE_ENABLED
+        ReplayInputScope replayInput;
+        if (replayInput.IsOutermost())
+        {
+            if (!Replay::AcceptInput())
+            {
+                return;
+            }
+            Replay::RecordAnimationEvent(static_cast<uint32>(mRenID), eventNameCRC);
+        }
+#endif
+
+        EUPHORIA_PROFILE_TRACK(mRenID);
+        EUPHORIA_PROFILE_SCOPE(EuphoriaComp, OnEvent);
+
+        if (mpHot->mpCurrentPerformance != NULL)
         {
             EuphoriaAnimationEvent rEvent = CreateEuphoriaAnimationEvent(eventNameCRC);
-            mpCurrentPerformance->OnEvent(rEvent);
+            mpHot->mpCurrentPerformance->OnEvent(rEvent);
         }
     }
 
@@ -1088,10 +2031,28 @@ namespace Ronin
      */
     void EuphoriaComp::HandleBehaviorEvent(BehaviorFeedback::BehaviorEventType eventType, ParameterOverrideDataInterface* pData, const RoninPhysics::CollisionData* pCollisionData)
     {
-        if (mpCurrentPerformance)
+#if EUPHORIA_PROFILE_ENABLED
+        ReplayInputScope replayInput;
+        if (replayInput.IsOutermost())
+        {
+            if (!Replay::AcceptInput())
+            {
+                return;
+            }
+            Replay::RecordBehaviorEvent(static_cast<uint32>(mRenID), static_cast<uint32>(eventType));
+        }
+#endif
+
+        EUPHORIA_PROFILE_TRACK(mRenID);
+        EUPHORIA_PROFILE_SCOPE(EuphoriaComp, OnEvent);
+
+        // Events only come from a running behavior, whoever started it
+        mpHot->mbMayBeDriving = true;
+
+        if (mpHot->mpCurrentPerformance)
         {
             EuphoriaBehaviorEvent rEvent = CreateEuphoriaBehaviorEvent(eventType, pData, pCollisionData);
-            mpCurrentPerformance->OnEvent(rEvent);
+            mpHot->mpCurrentPerformance->OnEvent(rEvent);
         }
     }
 
@@ -1105,8 +2066,6 @@ namespace Ronin
      */
     void EuphoriaComp::OrientRen(GetupPosition position)
     {
-        static const crc32_t kBoneRoot = CRCINIT("Spine[0]");
-
         // For back, front and upright, the transforms look OK, so bail
         if (eGetupBack == position || eGetupFront == position || eGetupUpright == position)
         {
@@ -1114,7 +2073,7 @@ namespace Ronin
         }
 
         // Get the root transform
-        RoninPhysicsEntity* pRPE = mpAnimationComp->GetBodyPartByBone(kBoneRoot);
+        RoninPhysicsEntity* pRPE = mpAnimationComp->GetBodyPartByBone(BoneCRC::eSpine0);
         Mat44 rootTransform;
         pRPE->GetTransform(rootTransform);
 
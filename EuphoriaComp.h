@@ -7,6 +7,8 @@
 #include "EuphoriaCompPlugInInterface.h"
 #include "EuphoriaConstants.h"
 #include "EuphoriaEvent.h"
+#include "EuphoriaHotLoad.h"
+#include "EuphoriaProxyRagdoll.h"
 #include "EuphoriaStruct.h"
 #include "RoninSortedComponentList.h"
 
@@ -56,6 +58,50 @@ namespace Ronin
     class ScriptCompPlugInInterface;
     class FortuneGameCompPlugInInterface;
     class FortuneGameRenPlugInInterface;
+    class EuphoriaComp;
+
+    /*!
+     * The part of an EuphoriaComp that is read every frame. The manager keeps
+     * these packed in one table, so its per-frame pass over the components
+     * touches a single cache line for each idle NPC; everything else stays in
+     * the EuphoriaComp behind mpComp.
+     */
+    struct EuphoriaCompHot
+    {
+        EuphoriaComp* mpComp;
+        euphoria::EuphoriaPerformance* mpCurrentPerformance;
+        RenID mRenID;
+
+        // Stationary timers
+        float mfStationaryWaitTime;
+        float mfStationaryElapsedTime;
+        float mfStationaryMinSpeed;
+
+        float mfTimeInPerformance;                  //!< Seconds since mpCurrentPerformance started, for the agent arbiter
+        float mGrabDelayTimer;                      //!< Keeps track of time between grab attempts
+        int mProxyHandle;                           //!< Body in the manager's ProxyRagdoll, or ProxyRagdoll::kInvalidHandle
+
+        bool mbIsGrabbingWith[euphoria::eNumArms];
+
+        // Recovery related
+        bool mbIsRecoveryEnabled;
+        bool mbIsTransitioning;
+
+        // Miscellaneous - Should the character ignore edges which constrain navigation?
+        bool mbTruncateMovementEnable;
+
+        //! Settings asset not loaded yet, performances are running on defaults
+        bool mbSettingsPending;
+
+        // Agent related
+        bool mbStartPending;                        //!< Waiting in the agent pool's queue
+        bool mbAgentGranted;                        //!< The pool has let the next start bind an agent
+        bool mbIsPassive;                           //!< Passive ragdoll, proxy or engine, because no agent was free (see StartPassiveRagdoll)
+        bool mbMayBeDriving;                        //!< Behaviors may still be driving the body since the last performance
+
+        // ACCESSORS
+        inline bool IsIdle() const;
+    };
 
     /*!
      * @todo IMPORTANT!!! Add checks prior to starting performances to MAKE SURE that AGENTS ARE AVAILABLE
@@ -70,6 +116,7 @@ namespace Ronin
         friend class SortedCompPtrList<EuphoriaComp>;
         friend class EuphoriaCompPlugIn;
         friend class RerouteSystem;
+        friend class EuphoriaManager;
 
     private:
         // MEMBERS
@@ -85,13 +132,14 @@ namespace Ronin
         FortuneGameRenPlugInInterface* mpRenInterface;
         GameHooks::FortuneGamePlugInInterface* mpEngineInterface;
 
-        // Stationary timers
-        float mfStationaryWaitTime;
-        float mfStationaryElapsedTime;
-        float mfStationaryMinSpeed;
+        //! Timers, flags and the running performance, kept in the manager's packed table
+        EuphoriaCompHot* mpHot;
 
         // Performance Members
-        euphoria::EuphoriaPerformance* mpCurrentPerformance;
+        unsigned char mCurrentParams[euphoria::EuphoriaCompHotLoadState::kMaxParamsSize];    //!< Copy of the params mpCurrentPerformance was started with
+        unsigned char mPendingParams[euphoria::EuphoriaCompHotLoadState::kMaxParamsSize];    //!< Params of a start waiting in the agent pool's queue
+        const euphoria::PerformanceResumeState* mpResumeState;                  //!< Set while RestoreHotLoadState restarts the saved performance
+        bool mbAwaitingPreempt;                                                 //!< The queued start preempted an agent the engine has not given back yet
         euphoria::ThrowPerformance* mpPerfThrow;
         euphoria::BlendPerformance* mpPerfBlend;
         euphoria::PunchPerformance* mpPerfPunch;
@@ -105,24 +153,24 @@ namespace Ronin
 
         // Constraint related
         euphoria::GrabbedEdgeInfo mGrabbedEdge;                                 //!< Keeps track of what this NPC is grabbing
-        bool mbIsGrabbingWith[euphoria::eNumArms];
         RoninPhysicsConstraint* mpHandConstraint[euphoria::eNumArms];
         const float mkConstraintBreakThreshold;
-        //! Keeps track of time between grab attempts
-        float mGrabDelayTimer;
         const float mkGrabDelayThreshold;
 
-        // Recovery related
-        bool mbIsRecoveryEnabled;
-        bool mbIsTransitioning;
-
-        // Miscellaneous - Should the character ignore edges which constrain navigation?
-        bool mbTruncateMovementEnable;
-
         // METHODS
         void CreatePerformances();
         void DestroyPerformances();
-        void CheckBodyForMovement(float elapsedTime);
+        void StartCurrentPerformance();
+        bool IsRagdollIslandAsleep() const;
+        bool StartPassiveRagdoll(const euphoria::EuphoriaParamsBase& rParams);
+        bool StartPassiveBody(crc32_t impulseBone, const RavenMath::Vec3& vImpulse);
+        void ThinkPassiveRagdoll(float elapsedTime);
+        void StopPassiveRagdoll(bool bHandedOff);
+        bool StartProxyRagdoll(const euphoria::EuphoriaParamsBase& rParams);
+        bool StartProxyBody(const RavenMath::Vec3& vVelocity);
+        void ThinkProxyRagdoll();
+        void StopProxyRagdoll(bool bHandedOff);
+        bool ReleaseIfIrrelevant();
 
         // OVERLOADED METHODS FOR INDIVIDUAL PERFORMANCES
         void StartSpecificPerformance(const euphoria::BlendParams& rParams);
@@ -138,7 +186,7 @@ namespace Ronin
 
     public:
         // CREATORS
-        EuphoriaComp(RenID renID);
+        EuphoriaComp(RenID renID, EuphoriaCompHot* pHot);
         ~EuphoriaComp();
 
         // MANIPULATORS
@@ -146,7 +194,10 @@ namespace Ronin
         void InitCrossComp();
         void InitPostCrossComp();
         void Think(float elapsedTime);
+        bool CheckMayBeDriving();
         void Destroy();
+        void LoadPendingSettings();
+        void CheckBodyForMovement(float elapsedTime);
         // EXPOSED MANIPULATORS
         inline void SetTruncateMovementEnable(bool bEnable);
         inline void DisableRecovery();
@@ -154,9 +205,16 @@ namespace Ronin
         inline void SetStationaryTimer(float speedThreshold, float waitTime);
         inline void ResetStationaryTimer();
         void StartPerformance(const euphoria::EuphoriaParamsBase& rParams);
+        void StartPendingPerformance();
         void StopPerformance();
         void DisconnectPerformance();
+        void Preempt();
         void HandleAnimationEvent(crc32_t eventNameCRC);
+
+        // Hot loading
+        void SaveHotLoadState(euphoria::EuphoriaCompHotLoadState& rState) const;
+        void RestoreHotLoadState(const euphoria::EuphoriaCompHotLoadState& rState);
+        void DetachForHotLoad();
         void HandleBehaviorEvent(BehaviorFeedback::BehaviorEventType eventType, ParameterOverrideDataInterface* pData, const RoninPhysics::CollisionData* pCollisionData);
 
         // Constraint-related
@@ -184,15 +242,38 @@ namespace Ronin
 
         void DebugDraw() const;
 
+        // Debugging and benchmarks
+        inline euphoria::FallingPerformance* GetFallingPerformance() const;
+        inline float GetStationaryElapsedTime() const;
+        inline void SetStationaryElapsedTime(float elapsedTime);
+
         // EXPOSED ACCESSORS
         inline bool IsEuphoriaActive() const;
         inline bool GetTruncateMovementEnable() const;
         inline bool IsBodyStationary() const;
+        inline bool AreSettingsPending() const;
+        inline bool IsStartPending() const;
+        inline bool IsPassiveRagdoll() const;
+        inline bool IsProxyRagdoll() const;
+        inline bool IsEnginePassiveRagdoll() const;
+        inline bool IsPreemptible() const;
+        float ScoreRunningPerformance() const;
         euphoria::GetupPosition DetermineGetupPosition() const;
 
     } END_DECLARE_ALIGNED;
 
     // INLINES
+    /*!
+     * True if Think has nothing to do. Anything with an agent, a passive or
+     * proxy ragdoll, or behaviors that may not have let go yet still thinks.
+     * Behaviors started without going through the component are only seen
+     * once it has a behavior event or CheckMayBeDriving finds them.
+     */
+    bool EuphoriaCompHot::IsIdle() const
+    {
+        return (mpCurrentPerformance == NULL && !mbMayBeDriving && !mbIsPassive && mProxyHandle == euphoria::ProxyRagdoll::kInvalidHandle);
+    }
+
     RenID EuphoriaComp::GetRenID() const
     {
         return mRenID;
@@ -248,41 +329,41 @@ namespace Ronin
      */
     void EuphoriaComp::SetTruncateMovementEnable(bool bEnable)
     {
-        mbTruncateMovementEnable = bEnable;
+        mpHot->mbTruncateMovementEnable = bEnable;
     }
 
     void EuphoriaComp::DisableRecovery()
     {
-        mbIsRecoveryEnabled = false;
+        mpHot->mbIsRecoveryEnabled = false;
     }
 
     void EuphoriaComp::EnableRecovery()
     {
-        mbIsRecoveryEnabled = true;
+        mpHot->mbIsRecoveryEnabled = true;
     }
 
     // EXPOSED METHOD - INLINE
     void EuphoriaComp::SetStationaryTimer(float speedThreshold, float waitTime)
     {
-        mfStationaryWaitTime = waitTime;
-        mfStationaryMinSpeed = speedThreshold;
+        mpHot->mfStationaryWaitTime = waitTime;
+        mpHot->mfStationaryMinSpeed = speedThreshold;
     }
 
     void EuphoriaComp::ResetStationaryTimer()
     {
-        mfStationaryElapsedTime = 0.0f;
+        mpHot->mfStationaryElapsedTime = 0.0f;
     }
 
     // EXPOSED METHOD - INLINE
     bool EuphoriaComp::IsEuphoriaActive() const
     {
-        return (mpCurrentPerformance != NULL);
+        return (mpHot->mpCurrentPerformance != NULL);
     }
 
     // EXPOSED METHOD - INLINE
     bool EuphoriaComp::GetTruncateMovementEnable() const
     {
-        return mbTruncateMovementEnable;
+        return mpHot->mbTruncateMovementEnable;
     }
 
     // EXPOSED METHOD - INLINE
@@ -291,7 +372,44 @@ namespace Ronin
      */
     bool EuphoriaComp::IsBodyStationary() const
     {
-        return (mfStationaryElapsedTime > mfStationaryWaitTime);
+        return (mpHot->mfStationaryElapsedTime > mpHot->mfStationaryWaitTime);
+    }
+
+    /*!
+     * Returns true while the performances are still waiting on their settings asset
+     */
+    bool EuphoriaComp::AreSettingsPending() const
+    {
+        return mpHot->mbSettingsPending;
+    }
+
+    bool EuphoriaComp::IsStartPending() const
+    {
+        return mpHot->mbStartPending;
+    }
+
+    bool EuphoriaComp::IsPassiveRagdoll() const
+    {
+        return mpHot->mbIsPassive;
+    }
+
+    bool EuphoriaComp::IsProxyRagdoll() const
+    {
+        return (mpHot->mProxyHandle != euphoria::ProxyRagdoll::kInvalidHandle);
+    }
+
+    bool EuphoriaComp::IsEnginePassiveRagdoll() const
+    {
+        return (mpHot->mbIsPassive && !IsProxyRagdoll());
+    }
+
+    /*!
+     * A running performance can give up its agent unless it is already blending
+     * back to animation
+     */
+    bool EuphoriaComp::IsPreemptible() const
+    {
+        return (mpHot->mpCurrentPerformance != NULL && !mpHot->mbIsTransitioning);
     }
 
     /*!
@@ -302,7 +420,7 @@ namespace Ronin
      */
     bool EuphoriaComp::IsReadyToGrab() const
     {
-        return (mGrabDelayTimer > mkGrabDelayThreshold);
+        return (mpHot->mGrabDelayTimer > mkGrabDelayThreshold);
     }
 
     /*!
@@ -312,7 +430,25 @@ namespace Ronin
     {
         LECASSERTMSG((reachingArm >= 0 && reachingArm < euphoria::eNumArms), "reachingArm OUT OF RANGE!");
 
-        return mbIsGrabbingWith[reachingArm];
+        return mpHot->mbIsGrabbingWith[reachingArm];
+    }
+
+    euphoria::FallingPerformance* EuphoriaComp::GetFallingPerformance() const
+    {
+        return mpPerfFalling;
+    }
+
+    float EuphoriaComp::GetStationaryElapsedTime() const
+    {
+        return mpHot->mfStationaryElapsedTime;
+    }
+
+    /*!
+     * Puts the stationary timer back to a value read with GetStationaryElapsedTime
+     */
+    void EuphoriaComp::SetStationaryElapsedTime(float elapsedTime)
+    {
+        mpHot->mfStationaryElapsedTime = elapsedTime;
     }
 }
 
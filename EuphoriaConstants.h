@@ -10,13 +10,13 @@ EuphoriaConstants.h
 #include "LECVectorAligned.h"
 #include "Rens/RenTypes.h"
 #include "RoninConfig.h"
+#include "EuphoriaNameCRC.h"
 
 namespace Ronin
 {
     inline crc32_t GetEuphoriaPlugInName()
     {
-        static crc32_t name = stricrc32("FortuneEuphoria");
-        return name;
+        return EuphoriaNameCRC::ePlugInName;
     }
 }
 
@@ -0,0 +1,159 @@
+#include "EuphoriaDebugDraw.h"
+
+#if EUPHORIA_DEBUG_DRAW_ENABLED
+
+#include "EuphoriaManager.h"
+#include "FortuneGamePlugInInterface.h"
+#include "LECLog.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace euphoria
+{
+    // USING DECLARATIONS
+    using lec::LecTraceChannel;
+    using RavenMath::Vec3;
+    using RavenMath::Vec4;
+
+    // Define statics
+    uint32 DebugDraw::msEnabledMask = 0;
+
+    const Vec4 kDebugColorRed = { 1.0f, 0.0f, 0.0f, 1.0f };
+    const Vec4 kDebugColorGreen = { 0.0f, 1.0f, 0.0f, 1.0f };
+    const Vec4 kDebugColorBlue = { 0.0f, 0.0f, 1.0f, 1.0f };
+    const Vec4 kDebugColorYellow = { 1.0f, 1.0f, 0.0f, 1.0f };
+    const Vec4 kDebugColorCyan = { 0.0f, 1.0f, 1.0f, 1.0f };
+    const Vec4 kDebugColorMagenta = { 1.0f, 0.0f, 1.0f, 1.0f };
+    const Vec4 kDebugColorWhite = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+    // LOCAL CONST INITIALIZATION
+    namespace
+    {
+        const char* const kDebugDrawCategoryNames[eNumDebugDrawCategories] =
+        {
+            "rays",
+            "edges",
+            "constraints",
+            "getup",
+            "velocity"
+        };
+
+        DebugLine sDebugLines[DebugDraw::kMaxLines];
+        uint32 sNumDebugLines = 0;
+        uint32 sNumDroppedLines = 0;
+        DebugLineSink spDebugLineSink = NULL;
+    }
+
+    void DebugDraw::SetEnabled(DebugDrawCategory category, bool bEnable)
+    {
+        if (bEnable)
+        {
+            msEnabledMask |= (1u << category);
+        }
+        else
+        {
+            msEnabledMask &= ~(1u << category);
+        }
+    }
+
+    void DebugDraw::SetSink(DebugLineSink sink)
+    {
+        spDebugLineSink = sink;
+    }
+
+    void DebugDraw::AddLine(const Vec3& start, const Vec3& end, const Vec4& color)
+    {
+        if (sNumDebugLines == kMaxLines)
+        {
+            ++sNumDroppedLines;
+            return;
+        }
+
+        DebugLine& rLine = sDebugLines[sNumDebugLines++];
+        Vec3Set(rLine.mStart, start);
+        Vec3Set(rLine.mEnd, end);
+        rLine.mColor = color;
+    }
+
+    /*!
+     * Hands the frame's lines to the sink
+     */
+    void DebugDraw::Submit()
+    {
+        if (msEnabledMask == 0 && sNumDebugLines == 0)
+        {
+            return;
+        }
+
+        if (spDebugLineSink != NULL)
+        {
+            spDebugLineSink(sDebugLines, sNumDebugLines);
+        }
+        else
+        {
+            char text[64];
+            sprintf(text, "Euphoria: %u lines, no sink", sNumDebugLines);
+            Ronin::gpEuphoriaManager->GetFortuneGamePlugIn()->DEBUGDrawQueueText2DTimed(text, 10, 50, kDebugColorWhite, 0);
+        }
+    }
+
+    /*!
+     * Starts a new frame
+     */
+    void DebugDraw::Clear()
+    {
+        if (sNumDroppedLines > 0)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaDraw: %u lines dropped last frame\n", sNumDroppedLines);
+        }
+        sNumDebugLines = 0;
+        sNumDroppedLines = 0;
+    }
+
+    /*!
+     * Returns true if the message was a debug draw message. See the class comment.
+     */
+    bool DebugDraw::HandleMessage(const char* msg)
+    {
+        static const char kPrefix[] = "EuphoriaDraw ";
+        if (strncmp(msg, kPrefix, sizeof(kPrefix) - 1) != 0)
+        {
+            return false;
+        }
+
+        const char* pCommand = msg + sizeof(kPrefix) - 1;
+        char category[32];
+        char state[8];
+        if (sscanf(pCommand, "%31s %7s", category, state) != 2 || (strcmp(state, "on") != 0 && strcmp(state, "off") != 0))
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaDraw: unknown command %s\n", pCommand);
+            return true;
+        }
+
+        const bool bEnable = (strcmp(state, "on") == 0);
+        const bool bAll = (strcmp(category, "all") == 0);
+        bool bFound = bAll;
+        for (int i = 0; i < eNumDebugDrawCategories; ++i)
+        {
+            if (bAll || strcmp(category, kDebugDrawCategoryNames[i]) == 0)
+            {
+                SetEnabled(static_cast<DebugDrawCategory>(i), bEnable);
+                bFound = true;
+            }
+        }
+
+        if (!bFound)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaDraw: no category called %s\n", category);
+        }
+        if (msEnabledMask == 0)
+        {
+            Clear();
+        }
+        return true;
+    }
+}
+
+// EUPHORIA_DEBUG_DRAW_ENABLED
+#endif
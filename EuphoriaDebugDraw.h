@@ -0,0 +1,119 @@
+#ifndef EUPHORIA_DEBUG_DRAW_H
+#define EUPHORIA_DEBUG_DRAW_H
+
+#include "RoninConfig.h"
+
+/*!
+ * Debug geometry for looking at what NPCs are doing. On by default in debug
+ * builds; define EUPHORIA_DEBUG_DRAW_ENABLED to override. When it is off,
+ * EUPHORIA_DEBUG_LINE expands to nothing.
+ */
+#ifndef EUPHORIA_DEBUG_DRAW_ENABLED
+#ifdef _DEBUG
+#define EUPHORIA_DEBUG_DRAW_ENABLED 1
+#else
+#define EUPHORIA_DEBUG_DRAW_ENABLED 0
+#endif
+#endif
+
+#include "RavenMath.h"
+
+namespace euphoria
+{
+    struct DebugLine
+    {
+        RavenMath::Vec3 mStart;
+        RavenMath::Vec3 mEnd;
+        RavenMath::Vec4 mColor;
+    };
+
+    //! Draws a frame's lines in one call. Installed with EuphoriaManager::SetDebugLineSink.
+    typedef void (*DebugLineSink)(const DebugLine* pLines, uint32 numLines);
+}
+
+#if EUPHORIA_DEBUG_DRAW_ENABLED
+
+namespace euphoria
+{
+    /*!
+     * Categories are switched on separately, so a crowd only pays for what is
+     * being looked at
+     */
+    enum DebugDrawCategory
+    {
+        eDrawProbeRays,             //!< Getup line-of-sight checks and falling ground probes
+        eDrawGrabEdges,             //!< Edges found by the grab search, and the hand's reach to them
+        eDrawHandConstraints,       //!< Hand to constraint point at creation, held edges every frame
+        eDrawGetup,                 //!< A post over the spine coloured by getup orientation
+        eDrawVelocity,              //!< Spine velocity, a quarter second's travel
+        eNumDebugDrawCategories
+    };
+
+    /*!
+     * A per-frame buffer of lines. Components add to it while they think and the
+     * manager hands the whole frame to the sink from DebugDrawAll. The buffer is
+     * emptied when the next frame thinks, so a paused game keeps its last frame.
+     * The plugin interface has no way to draw lines, so the game installs the sink
+     * through EuphoriaManager::SetDebugLineSink; without one a count of lines is
+     * queued as text instead.
+     *
+     * Adding a line when its category is off costs a load and a test. Lines past
+     * kMaxLines in a frame are dropped and counted.
+     *
+     * Driven from EuphoriaManager::HandleMessage:
+     *
+     *   EuphoriaDraw <rays|edges|constraints|getup|velocity|all> <on|off>
+     */
+    class DebugDraw
+    {
+    public:
+        enum
+        {
+            kMaxLines = 8192
+        };
+
+        static inline bool IsEnabled(DebugDrawCategory category);
+        static void SetEnabled(DebugDrawCategory category, bool bEnable);
+        static void SetSink(DebugLineSink sink);
+
+        static void AddLine(const RavenMath::Vec3& start, const RavenMath::Vec3& end, const RavenMath::Vec4& color);
+        static void Submit();
+        static void Clear();
+
+        static bool HandleMessage(const char* msg);
+
+    private:
+        // STATIC MEMBERS
+        static uint32 msEnabledMask;
+    };
+
+    // Line colours
+    extern const RavenMath::Vec4 kDebugColorRed;
+    extern const RavenMath::Vec4 kDebugColorGreen;
+    extern const RavenMath::Vec4 kDebugColorBlue;
+    extern const RavenMath::Vec4 kDebugColorYellow;
+    extern const RavenMath::Vec4 kDebugColorCyan;
+    extern const RavenMath::Vec4 kDebugColorMagenta;
+    extern const RavenMath::Vec4 kDebugColorWhite;
+
+    // INLINES
+    bool DebugDraw::IsEnabled(DebugDrawCategory category)
+    {
+        return (msEnabledMask & (1u << category)) != 0;
+    }
+}
+
+#define EUPHORIA_DEBUG_DRAW_ON(Category) euphoria::DebugDraw::IsEnabled(euphoria::Category)
+
+#define EUPHORIA_DEBUG_LINE(Category, Start, End, Color) \
+    do { if (EUPHORIA_DEBUG_DRAW_ON(Category)) { euphoria::DebugDraw::AddLine(Start, End, Color); } } while (0)
+
+#else
+
+#define EUPHORIA_DEBUG_DRAW_ON(Category) false
+#define EUPHORIA_DEBUG_LINE(Category, Start, End, Color) ((void)0)
+
+#endif
+
+// EUPHORIA_DEBUG_DRAW_H
+#endif
@@ -3,6 +3,7 @@ EuphoriaEvent.cpp
 \*********************************************************/
 
 #include "EuphoriaEvent.h"
+#include "EuphoriaNameCRC.h"
 #include "LECLog.h"
 
 namespace euphoria
@@ -12,12 +13,6 @@ namespace euphoria
     using RoninPhysics::CollisionData;
     using namespace lec;
 
-    // LOCAL CONST INITIALIZATION
-    namespace
-    {
-        const crc32_t kEndCRC = CRCINIT("END");
-    }
-
     // FREE FUNCTIONS
     /*!
      * This is a utility function that doesn't need to be a part of any particular
@@ -27,7 +22,7 @@ namespace euphoria
      */
     EuphoriaAnimationEvent CreateEuphoriaAnimationEvent(crc32_t eventNameCRC)
     {
-        if (eventNameCRC == kEndCRC)
+        if (eventNameCRC == EuphoriaNameCRC::eEnd)
         {
             return EuphoriaAnimationEvent(EuphoriaEvent::eAnimationEnd);
         }
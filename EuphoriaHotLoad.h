@@ -0,0 +1,108 @@
+#ifndef EUPHORIA_HOT_LOAD_H
+#define EUPHORIA_HOT_LOAD_H
+
+#include "EuphoriaProxyRagdoll.h"
+#include "EuphoriaStruct.h"
+#include "LECAlign.h"
+#include "Rens/RenTypes.h"
+#include "StateController.h"
+
+// FORWARD DECLARATIONS
+class RoninPhysicsConstraint_Havok;
+typedef RoninPhysicsConstraint_Havok    RoninPhysicsConstraint;
+
+namespace euphoria
+{
+    /*!
+     * Where a running performance's state machine was when the plugin was
+     * swapped out. The replacement resumes it in that state instead of starting
+     * the performance over (see EuphoriaPerformance::Resume).
+     */
+    struct PerformanceResumeState
+    {
+        enum
+        {
+            kMaxDataSize = 48
+        };
+
+        Ronin::StateID mStateID;
+        float mfTimeInState;
+        //! Members the performance's states keep between updates, see SaveResumeData
+        unsigned char mData[kMaxDataSize];
+    };
+
+    /*!
+     * Everything a Euphoria component needs to pick up where it left off after
+     * the plugin has been swapped out from under it. Only plain data lives here:
+     * the old module's code (and vtables) are gone by the time this is read.
+     *
+     * @note Bump EuphoriaHotLoadState::kVersion whenever this or any of the
+     *       parameter classes change layout.
+     */
+    DECLARE_ALIGNED struct EuphoriaCompHotLoadState
+    {
+        LECALIGNEDCLASS(16);
+
+        enum
+        {
+            kMaxParamsSize = 64
+        };
+
+        //! Copy of the parameters the running performance was started with
+        unsigned char mParams[kMaxParamsSize];
+        bool mbHasPerformance;
+        PerformanceResumeState mPerformance;
+
+        Ronin::RenID mRenID;
+        Ronin::RenID mAttackerRenID;
+
+        // Stationary timers
+        float mfStationaryWaitTime;
+        float mfStationaryElapsedTime;
+        float mfStationaryMinSpeed;
+
+        // Grabbing. The constraints are owned by physics and survive the swap.
+        RavenMath::Vec3 mvGrabbedEdgeStart;
+        RavenMath::Vec3 mvGrabbedEdgeEnd;
+        Ronin::EdgeHandle mGrabbedEdgeHandle;
+        RoninPhysicsEntity* mpGrabbedEdgeOwnerRPE;
+        bool mbIsGrabbingWith[eNumArms];
+        RoninPhysicsConstraint* mpHandConstraint[eNumArms];
+        float mGrabDelayTimer;
+
+        // Passive and proxy ragdolls. The proxy goes with the old manager, so
+        // the body is copied out; the engine's passive ragdoll keeps running.
+        bool mbHasProxyBody;
+        bool mbIsPassive;
+        ProxyRagdoll::BodyState mProxyBody;
+
+        // Flags
+        bool mbIsRecoveryEnabled;
+        bool mbIsTransitioning;
+        bool mbTruncateMovementEnable;
+    } END_DECLARE_ALIGNED;
+
+    /*!
+     * Hand-off between the manager being unloaded and the one replacing it.
+     * The header fields up to mpCompStates must never change layout; they are
+     * what lets a newer module decide whether it can read the rest.
+     */
+    struct EuphoriaHotLoadState
+    {
+        enum
+        {
+            kVersion = 4
+        };
+
+        uint32 mVersion;
+        uint32 mCompStateSize;
+        uint32 mNumComps;
+        Ronin::RenID* mpRenIDs;                             //!< Always valid, so components can be recreated even on a version mismatch
+        EuphoriaCompHotLoadState* mpCompStates;
+
+        BlendProfile mBlendProfiles[eNumGetups];            //!< Live blend tuning
+    };
+}
+
+// EUPHORIA_HOT_LOAD_H
+#endif
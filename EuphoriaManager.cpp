@@ -5,28 +5,59 @@ author : VDB
 \*********************************************************/
 
 #include "EuphoriaManager.h"
+#include "EuphoriaBench.h"
 #include "EuphoriaComp.h"
+#include "EuphoriaDebugDraw.h"
+#include "EuphoriaProfiler.h"
+#include "EuphoriaReplay.h"
+#include "EuphoriaScenario.h"
+#include "EuphoriaTimeline.h"
+#include "EuphoriaTrace.h"
 #include "LECAttrib.h"
+#include "Performances/ExplosionPerformance.h"
 // Interfaces
+#include "FortuneGamePlugInInterface.h"
 #include "PhysicsComponentPlugInInterface.h"
 // Schemas
 #include "DefEuphoria.schema.h"
 //#include "DefEuphoriaPerformance.schema.h"
 
 // For verifying the behavior CRCs
-#ifdef _DEBUG
 #include "EuphoriaBehaviorCRC.h"
-#endif
+#include "EuphoriaNameCRC.h"
+#include "EuphoriaCRC.h"
 
 namespace Ronin
 {
     // USING DECLARATIONS
     using lec::LecTraceChannel;
     using namespace RavenMath;
+    using euphoria::BlendProfile;
+    using euphoria::EuphoriaCompHotLoadState;
+    using euphoria::EuphoriaHotLoadState;
+    using euphoria::GetupPosition;
 
     // GLOBALS
     EuphoriaManager* gpEuphoriaManager = NULL;
 
+    EUPHORIA_PROFILE_DEFINE_SCOPE(EuphoriaManager, ThinkAll);
+    EUPHORIA_PROFILE_DEFINE_SCOPE(EuphoriaManager, Explode);
+
+    // Define statics
+    const int EuphoriaManager::msSettingsLoadsPerFrame = 1;
+
+    // Compiled blend tuning, used until something overrides it. In enum order.
+    const BlendProfile EuphoriaManager::msDefaultBlendProfiles[] = {
+        //  Scale   P2Ratio P1Ramp  P1Core  P2Ramp  P2Core  P2Start P2Dur   Fixed   Turn    Ramp Frames StatTime StatSpeed
+        {   1.0f,   0.75f,  20.0f,  30.0f,  1.0f,   5.0f,   0.0f,   5.0f,   false,  false,  4,   10,    0.1f,    2.0f  },   // eGetupNone
+        {   1.0f,   0.80f,  20.0f,  30.0f,  1.0f,   5.0f,   0.0f,   5.0f,   false,  true,   3,   4,     0.3f,    1.0f  },   // eGetupFront - some leg bending perhaps due to anims being offset too much
+        {   1.0f,   0.70f,  20.0f,  30.0f,  1.0f,   5.0f,   0.0f,   5.0f,   false,  false,  3,   4,     0.12f,   5.0f  },   // eGetupBack
+        {   1.0f,   0.80f,  20.0f,  30.0f,  1.0f,   5.0f,   0.0f,   5.0f,   false,  false,  3,   4,     0.12f,   0.45f },   // eGetupLeft
+        {   1.0f,   0.80f,  20.0f,  30.0f,  1.0f,   5.0f,   0.0f,   5.0f,   false,  false,  3,   4,     0.12f,   0.45f },   // eGetupRight
+        {   0.25f,  0.26f,  20.0f,  20.0f,  5.0f,   10.0f,  0.0f,   20.0f,  true,   false,  2,   2,     0.1f,    5.0f  },   // eGetupUpright - AMAC: upright idle anim is too long, hence the scale
+        {   1.0f,   0.75f,  20.0f,  30.0f,  1.0f,   5.0f,   0.0f,   5.0f,   false,  false,  4,   10,    0.1f,    2.0f  }    // eGetupDead
+    };
+
     ManagerInterface** gEuphoriaManagerCreator()
     {
         gpEuphoriaManager = lec_new EuphoriaManager();
@@ -46,58 +77,115 @@ namespace Ronin
      * Sets the plugin interface, verifies Behavior CRCs in Debug.
      */
     EuphoriaManager::EuphoriaManager(void) : 
-        mpFortuneGame(NULL)
+        mpHotLoadState(NULL),
+        mpFortuneGame(NULL),
+        mppHotChunks(NULL),
+        mNumHotChunks(0),
+        mNumHotRecords(0),
+        mIdleCheckPhase(0)
     {
         mPlugInInterface.Set(this);
-
-#ifdef _DEBUG
-        // check Euphoria Behavior CRC values
-        // If any of these assert, check EuphoriaBehaviorCRC.h & BoneCRC.h while you're at it.
-        LECASSERT(EuphoriaBehaviorCRC::eBalanceArms == CRCINIT("BalanceArms_BalancingAct"));
-        LECASSERT(EuphoriaBehaviorCRC::eBlendToAnim == CRCINIT("BlendToAnimation_Shared"));
-        LECASSERT(EuphoriaBehaviorCRC::eBlendToFrame == CRCINIT("BlendToAnimationFrame_Shared"));
-        LECASSERT(EuphoriaBehaviorCRC::eBlockWithArms == CRCINIT("BlockWithArms_BalancingAct"));
-        LECASSERT(EuphoriaBehaviorCRC::eBreak == CRCINIT("Break_PerfThrow"));
-        LECASSERT(EuphoriaBehaviorCRC::eCatchFall == CRCINIT("CatchFall_Shoved"));
-        LECASSERT(EuphoriaBehaviorCRC::eCrunch == CRCINIT("Crunch_PerfThrow"));
-        LECASSERT(EuphoriaBehaviorCRC::eCrunch_HR == CRCINIT("Crunch_PerfHitReact2"));
-        LECASSERT(EuphoriaBehaviorCRC::eFall == CRCINIT("Fall_Punch"));
-        LECASSERT(EuphoriaBehaviorCRC::eFallDown == CRCINIT("FallDown_BalancingAct"));
-        LECASSERT(EuphoriaBehaviorCRC::eFeetFirstFall == CRCINIT("FeetFirstFall_DropZone"));
-        LECASSERT(EuphoriaBehaviorCRC::eFlail == CRCINIT("FlailThroughAir_DropZone"));
-        LECASSERT(EuphoriaBehaviorCRC::eFly == CRCINIT("Fly_PerfThrow"));
-        LECASSERT(EuphoriaBehaviorCRC::eGrab == CRCINIT("GrabLedge_GrabNGo"));
-        LECASSERT(EuphoriaBehaviorCRC::eHang == CRCINIT("Hang_GrabNGo"));
-        LECASSERT(EuphoriaBehaviorCRC::eHeadFirstFall == CRCINIT("HeadFirstFall_DropZone"));
-        LECASSERT(EuphoriaBehaviorCRC::eHeadHit == CRCINIT("HeadHit_Blend_Fortune"));
-        LECASSERT(EuphoriaBehaviorCRC::eImpact == CRCINIT("Impact_PerfThrow"));
-        LECASSERT(EuphoriaBehaviorCRC::eImpact_HR == CRCINIT("Impact_PerfHitReact2"));
-        LECASSERT(EuphoriaBehaviorCRC::eImpactReaction == CRCINIT("ImpactReaction_DropZone"));
-        LECASSERT(EuphoriaBehaviorCRC::eLandingFall == CRCINIT("LandingFallWindmill_BalancingAct"));
-        LECASSERT(EuphoriaBehaviorCRC::ePunch == CRCINIT("Force_Punch"));
-        LECASSERT(EuphoriaBehaviorCRC::eReact == CRCINIT("React_PerfHitReact2"));
-        LECASSERT(EuphoriaBehaviorCRC::eSlide == CRCINIT("Slide_GrabNGo"));
-        LECASSERT(EuphoriaBehaviorCRC::eStagger == CRCINIT("Stagger_Shoved"));
-        LECASSERT(EuphoriaBehaviorCRC::eStaggerBalance == CRCINIT("StaggerBalance6_BalancingAct"));
-        LECASSERT(EuphoriaBehaviorCRC::eStaggerPunch == CRCINIT("Stagger_Punch"));
-        LECASSERT(EuphoriaBehaviorCRC::eSuperBlend == CRCINIT("SuperBlendToAnimation_Shared"));
-        LECASSERT(EuphoriaBehaviorCRC::eTorque == CRCINIT("Torque_PerfThrow"));
-        LECASSERT(EuphoriaBehaviorCRC::eTransfer == CRCINIT("Transfer_PerfThrow"));
-        LECASSERT(EuphoriaBehaviorCRC::eTransfer_HR == CRCINIT("Transfer_PerfHitReact2"));
-        LECASSERT(EuphoriaBehaviorCRC::eUnstick == CRCINIT("Blend_Unstick"));
-#endif
+        ResetBlendProfiles();
+
+        // Check the CRC enums against their strings. These are compile-time checks where the
+        // compiler has constexpr and debug asserts elsewhere; see EuphoriaCRC.h.
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eBalanceArms, "BalanceArms_BalancingAct");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eBlendToAnim, "BlendToAnimation_Shared");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eBlendToFrame, "BlendToAnimationFrame_Shared");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eBlockWithArms, "BlockWithArms_BalancingAct");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eBreak, "Break_PerfThrow");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eCatchFall, "CatchFall_Shoved");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eCrunch, "Crunch_PerfThrow");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eCrunch_HR, "Crunch_PerfHitReact2");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eFall, "Fall_Punch");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eFallDown, "FallDown_BalancingAct");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eFeetFirstFall, "FeetFirstFall_DropZone");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eFlail, "FlailThroughAir_DropZone");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eFly, "Fly_PerfThrow");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eForce, "Force_PerfExplosion");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eGrab, "GrabLedge_GrabNGo");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eHang, "Hang_GrabNGo");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eHeadFirstFall, "HeadFirstFall_DropZone");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eHeadHit, "HeadHit_Blend_Fortune");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eImpact, "Impact_PerfThrow");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eImpact_HR, "Impact_PerfHitReact2");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eImpactReaction, "ImpactReaction_DropZone");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eLandingFall, "LandingFallWindmill_BalancingAct");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::ePunch, "Force_Punch");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eReact, "React_PerfHitReact2");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eSlide, "Slide_GrabNGo");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eStagger, "Stagger_Shoved");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eStaggerBalance, "StaggerBalance6_BalancingAct");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eStaggerPunch, "Stagger_Punch");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eSuperBlend, "SuperBlendToAnimation_Shared");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eTorque, "Torque_PerfThrow");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eTransfer, "Transfer_PerfThrow");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eTransfer_HR, "Transfer_PerfHitReact2");
+        EUPHORIA_VERIFY_CRC(EuphoriaBehaviorCRC::eUnstick, "Blend_Unstick");
+
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::ePlugInName, "FortuneEuphoria");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eEnd, "END");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eRoot, "Root");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eSpine2, "Spine2");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eLeftHandHang, "LEFT_HAND_HANG");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eRightHandHang, "RIGHT_HAND_HANG");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eLeftHandOpen, "LEFT_HAND_OPEN");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eRightHandOpen, "RIGHT_HAND_OPEN");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eChoreParamGetupFront, "CHORE_PARAMETERIZED_GETUP_FROM_FRONT");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eChoreParamGetupBack, "CHORE_PARAMETERIZED_GETUP_FROM_BACK");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eChoreParamGetupLeft, "CHORE_PARAMETERIZED_GETUP_FROM_LEFT");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eChoreParamGetupRight, "CHORE_PARAMETERIZED_GETUP_FROM_RIGHT");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eChoreParamRecoverUpright, "CHORE_PARAMETERIZED_UPRIGHT_RECOVERY");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eChoreGetupFront, "CHORE_GETUP_FROM_FRONT");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eChoreGetupBack, "CHORE_GETUP_FROM_BACK");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eChoreGetupLeft, "CHORE_GETUP_FROM_LEFT");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eChoreGetupRight, "CHORE_GETUP_FROM_RIGHT");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eChoreRecoverUpright, "CHORE_UPRIGHT_RECOVERY");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eChoreDeath, "CHORE_DEATH");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eBlockParamGetupFront, "CBLK_Param_Getup_Front");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eBlockParamGetupBack, "CBLK_Param_Getup_Back");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eBlockParamGetupLeft, "CBLK_Param_Getup_Left");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eBlockParamGetupRight, "CBLK_Param_Getup_Right");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eBlockParamRecoverUpright, "CBLK_Param_Recover_Upright");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eBlockGetupFront, "CBLK_Euph_Getup_Front");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eBlockGetupBack, "CBLK_Euph_Getup_Back");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eBlockGetupLeft, "CBLK_Euph_Getup_Left");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eBlockGetupRight, "CBLK_Euph_Getup_Right");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eBlockRecoverUpright, "CBLK_Euph_Recover_Upright");
+        EUPHORIA_VERIFY_CRC(EuphoriaNameCRC::eBlockStaticDeadPose, "CBLK_StaticDeadPose");
     }
 
     //-------------------------------------------------------------------------
     EuphoriaManager::~EuphoriaManager(void)
     {
 	    DestroyAll();
+        mSettingsBundle.Close();
+
+        for (uint32 i = 0; i < mNumHotChunks; ++i)
+        {
+            lec_delete [] mppHotChunks[i];
+        }
+        lec_delete [] mppHotChunks;
+
+#if EUPHORIA_PROFILE_ENABLED
+        // Finish the files if a capture or recording is still running
+        euphoria::Timeline::Stop();
+        euphoria::Replay::Stop();
+        euphoria::Scenario::Stop();
+#endif
     }
 
     void EuphoriaManager::Initialize(GamePlugInInterface* gameEnginePlugIn)
     {
         mpFortuneGame = reinterpret_cast<GameHooks::FortuneGamePlugInInterface*>(gameEnginePlugIn);
         gameEnginePlugIn->RegisterManager(this, GetEuphoriaPlugInName());
+
+        // Optional; actors fall back to their settings assets without it
+        if (!mSettingsBundle.Open(EUPHORIA_SETTINGS_BUNDLE_PATH))
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "No Euphoria settings bundle, using per-actor settings assets\n");
+        }
+        ResetBlendProfiles();
     }
 
     //-------------------------------------------------------------------------
@@ -112,16 +200,59 @@ namespace Ronin
 	    }
 
 	    mAllEuphoriaComponents.clear();
+        mNumHotRecords = 0;
+        mSpatialHash.Clear();
     }
 
     //-------------------------------------------------------------------------
     EuphoriaComp* EuphoriaManager::CreateComp(RenID id)
     {
-        EuphoriaComp* pEuphoriaComp = lec_new EuphoriaComp(id);
+        if ((mNumHotRecords >> kHotChunkShift) == mNumHotChunks)
+        {
+            AddHotChunk();
+        }
+
+        EuphoriaComp* pEuphoriaComp = lec_new EuphoriaComp(id, &GetHotRecord(mNumHotRecords));
+        ++mNumHotRecords;
 	    mAllEuphoriaComponents.insert(pEuphoriaComp);
         return pEuphoriaComp;
     }
 
+    /*!
+     * Makes room for another kHotChunkSize hot records. Only the chunk table is
+     * copied, the records already handed out stay where they are.
+     */
+    void EuphoriaManager::AddHotChunk()
+    {
+        EuphoriaCompHot** ppHotChunks = lec_new EuphoriaCompHot*[mNumHotChunks + 1];
+        for (uint32 i = 0; i < mNumHotChunks; ++i)
+        {
+            ppHotChunks[i] = mppHotChunks[i];
+        }
+        ppHotChunks[mNumHotChunks] = lec_new EuphoriaCompHot[kHotChunkSize];
+
+        lec_delete [] mppHotChunks;
+        mppHotChunks = ppHotChunks;
+        ++mNumHotChunks;
+    }
+
+    /*!
+     * Where pHot sits in the packed order
+     */
+    uint32 EuphoriaManager::GetHotIndex(const EuphoriaCompHot* pHot) const
+    {
+        for (uint32 i = 0; i < mNumHotChunks; ++i)
+        {
+            if (pHot >= mppHotChunks[i] && pHot < mppHotChunks[i] + kHotChunkSize)
+            {
+                return (i << kHotChunkShift) + static_cast<uint32>(pHot - mppHotChunks[i]);
+            }
+        }
+
+        LECASSERT(false);
+        return mNumHotRecords;
+    }
+
     GameHooks::FortuneGamePlugInInterface* EuphoriaManager::GetFortuneGamePlugIn()
     {
         return mpFortuneGame;
@@ -132,12 +263,105 @@ namespace Ronin
         return reinterpret_cast<ManagerPlugInInterface*>(&mPlugInInterface);
     }
 
+    /*!
+     * Picks up the components left behind by the manager this one replaces. Each
+     * component is recreated, rebound to its cross-component interfaces (which also
+     * reloads its performance settings) and restored in turn. The agents were never
+     * released, so characters in the middle of a performance carry on.
+     *
+     * If the saved state was written by an incompatible version, components are
+     * still recreated but start out idle.
+     */
     void EuphoriaManager::HotLoad(ManagerInterface* mI)
     {
+        if (mI == NULL)
+        {
+            return;
+        }
+
+        EuphoriaManager* pOldManager = static_cast<EuphoriaManager*>(mI);
+        EuphoriaHotLoadState* pState = pOldManager->mpHotLoadState;
+        pOldManager->mpHotLoadState = NULL;
+        if (pState == NULL)
+        {
+            return;
+        }
+
+        const bool bCompatible = (pState->mVersion == EuphoriaHotLoadState::kVersion) &&
+                                 (pState->mCompStateSize == sizeof(EuphoriaCompHotLoadState));
+        if (bCompatible)
+        {
+            for (int i = 0; i < euphoria::eNumGetups; ++i)
+            {
+                mBlendProfiles[i] = pState->mBlendProfiles[i];
+            }
+        }
+        else
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "HotLoad: state version %d does not match %d, components restart idle\n", pState->mVersion, EuphoriaHotLoadState::kVersion);
+        }
+
+        for (uint32 i = 0; i < pState->mNumComps; ++i)
+        {
+            EuphoriaComp* pEuphoriaComp = CreateComp(pState->mpRenIDs[i]);
+            if (pEuphoriaComp == NULL)
+            {
+                continue;
+            }
+            pEuphoriaComp->InitCrossComp();
+            if (bCompatible)
+            {
+                pEuphoriaComp->RestoreHotLoadState(pState->mpCompStates[i]);
+            }
+        }
+
+        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "HotLoad: restored %d components\n", pState->mNumComps);
+
+        lec_delete [] pState->mpCompStates;
+        lec_delete [] pState->mpRenIDs;
+        lec_delete pState;
     }
 
+    /*!
+     * Saves every component before the plugin is swapped out and releases them
+     * without stopping their performances, so the agents keep simulating until
+     * the replacement manager's HotLoad takes over.
+     */
     void EuphoriaManager::HotUnLoad(ManagerInterface* )
     {
+        LECASSERT(mpHotLoadState == NULL);
+
+        const EuphoriaManagerImplMap::iterator itrEnd = mAllEuphoriaComponents.end();
+        uint32 numComps = 0;
+        for (EuphoriaManagerImplMap::iterator itr = mAllEuphoriaComponents.begin(); itr != itrEnd; ++itr)
+        {
+            ++numComps;
+        }
+
+        mpHotLoadState = lec_new EuphoriaHotLoadState;
+        mpHotLoadState->mVersion = EuphoriaHotLoadState::kVersion;
+        mpHotLoadState->mCompStateSize = sizeof(EuphoriaCompHotLoadState);
+        mpHotLoadState->mNumComps = numComps;
+        mpHotLoadState->mpRenIDs = lec_new RenID[numComps];
+        mpHotLoadState->mpCompStates = lec_new EuphoriaCompHotLoadState[numComps];
+        for (int i = 0; i < euphoria::eNumGetups; ++i)
+        {
+            mpHotLoadState->mBlendProfiles[i] = mBlendProfiles[i];
+        }
+
+        uint32 index = 0;
+        for (EuphoriaManagerImplMap::iterator itr = mAllEuphoriaComponents.begin(); itr != itrEnd; ++itr)
+        {
+            EuphoriaComp* pEuphoriaComp = *itr;
+            mpHotLoadState->mpRenIDs[index] = pEuphoriaComp->GetRenID();
+            pEuphoriaComp->SaveHotLoadState(mpHotLoadState->mpCompStates[index]);
+            pEuphoriaComp->DetachForHotLoad();
+            lec_delete pEuphoriaComp;
+            ++index;
+        }
+
+        mAllEuphoriaComponents.clear();
+        mNumHotRecords = 0;
     }
 
     void EuphoriaManager::InitCrossComp(RenID renID)
@@ -193,8 +417,19 @@ namespace Ronin
         {   
             // remove it from the container
             mAllEuphoriaComponents.erase(pEuphoriaComp);
-
             pEuphoriaComp->Destroy();
+
+            // Keep the hot table packed, the last record fills the hole. The
+            // spatial hash keeps its slots in step.
+            EuphoriaCompHot* pHot = pEuphoriaComp->mpHot;
+            mSpatialHash.Remove(renID, GetHotIndex(pHot));
+            --mNumHotRecords;
+            EuphoriaCompHot* pLastHot = &GetHotRecord(mNumHotRecords);
+            if (pHot != pLastHot)
+            {
+                *pHot = *pLastHot;
+                pHot->mpComp->mpHot = pHot;
+            }
 	        lec_delete pEuphoriaComp;
         } 
     }
@@ -203,33 +438,146 @@ namespace Ronin
     ///-------------------------------------------------------------------------
     void EuphoriaManager::ThinkAll(float elapsedTime)
     {
+        EUPHORIA_PROFILE_SCOPE(EuphoriaManager, ThinkAll);
+
+#if EUPHORIA_PROFILE_ENABLED
+        // A replay sends the inputs recorded before this frame and supplies its elapsed time
+        elapsedTime = euphoria::Replay::BeginFrame(elapsedTime);
+        euphoria::ReplayInputScope replayInput;
+#endif
+
         // Only run if not paused
         if (elapsedTime > 0.0f)
         {
-            const EuphoriaManagerImplMap::iterator it_end = mAllEuphoriaComponents.end();
-            EuphoriaManagerImplMap::iterator it_comp = mAllEuphoriaComponents.begin();
-            while (it_comp != it_end)
+            // Settings assets deferred at spawn are loaded here, blocking, one per frame
+            int settingsLoadBudget = msSettingsLoadsPerFrame;
+
+#if EUPHORIA_DEBUG_DRAW_ENABLED
+            euphoria::DebugDraw::Clear();
+#endif
+
+            // Starts that were over last frame's agent budget go first
+            mAgentPool.BeginFrame();
+            RenID pendingRenID;
+            while (mAgentPool.PopPending(pendingRenID))
+            {
+                EuphoriaComp* pPendingComp = GetEuphoriaComp(pendingRenID);
+                if (pPendingComp != NULL)
+                {
+                    pPendingComp->StartPendingPerformance();
+                }
+            }
+
+            // Distant NPCs on proxies are stepped together, before their components pose from them
+            mProxyRagdoll.Step(elapsedTime);
+
+#if EUPHORIA_PROFILE_ENABLED
+            if (euphoria::Scenario::IsRunning())
+            {
+                euphoria::Scenario::BeginFrame();
+            }
+#endif
+
+            uint32 numHoldingAgents = 0;
+            FortuneGameRenPlugInInterface* pRenInterface = mpFortuneGame->GetRenInterface();
+            // Idle components are skipped off their hot record, without touching the rest of them.
+            // Behaviors can be started without going through the component, so a
+            // rolling share of the idle ones ask the animation component each frame.
+            ++mIdleCheckPhase;
+            for (uint32 i = 0; i < mNumHotRecords; ++i)
+            {
+                const EuphoriaCompHot& rHot = GetHotRecord(i);
+                LECASSERT(rHot.mpComp);
+                if (settingsLoadBudget > 0 && rHot.mbSettingsPending)
+                {
+                    rHot.mpComp->LoadPendingSettings();
+                    --settingsLoadBudget;
+                }
+                const bool bThought = !rHot.IsIdle() || (((i + mIdleCheckPhase) & (kIdleCheckFrames - 1)) == 0 && rHot.mpComp->CheckMayBeDriving());
+                if (bThought)
+                {
+                    rHot.mpComp->Think(elapsedTime);
+                }
+                if (rHot.mpCurrentPerformance != NULL)
+                {
+                    ++numHoldingAgents;
+                }
+
+                // Where it ended up this frame. Idle ones are only re-read every few frames.
+                if (bThought || mSpatialHash.IsDue(i, rHot.mRenID))
+                {
+                    Vec3 position;
+                    Vec3Set_UA(position, pRenInterface->RenGetPosition(rHot.mRenID));
+                    mSpatialHash.Update(i, rHot.mRenID, position);
+                }
+            }
+            mSpatialHash.Build(mNumHotRecords);
+            mAgentPool.EndFrame(numHoldingAgents);
+            mAgentArbiter.EndFrame(numHoldingAgents);
+
+#if EUPHORIA_PROFILE_ENABLED
+            euphoria::Profiler::EndFrame();
+            if (euphoria::Scenario::IsRunning())
+            {
+                euphoria::Scenario::EndFrame();
+            }
+#endif
+#if EUPHORIA_TRACE_LEVEL > 0
+            euphoria::Trace::EndFrame();
+#endif
+        }
+    }
+
+    /*!
+     * Called by a component that needs an agent when none are free. Preempts the
+     * lowest scoring running performance if the request beats it by the
+     * arbiter's margin. Returns true if an agent was freed.
+     */
+    bool EuphoriaManager::PreemptAgentFor(RenID requester, float requestScore)
+    {
+        uint32 numHeld = 0;
+        EuphoriaComp* pVictim = NULL;
+        float victimScore = 0.0f;
+        for (uint32 i = 0; i < mNumHotRecords; ++i)
+        {
+            const EuphoriaCompHot& rHot = GetHotRecord(i);
+            if (rHot.mpCurrentPerformance != NULL)
+            {
+                ++numHeld;
+            }
+            if (!mAgentArbiter.IsEnabled() || rHot.mRenID == requester || !rHot.mpComp->IsPreemptible())
             {
-                EuphoriaComp *pEuphoriaComp = *it_comp;
-                LECASSERT(pEuphoriaComp);
-                pEuphoriaComp->Think(elapsedTime);
-                ++it_comp;
+                continue;
             }
+
+            const float score = rHot.mpComp->ScoreRunningPerformance();
+            if (pVictim == NULL || score < victimScore)
+            {
+                pVictim = rHot.mpComp;
+                victimScore = score;
+            }
+        }
+        mAgentArbiter.CountContested(numHeld);
+
+        if (pVictim == NULL || victimScore * euphoria::AgentArbiter::kPreemptMargin >= requestScore)
+        {
+            mAgentArbiter.CountStarved();
+            return false;
         }
+
+        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaArbiter: request worth %.3f preempts one worth %.3f\n", requestScore, victimScore);
+        pVictim->Preempt();
+        mAgentArbiter.CountPreempted();
+        return true;
     }
 
     //-------------------------------------------------------------------------
     void EuphoriaManager::DebugDrawAll()
     { 
-        const EuphoriaManagerImplMap::iterator it_end = mAllEuphoriaComponents.end();
-        EuphoriaManagerImplMap::iterator it_comp = mAllEuphoriaComponents.begin();
-        while (it_comp != it_end)
-        {
-            EuphoriaComp *pEuphoriaComp = *it_comp;
-            LECASSERT(pEuphoriaComp);
-            pEuphoriaComp->DebugDraw();
-            ++it_comp;
-        }
+        // Components fill the buffer as they think, so the frame goes out in one batch
+#if EUPHORIA_DEBUG_DRAW_ENABLED
+        euphoria::DebugDraw::Submit();
+#endif
     }
 
     void EuphoriaManager::WorldLoad(::AssetKey keyWorld, const DefWorld *pWorldDef)
@@ -266,9 +614,331 @@ namespace Ronin
         return NULL;
     }
 
+    /*!
+     * Replaces the tuning for a single getup position. The table is edited in
+     * place; blends already under way keep the values they started with.
+     */
+    void EuphoriaManager::SetBlendProfile(GetupPosition position, const BlendProfile& profile)
+    {
+        LECASSERTMSG((position >= 0 && position < euphoria::eNumGetups), "position OUT OF RANGE!");
+
+        mBlendProfiles[position] = profile;
+    }
+
+    /*!
+     * Restores the blend tuning for all positions from the settings bundle, or
+     * the compiled defaults if the bundle has none.
+     */
+    void EuphoriaManager::ResetBlendProfiles()
+    {
+        const BlendProfile* pProfiles = mSettingsBundle.GetBlendProfiles();
+        if (pProfiles == NULL)
+        {
+            pProfiles = msDefaultBlendProfiles;
+        }
+        for (int i = 0; i < euphoria::eNumGetups; ++i)
+        {
+            mBlendProfiles[i] = pProfiles[i];
+        }
+    }
+
+    /*!
+     * Handles tuning messages for the blend profiles:
+     *
+     *   BlendProfile <position> <field> <value>    e.g. "BlendProfile 2 mPhaseTwoRatio 0.6"
+     *   BlendProfileReset
+     *
+     * Returns true if the message was a blend profile message.
+     */
+    bool EuphoriaManager::HandleBlendProfileMessage(const char* msg)
+    {
+        struct FieldDesc
+        {
+            const char* mpName;
+            float BlendProfile::* mpFloat;
+            int BlendProfile::* mpInt;
+            bool BlendProfile::* mpBool;
+        };
+        static const FieldDesc kFields[] = {
+            { "mBlendTimeScale",            &BlendProfile::mBlendTimeScale,             NULL,                                   NULL },
+            { "mPhaseTwoRatio",             &BlendProfile::mPhaseTwoRatio,              NULL,                                   NULL },
+            { "mPhaseOneEffectorRamp",      &BlendProfile::mPhaseOneEffectorRamp,       NULL,                                   NULL },
+            { "mPhaseOneCoreBlend",         &BlendProfile::mPhaseOneCoreBlend,          NULL,                                   NULL },
+            { "mPhaseTwoEffectorRamp",      &BlendProfile::mPhaseTwoEffectorRamp,       NULL,                                   NULL },
+            { "mPhaseTwoCoreBlend",         &BlendProfile::mPhaseTwoCoreBlend,          NULL,                                   NULL },
+            { "mPhaseTwoBodyBlendStart",    &BlendProfile::mPhaseTwoBodyBlendStart,     NULL,                                   NULL },
+            { "mPhaseTwoBodyBlendDuration", &BlendProfile::mPhaseTwoBodyBlendDuration,  NULL,                                   NULL },
+            { "mbPhaseTwoFixedFrames",      NULL,                                       NULL,                                   &BlendProfile::mbPhaseTwoFixedFrames },
+            { "mbUseTurnCorrection",        NULL,                                       NULL,                                   &BlendProfile::mbUseTurnCorrection },
+            { "mBlendToRampDuration",       NULL,                                       &BlendProfile::mBlendToRampDuration,    NULL },
+            { "mBlendToFrames",             NULL,                                       &BlendProfile::mBlendToFrames,          NULL },
+            { "mStationaryWaitTime",        &BlendProfile::mStationaryWaitTime,         NULL,                                   NULL },
+            { "mStationarySpeedThreshold",  &BlendProfile::mStationarySpeedThreshold,   NULL,                                   NULL }
+        };
+        static const int kNumFields = sizeof(kFields) / sizeof(kFields[0]);
+
+        if (strcmp(msg, "BlendProfileReset") == 0)
+        {
+            ResetBlendProfiles();
+            return true;
+        }
+
+        int position = 0;
+        char field[64];
+        float value = 0.0f;
+        if (sscanf(msg, "BlendProfile %d %63s %f", &position, field, &value) != 3)
+        {
+            return false;
+        }
+
+        if (position < 0 || position >= euphoria::eNumGetups)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "BlendProfile: bad position %d\n", position);
+            return true;
+        }
+
+        BlendProfile& rProfile = mBlendProfiles[position];
+        for (int i = 0; i < kNumFields; ++i)
+        {
+            if (strcmp(field, kFields[i].mpName) == 0)
+            {
+                if (kFields[i].mpFloat != NULL)
+                {
+                    rProfile.*(kFields[i].mpFloat) = value;
+                }
+                else if (kFields[i].mpInt != NULL)
+                {
+                    rProfile.*(kFields[i].mpInt) = static_cast<int>(value);
+                }
+                else
+                {
+                    rProfile.*(kFields[i].mpBool) = (value != 0.0f);
+                }
+                return true;
+            }
+        }
+
+        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "BlendProfile: unknown field %s\n", field);
+        return true;
+    }
+
+    // EXPOSED MANANGER FUNCTION
+    /*!
+     * Where the game is being seen from, for choosing which NPCs run on proxies
+     */
+    void EuphoriaManager::SetViewerPosition(const RavenMath::Vec3& position)
+    {
+        mProxyRagdoll.SetViewerPosition(position);
+        mAgentArbiter.SetViewerPosition(position);
+    }
+
+    // EXPOSED MANANGER FUNCTION
+    /*!
+     * Which way the viewer is looking, for the agent arbiter's on-screen test
+     */
+    void EuphoriaManager::SetViewerForward(const RavenMath::Vec3& forward)
+    {
+        mAgentArbiter.SetViewerForward(forward);
+    }
+
+    // EXPOSED MANANGER FUNCTION
+    /*!
+     * Hands over a settings bundle the game has loaded through its file system,
+     * replacing the one Initialize mapped, if any. The game keeps pData alive
+     * for as long as the manager exists. Only actors spawned afterwards use its
+     * performance settings; its blend profiles replace the current tuning.
+     */
+    bool EuphoriaManager::SetSettingsBundle(const void* pData, uint32 size)
+    {
+        const bool bAttached = mSettingsBundle.Attach(pData, size);
+        ResetBlendProfiles();
+        return bAttached;
+    }
+
+    // EXPOSED MANANGER FUNCTION
+    /*!
+     * Installs the game's line drawing for the Euphoria debug geometry, which
+     * DebugDrawAll hands over once per frame. NULL removes it. Ignored when
+     * debug drawing is compiled out.
+     */
+    void EuphoriaManager::SetDebugLineSink(euphoria::DebugLineSink sink)
+    {
+#if EUPHORIA_DEBUG_DRAW_ENABLED
+        euphoria::DebugDraw::SetSink(sink);
+#else
+        LECUNUSED(sink);
+#endif
+    }
+
+    // EXPOSED MANANGER FUNCTION
+    /*!
+     * Sets off one explosion against every Euphoria NPC within radius of
+     * sourcePos, in place of gameplay starting an ExplosionParams on each. The
+     * impulse scale is worked out once for the blast. The NPCs are then started
+     * in the agent arbiter's order, most valuable first, so the bind budget and
+     * any preemption favour the ones the player will notice. Past
+     * kMaxExplosionTargets, the least valuable are left out, and only the kept
+     * ones have their directions worked out.
+     *
+     * Returns the number of NPCs the explosion reached.
+     */
+    uint32 EuphoriaManager::Explode(const Vec3& sourcePos, float sourceMass, float velocity, float radius, RenID attacker)
+    {
+        EUPHORIA_PROFILE_SCOPE(EuphoriaManager, Explode);
+
+        // Aim at the chest rather than the feet, so the blast lifts
+        static const float kfTargetHeight = 1.0f;
+
+        // The spatial hash has positions up to SpatialHash::kRefreshFrames old,
+        // so allow for some movement and check each candidate's current position
+        static const float kfMovementSlack = 2.0f;
+        const uint32 numCandidates = mSpatialHash.QueryRadius(sourcePos, radius + kfMovementSlack, mExplodeCandidates, euphoria::SpatialHash::kMaxEntries);
+
+        // Keep the most valuable in a min-heap on score, so the least valuable
+        // kept NPC is at the root for a better one to replace
+        ExplosionTarget targets[kMaxExplosionTargets];
+        uint32 numTargets = 0;
+        uint32 numInRange = 0;
+        FortuneGameRenPlugInInterface* pRenInterface = mpFortuneGame->GetRenInterface();
+        const float radiusSq = radius * radius;
+        for (uint32 candidate = 0; candidate < numCandidates; ++candidate)
+        {
+            EuphoriaComp *pEuphoriaComp = GetEuphoriaComp(mExplodeCandidates[candidate]);
+            if (pEuphoriaComp == NULL)
+            {
+                continue;
+            }
+            Vec3 position;
+            Vec3Set_UA(position, pRenInterface->RenGetPosition(pEuphoriaComp->GetRenID()));
+            if (Vec3DistSqr(position, sourcePos) > radiusSq)
+            {
+                continue;
+            }
+            ++numInRange;
+
+            ExplosionTarget target;
+            target.mfScore = mAgentArbiter.Score(euphoria::eExplosion, position, 0.0f);
+            target.mpComp = pEuphoriaComp;
+            Vec3Set(target.mPosition, position);
+            if (numTargets < kMaxExplosionTargets)
+            {
+                uint32 i = numTargets++;
+                while (i > 0 && targets[(i - 1) / 2].mfScore > target.mfScore)
+                {
+                    targets[i] = targets[(i - 1) / 2];
+                    i = (i - 1) / 2;
+                }
+                targets[i] = target;
+            }
+            else if (target.mfScore > targets[0].mfScore)
+            {
+                targets[0] = target;
+                SiftDownExplosionTargets(targets, numTargets, 0);
+            }
+        }
+        if (numInRange > numTargets)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Explode: %u NPCs in range, the %u least valuable are missed\n", numInRange, numInRange - numTargets);
+        }
+
+        // Sort best first. Each pass moves the least valuable left to the end.
+        for (uint32 numLeft = numTargets; numLeft > 1; --numLeft)
+        {
+            const ExplosionTarget least = targets[0];
+            targets[0] = targets[numLeft - 1];
+            targets[numLeft - 1] = least;
+            SiftDownExplosionTargets(targets, numLeft - 1, 0);
+        }
+
+        euphoria::ExplosionParams params;
+        params.mAttacker = attacker;
+        Vec3Set(params.mSourcePos, sourcePos);
+        params.mSourceMass = sourceMass;
+        params.mVelocity = velocity;
+        params.mImpulseScale = euphoria::ExplosionPerformance::ComputeImpulseScale(sourceMass, velocity);
+        for (uint32 i = 0; i < numTargets; ++i)
+        {
+            // An NPC on top of the source goes straight up
+            const Vec3& position = targets[i].mPosition;
+            Vec3Set(params.mNormal, position.x - sourcePos.x, position.y + kfTargetHeight - sourcePos.y, position.z - sourcePos.z);
+            const float length = Vec3Mag(params.mNormal);
+            if (length > rm_epsilonFloat)
+            {
+                Vec3Mul(params.mNormal, params.mNormal, 1.0f / length);
+            }
+            else
+            {
+                Vec3Set(params.mNormal, 0.0f, 1.0f, 0.0f);
+            }
+            targets[i].mpComp->StartPerformance(params);
+        }
+
+        return numTargets;
+    }
+
+    /*!
+     * Restores the min-heap order of Explode's kept NPCs below index
+     */
+    void EuphoriaManager::SiftDownExplosionTargets(ExplosionTarget* pTargets, uint32 numTargets, uint32 index)
+    {
+        const ExplosionTarget target = pTargets[index];
+        for (;;)
+        {
+            uint32 child = 2 * index + 1;
+            if (child >= numTargets)
+            {
+                break;
+            }
+            if (child + 1 < numTargets && pTargets[child + 1].mfScore < pTargets[child].mfScore)
+            {
+                ++child;
+            }
+            if (pTargets[child].mfScore >= target.mfScore)
+            {
+                break;
+            }
+            pTargets[index] = pTargets[child];
+            index = child;
+        }
+        pTargets[index] = target;
+    }
+
     // EXPOSED MANANGER FUNCTION
     void EuphoriaManager::HandleMessage(const char* msg, RenID target)
     {
 //        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaManager::HandleMessage called!\n");
+
+        if (msg == NULL)
+        {
+            return;
+        }
+
+        if (HandleBlendProfileMessage(msg) || mAgentPool.HandleMessage(msg) || mAgentArbiter.HandleMessage(msg) ||
+            mProxyRagdoll.HandleMessage(msg) || mSpatialHash.HandleMessage(msg))
+        {
+            return;
+        }
+
+#if EUPHORIA_PROFILE_ENABLED
+        if (euphoria::Profiler::HandleMessage(msg) || euphoria::Timeline::HandleMessage(msg) || euphoria::Replay::HandleMessage(msg) ||
+            euphoria::Bench::HandleMessage(msg, target) || euphoria::Scenario::HandleMessage(msg, target))
+        {
+            return;
+        }
+#endif
+
+#if EUPHORIA_DEBUG_DRAW_ENABLED
+        if (euphoria::DebugDraw::HandleMessage(msg))
+        {
+            return;
+        }
+#endif
+
+#if EUPHORIA_TRACE_LEVEL > 0
+        if (euphoria::Trace::HandleMessage(msg))
+        {
+            return;
+        }
+#endif
     }
 }
@@ -6,7 +6,12 @@ EuphoriaManager.h
 #define _EuphoriaManager_H
 
 #include "EuphoriaConstants.h"
+#include "EuphoriaAgentArbiter.h"
+#include "EuphoriaAgentPool.h"
 #include "EuphoriaComp.h"
+#include "EuphoriaProxyRagdoll.h"
+#include "EuphoriaSettingsBundle.h"
+#include "EuphoriaSpatialHash.h"
 
 #include "EuphoriaManagerPlugInInterface.h"
 
@@ -25,6 +30,11 @@ namespace Ronin
         friend class EuphoriaManagerPlugIn;
 
     public:
+        enum
+        {
+            kMaxExplosionTargets = 64           //!< NPCs one Explode can start
+        };
+
         EuphoriaManager(void);
         virtual ~EuphoriaManager(void);
 
@@ -47,22 +57,80 @@ namespace Ronin
         void AddDebugMenus();
 
         inline EuphoriaComp* GetEuphoriaComp(RenID renID);
+        inline uint32 GetNumEuphoriaComps() const;
+        inline EuphoriaComp* GetEuphoriaCompAt(uint32 index) const;
+
+        // Blend tuning
+        inline const euphoria::BlendProfile& GetBlendProfile(euphoria::GetupPosition position) const;
+        void SetBlendProfile(euphoria::GetupPosition position, const euphoria::BlendProfile& profile);
+        void ResetBlendProfiles();
         
         //Euphoria Components
         
         GameHooks::FortuneGamePlugInInterface*     GetFortuneGamePlugIn();
+        inline const euphoria::SettingsBundle& GetSettingsBundle() const;
+        inline euphoria::AgentPool& GetAgentPool();
+        inline const euphoria::AgentArbiter& GetAgentArbiter() const;
+        bool PreemptAgentFor(RenID requester, float requestScore);
+        inline euphoria::ProxyRagdoll& GetProxyRagdoll();
+        inline const euphoria::SpatialHash& GetSpatialHash() const;
+        inline void RefreshSpatialHash();
 
         // Exposed functions in the Manager Interface
         virtual ComponentPlugInInterface* GetComponentInterface(RenID renID);
         void HandleMessage(const char* msg, Ronin::RenID target);
+        void SetViewerPosition(const RavenMath::Vec3& position);
+        void SetViewerForward(const RavenMath::Vec3& forward);
+        bool SetSettingsBundle(const void* pData, uint32 size);
+        void SetDebugLineSink(euphoria::DebugLineSink sink);
+        uint32 Explode(const RavenMath::Vec3& sourcePos, float sourceMass, float velocity, float radius, RenID attacker);
 
     private:
+        enum
+        {
+            kHotChunkShift = 8,
+            kHotChunkSize = 1 << kHotChunkShift,
+            kIdleCheckFrames = 4                    //!< Idle components look for behaviors started elsewhere this often. Power of two.
+        };
+
+        //! An NPC Explode is keeping, with the arbiter's score for it
+        struct ExplosionTarget
+        {
+            float mfScore;
+            EuphoriaComp* mpComp;
+            RavenMath::Vec3 mPosition;
+        };
+
+        static const euphoria::BlendProfile msDefaultBlendProfiles[euphoria::eNumGetups];
+        static const int msSettingsLoadsPerFrame;
+
+        //! Read by the replacement manager during HotLoad. MUST remain the first member.
+        euphoria::EuphoriaHotLoadState*                mpHotLoadState;
         GameHooks::FortuneGamePlugInInterface*         mpFortuneGame;
+        euphoria::BlendProfile                         mBlendProfiles[euphoria::eNumGetups];
+        euphoria::SettingsBundle                       mSettingsBundle;
+        euphoria::AgentPool                            mAgentPool;
+        euphoria::AgentArbiter                         mAgentArbiter;
+        euphoria::ProxyRagdoll                         mProxyRagdoll;
+        euphoria::SpatialHash                          mSpatialHash;
+        RenID                                          mExplodeCandidates[euphoria::SpatialHash::kMaxEntries];  //!< Explode's query results, kept off the stack
 
         RONIN_DEFINE_SORTED_COMPONENT_MAP_PUBLIC( EuphoriaComp, EuphoriaManagerImplMap, mAllEuphoriaComponents)
 
+        //! Per-frame part of every component, packed so ThinkAll walks it in order.
+        //! Chunks are never moved once allocated, so the components can point into them.
+        EuphoriaCompHot**                              mppHotChunks;
+        uint32                                         mNumHotChunks;
+        uint32                                         mNumHotRecords;
+        uint32                                         mIdleCheckPhase;
+
         EuphoriaManagerPlugIn   mPlugInInterface;
         EuphoriaComp* CreateComp(RenID renID);
+        void AddHotChunk();
+        static void SiftDownExplosionTargets(ExplosionTarget* pTargets, uint32 numTargets, uint32 index);
+        inline EuphoriaCompHot& GetHotRecord(uint32 index) const;
+        uint32 GetHotIndex(const EuphoriaCompHot* pHot) const;
+        bool HandleBlendProfileMessage(const char* msg);
     };
 
     extern EuphoriaManager *gpEuphoriaManager;
@@ -71,6 +139,76 @@ namespace Ronin
     { 
         return mAllEuphoriaComponents.find(renID);
     }
+
+    uint32 EuphoriaManager::GetNumEuphoriaComps() const
+    {
+        return mNumHotRecords;
+    }
+
+    /*!
+     * For walking every component, index from 0 to GetNumEuphoriaComps. The
+     * order changes when components are destroyed.
+     */
+    EuphoriaComp* EuphoriaManager::GetEuphoriaCompAt(uint32 index) const
+    {
+        LECASSERT(index < mNumHotRecords);
+
+        return GetHotRecord(index).mpComp;
+    }
+
+    EuphoriaCompHot& EuphoriaManager::GetHotRecord(uint32 index) const
+    {
+        return mppHotChunks[index >> kHotChunkShift][index & (kHotChunkSize - 1)];
+    }
+
+    const euphoria::SettingsBundle& EuphoriaManager::GetSettingsBundle() const
+    {
+        return mSettingsBundle;
+    }
+
+    euphoria::AgentPool& EuphoriaManager::GetAgentPool()
+    {
+        return mAgentPool;
+    }
+
+    const euphoria::AgentArbiter& EuphoriaManager::GetAgentArbiter() const
+    {
+        return mAgentArbiter;
+    }
+
+    euphoria::ProxyRagdoll& EuphoriaManager::GetProxyRagdoll()
+    {
+        return mProxyRagdoll;
+    }
+
+    /*!
+     * Where the components were at the end of the last ThinkAll, for area queries
+     */
+    const euphoria::SpatialHash& EuphoriaManager::GetSpatialHash() const
+    {
+        return mSpatialHash;
+    }
+
+    /*!
+     * Re-reads every component's position at the end of the next ThinkAll,
+     * for callers that have moved NPCs that are not thinking
+     */
+    void EuphoriaManager::RefreshSpatialHash()
+    {
+        mSpatialHash.RefreshAll();
+    }
+
+    /*!
+     * Returns the live blend tuning for a position. Performances should fetch
+     * this every time they start a blend rather than caching it, so tuning
+     * changes are picked up on the next getup.
+     */
+    const euphoria::BlendProfile& EuphoriaManager::GetBlendProfile(euphoria::GetupPosition position) const
+    {
+        LECASSERTMSG((position >= 0 && position < euphoria::eNumGetups), "position OUT OF RANGE!");
+
+        return mBlendProfiles[position];
+    }
 }
 
 #define PLUGIN_IMPL_EuphoriaManager
@@ -13,6 +13,18 @@ EuphoriaManagerPlugInInterface.h
 //
 
 
+namespace RavenMath
+{
+    struct Vec4;
+    typedef Vec4 Vec3;
+}
+
+namespace euphoria
+{
+    struct DebugLine;
+    typedef void (*DebugLineSink)(const DebugLine* pLines, uint32 numLines);
+}
+
 namespace Ronin
 {
     class EuphoriaManager;
@@ -31,6 +43,11 @@ namespace Ronin
         virtual ~EuphoriaManagerPlugIn_Root(){};
         virtual ComponentPlugInInterface* GetComponentInterface(RenID renID) =0;
         virtual void HandleMessage(const char* msg, Ronin::RenID target) =0;
+        virtual void SetViewerPosition(const RavenMath::Vec3& position) =0;
+        virtual void SetViewerForward(const RavenMath::Vec3& forward) =0;
+        virtual bool SetSettingsBundle(const void* pData, uint32 size) =0;
+        virtual void SetDebugLineSink(euphoria::DebugLineSink sink) =0;
+        virtual uint32 Explode(const RavenMath::Vec3& sourcePos, float sourceMass, float velocity, float radius, Ronin::RenID attacker) =0;
 
 #endif // defined(DLL_Fortune)
 
@@ -53,6 +70,11 @@ namespace Ronin
 
         inline ComponentPlugInInterface* GetComponentInterface(RenID renID);
         inline void HandleMessage(const char* msg, Ronin::RenID target);
+        inline void SetViewerPosition(const RavenMath::Vec3& position);
+        inline void SetViewerForward(const RavenMath::Vec3& forward);
+        inline bool SetSettingsBundle(const void* pData, uint32 size);
+        inline void SetDebugLineSink(euphoria::DebugLineSink sink);
+        inline uint32 Explode(const RavenMath::Vec3& sourcePos, float sourceMass, float velocity, float radius, Ronin::RenID attacker);
     };
 
 }
@@ -83,6 +105,36 @@ namespace Ronin
         mParent->HandleMessage(msg, target);
     }
 
+    // SetViewerPosition
+    void EuphoriaManagerPlugIn::SetViewerPosition(const RavenMath::Vec3& position)
+    {
+        mParent->SetViewerPosition(position);
+    }
+
+    // SetViewerForward
+    void EuphoriaManagerPlugIn::SetViewerForward(const RavenMath::Vec3& forward)
+    {
+        mParent->SetViewerForward(forward);
+    }
+
+    // SetSettingsBundle
+    bool EuphoriaManagerPlugIn::SetSettingsBundle(const void* pData, uint32 size)
+    {
+        return mParent->SetSettingsBundle(pData, size);
+    }
+
+    // SetDebugLineSink
+    void EuphoriaManagerPlugIn::SetDebugLineSink(euphoria::DebugLineSink sink)
+    {
+        mParent->SetDebugLineSink(sink);
+    }
+
+    // Explode
+    uint32 EuphoriaManagerPlugIn::Explode(const RavenMath::Vec3& sourcePos, float sourceMass, float velocity, float radius, Ronin::RenID attacker)
+    {
+        return mParent->Explode(sourcePos, sourceMass, velocity, radius, attacker);
+    }
+
 }
 
 
@@ -0,0 +1,70 @@
+#ifndef EUPHORIA_NAME_CRC_H
+#define EUPHORIA_NAME_CRC_H
+
+/*!
+ * CRCs for the non-behavior names the Euphoria code looks up: chores, blocks,
+ * overlays, body parts and events. Bones already in BoneCRC.h are not repeated.
+ * See EuphoriaBehaviorCRC.h for why these are enumerations. Every entry is checked
+ * against its string in EuphoriaManager.cpp, at compile time where the compiler
+ * supports it (see EuphoriaCRC.h).
+ */
+struct EuphoriaNameCRC
+{
+#ifdef PLATFORM_PS3
+    enum
+#else
+// Disable warning about non-standard extension used to specify underlying type for enum
+#pragma warning(disable : 4480)
+    enum : unsigned int
+#endif
+    {
+        // Plug-in
+        ePlugInName               = 0x4caa29e5, //  1286220261, "FortuneEuphoria"
+
+        // Events
+        eEnd                      = 0x691aa829, //  1763354665, "END"
+
+        // Body parts
+        eRoot                     = 0x0125cbf3, //    19254259, "Root"
+        eSpine2                   = 0x6bc8e82f, //  1808328751, "Spine2"
+
+        // Hand overlays
+        eLeftHandHang             = 0x87b179a2, // -2018412126, "LEFT_HAND_HANG"
+        eRightHandHang            = 0xac602439, // -1402985415, "RIGHT_HAND_HANG"
+        eLeftHandOpen             = 0x9daae933, // -1649743565, "LEFT_HAND_OPEN"
+        eRightHandOpen            = 0xb67bb4a8, // -1233406808, "RIGHT_HAND_OPEN"
+
+        // Getup chores
+        eChoreParamGetupFront     = 0x22d6f2af, //   584512175, "CHORE_PARAMETERIZED_GETUP_FROM_FRONT"
+        eChoreParamGetupBack      = 0x9939271f, // -1724307681, "CHORE_PARAMETERIZED_GETUP_FROM_BACK"
+        eChoreParamGetupLeft      = 0x8e900140, // -1903165120, "CHORE_PARAMETERIZED_GETUP_FROM_LEFT"
+        eChoreParamGetupRight     = 0x68e7e54d, //  1760027981, "CHORE_PARAMETERIZED_GETUP_FROM_RIGHT"
+        eChoreParamRecoverUpright = 0x78f406d5, //  2029258453, "CHORE_PARAMETERIZED_UPRIGHT_RECOVERY"
+        eChoreGetupFront          = 0x6cae5ada, //  1823365850, "CHORE_GETUP_FROM_FRONT"
+        eChoreGetupBack           = 0xe51206fd, //  -451803395, "CHORE_GETUP_FROM_BACK"
+        eChoreGetupLeft           = 0xf2bb20a2, //  -222617438, "CHORE_GETUP_FROM_LEFT"
+        eChoreGetupRight          = 0x269f4d38, //   647974200, "CHORE_GETUP_FROM_RIGHT"
+        eChoreRecoverUpright      = 0x368caea0, //   915189408, "CHORE_UPRIGHT_RECOVERY"
+        eChoreDeath               = 0xe93500a8, //  -382402392, "CHORE_DEATH"
+
+        // Getup blocks
+        eBlockParamGetupFront     = 0xa08d6512, // -1601346286, "CBLK_Param_Getup_Front"
+        eBlockParamGetupBack      = 0xca5a5b49, //  -900048055, "CBLK_Param_Getup_Back"
+        eBlockParamGetupLeft      = 0xddf37d16, //  -571245290, "CBLK_Param_Getup_Left"
+        eBlockParamGetupRight     = 0xeabc72f0, //  -356748560, "CBLK_Param_Getup_Right"
+        eBlockParamRecoverUpright = 0xb40403fd, // -1274805251, "CBLK_Param_Recover_Upright"
+        eBlockGetupFront          = 0xd58c3d78, //  -712229512, "CBLK_Euph_Getup_Front"
+        eBlockGetupBack           = 0xa1a1ad8b, // -1583239797, "CBLK_Euph_Getup_Back"
+        eBlockGetupLeft           = 0xb6088bd4, // -1240953900, "CBLK_Euph_Getup_Left"
+        eBlockGetupRight          = 0x9fbd2a9a, // -1614992742, "CBLK_Euph_Getup_Right"
+        eBlockRecoverUpright      = 0xbb44df60, // -1153114272, "CBLK_Euph_Recover_Upright"
+        eBlockStaticDeadPose      = 0xb6ddbc41, // -1226982335, "CBLK_StaticDeadPose"
+    };
+};
+
+#ifndef PLATFORM_PS3
+#pragma warning(default : 4480)
+#endif
+
+// EUPHORIA_NAME_CRC_H
+#endif
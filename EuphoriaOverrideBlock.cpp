@@ -0,0 +1,49 @@
+#include "EuphoriaOverrideBlock.h"
+#include "ParameterOverrideDataInterface.h"
+
+namespace euphoria
+{
+    // USING DECLARATIONS
+    using Ronin::ParameterOverrideDataInterface;
+
+    /*!
+     * Copies a baked override block into the behavior override data. The caller
+     * is expected to patch any situation dependent slots afterwards and then hand
+     * pData->GetPOD() to StartBehavior.
+     */
+    void ApplyOverrideBlock(ParameterOverrideDataInterface* pData, const OverrideBlock& rBlock)
+    {
+        LECASSERT(pData);
+        LECASSERT(rBlock.mNumFloats <= OverrideBlock::kMaxFloats);
+        LECASSERT(rBlock.mNumInts <= OverrideBlock::kMaxInts);
+        LECASSERT(rBlock.mNumBools <= OverrideBlock::kMaxBools);
+        LECASSERT(rBlock.mNumVectors <= OverrideBlock::kMaxVectors);
+        LECASSERT(rBlock.mNumParts <= OverrideBlock::kMaxParts);
+        LECASSERT(rBlock.mNumChars <= OverrideBlock::kMaxChars);
+
+        for (uint32 i = 0; i < rBlock.mNumFloats; ++i)
+        {
+            pData->SetFloat(i, rBlock.mFloats[i]);
+        }
+        for (uint32 i = 0; i < rBlock.mNumInts; ++i)
+        {
+            pData->SetInt(i, rBlock.mInts[i]);
+        }
+        for (uint32 i = 0; i < rBlock.mNumBools; ++i)
+        {
+            pData->SetBool(i, rBlock.mBools[i]);
+        }
+        for (uint32 i = 0; i < rBlock.mNumVectors; ++i)
+        {
+            pData->SetVector(i, rBlock.mVectors[i][0], rBlock.mVectors[i][1], rBlock.mVectors[i][2]);
+        }
+        for (uint32 i = 0; i < rBlock.mNumParts; ++i)
+        {
+            pData->SetPart(i, rBlock.mParts[i]);
+        }
+        for (uint32 i = 0; i < rBlock.mNumChars; ++i)
+        {
+            pData->SetChar(i, rBlock.mChars[i]);
+        }
+    }
+}
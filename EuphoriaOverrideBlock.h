@@ -0,0 +1,54 @@
+#ifndef EUPHORIA_OVERRIDE_BLOCK_H
+#define EUPHORIA_OVERRIDE_BLOCK_H
+
+#include "RoninConfig.h"
+
+namespace Ronin
+{
+    // FORWARD DECLARATIONS
+    class ParameterOverrideDataInterface;
+}
+
+namespace euphoria
+{
+    /*!
+     * Pre-laid-out set of parameter overrides for a single behavior start. These
+     * are declared as static const tables next to the performance that uses them,
+     * so the layout is fixed at compile time and nothing is built up on entry.
+     * The performance applies the block and then patches the few slots that
+     * depend on the current situation (impulse vectors, impact parts, durations).
+     *
+     * Only the first mNumXXX entries of each array are written. Slots that are
+     * always patched should still be counted so they are cleared to a known value.
+     */
+    struct OverrideBlock
+    {
+        enum
+        {
+            kMaxFloats = 4,
+            kMaxInts = 5,
+            kMaxBools = 3,
+            kMaxVectors = 2,
+            kMaxParts = 1,
+            kMaxChars = 1
+        };
+
+        uint32 mNumFloats;
+        float mFloats[kMaxFloats];
+        uint32 mNumInts;
+        int mInts[kMaxInts];
+        uint32 mNumBools;
+        bool mBools[kMaxBools];
+        uint32 mNumVectors;
+        float mVectors[kMaxVectors][3];
+        uint32 mNumParts;
+        crc32_t mParts[kMaxParts];
+        uint32 mNumChars;
+        const char* mChars[kMaxChars];
+    };
+
+    void ApplyOverrideBlock(Ronin::ParameterOverrideDataInterface* pData, const OverrideBlock& rBlock);
+}
+
+// EUPHORIA_OVERRIDE_BLOCK_H
+#endif
@@ -86,6 +86,7 @@ namespace euphoria
         RavenMath::Vec3 mNormal;
         float mSourceMass;
         float mVelocity;
+        float mImpulseScale;    //!< Clamped impulse per unit of mNormal, which must then be unit length. 0 (the default) works it out from mSourceMass and mVelocity, and clamps whatever length mNormal has.
 
         // CREATORS
         inline ExplosionParams();
@@ -96,7 +97,7 @@ namespace euphoria
         inline ExplosionParams& operator=(const ExplosionParams& rhs);
     } END_DECLARE_ALIGNED;
 
-    ExplosionParams::ExplosionParams() : EuphoriaParamsBase(eExplosion)
+    ExplosionParams::ExplosionParams() : EuphoriaParamsBase(eExplosion), mImpulseScale(0.0f)
     {
     }
 
@@ -108,6 +109,7 @@ namespace euphoria
         mSourceMass = rhs.mSourceMass;
         mSourcePos = rhs.mSourcePos;
         mVelocity = rhs.mVelocity;
+        mImpulseScale = rhs.mImpulseScale;
     }
 
     ExplosionParams::~ExplosionParams()
@@ -124,6 +126,7 @@ namespace euphoria
             mSourceMass = rhs.mSourceMass;
             mSourcePos = rhs.mSourcePos;
             mVelocity = rhs.mVelocity;
+            mImpulseScale = rhs.mImpulseScale;
         }
         return *this;
     }
@@ -323,6 +326,9 @@ namespace euphoria
         LECALIGNEDCLASS(16)
 
     public:
+        // MEMBERS
+        RavenMath::Vec3 mCarryImpulse;  //!< Pushed into the spine as the fall starts, to keep a proxy ragdoll's momentum. Zero for none.
+
         // CREATORS
         inline FallingParams();
         inline FallingParams(const FallingParams& rhs);
@@ -335,12 +341,14 @@ namespace euphoria
     inline FallingParams::FallingParams()
         : EuphoriaParamsBase(eFalling)
     {
+        Vec3SetZero(mCarryImpulse);
     }
 
     inline FallingParams::FallingParams(const FallingParams& rhs)
         : EuphoriaParamsBase(eFalling)
     {
         mAttacker = rhs.mAttacker;
+        mCarryImpulse = rhs.mCarryImpulse;
     }
 
     inline FallingParams::~FallingParams()
@@ -352,6 +360,7 @@ namespace euphoria
         if (this != &rhs)
         {
             mAttacker = rhs.mAttacker;
+            mCarryImpulse = rhs.mCarryImpulse;
         }
         return *this;
     }
@@ -0,0 +1,432 @@
+#include "EuphoriaProfiler.h"
+
+#if EUPHORIA_PROFILE_ENABLED
+
+#include "EuphoriaTimeline.h"
+#include "LECLog.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(PLATFORM_WINDOWS)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#define EUPHORIA_THREAD_LOCAL __declspec(thread)
+#elif defined(PLATFORM_PS3)
+#include <sys/sys_time.h>
+#include <ppu_intrinsics.h>
+#define EUPHORIA_THREAD_LOCAL __thread
+#else
+#include <time.h>
+#define EUPHORIA_THREAD_LOCAL __thread
+#endif
+
+namespace euphoria
+{
+    // USING DECLARATIONS
+    using lec::LecTraceChannel;
+
+    // Define statics
+    ProfileSlot* ProfileSlot::msFirst = NULL;
+
+    //! Catches counts made outside any performance, e.g. from EuphoriaComp directly
+    static ProfileSlot sProfile_Unscoped("Unscoped");
+
+    // LOCAL CONST INITIALIZATION
+    namespace
+    {
+        //! Thread index plus one, so zero means unassigned
+        EUPHORIA_THREAD_LOCAL int tThreadIndex = 0;
+        //! Innermost open ProfileScope on this thread
+        EUPHORIA_THREAD_LOCAL ProfileSlot* tpCurrentSlot = NULL;
+        volatile long sNextThreadIndex = 0;
+        ProfileTicks sTicksPerSecond = 0;
+        uint32 sNumFrames = 0;
+
+        const char* const kCounterNames[eNumProfileCounters] = {
+            "CheckLOS",
+            "RayCastClosest",
+            "IsSupported",
+            "FindEdgesInRadius",
+            "DistanceToEdge",
+            "StartBehavior",
+            "StopBehavior",
+            "StopAllBehaviors",
+            "StartBlock",
+            "CreateConstraint"
+        };
+
+        ProfileTicks BucketBound(int bucket)
+        {
+            return (bucket == 0) ? 1 : (1ull << bucket);
+        }
+    }
+
+    /*!
+     * Links the slot into the global list. Slots are file-scope statics, and msFirst
+     * is zero-initialized before any of them are constructed.
+     */
+    ProfileSlot::ProfileSlot(const char* pName)
+        : mpName(pName), mpNext(msFirst)
+    {
+        msFirst = this;
+        Reset();
+    }
+
+    /*!
+     * Adds one sample to the calling thread's histogram. Samples stay in raw
+     * ticks so short scopes keep their resolution; Summarize converts.
+     */
+    void ProfileSlot::Record(ProfileTicks ticks)
+    {
+        ThreadData& rThread = mThreads[Profiler::GetThreadIndex()];
+
+        int bucket = 0;
+        for (ProfileTicks value = ticks; value != 0; value >>= 1)
+        {
+            ++bucket;
+        }
+        if (bucket >= kNumBuckets)
+        {
+            bucket = kNumBuckets - 1;
+        }
+
+        ++rThread.mBuckets[bucket];
+        ++rThread.mCount;
+        rThread.mTotal += static_cast<double>(ticks);
+        if (ticks > rThread.mMax)
+        {
+            rThread.mMax = ticks;
+        }
+    }
+
+    /*!
+     * Folds every thread's counts for the frame into the per-frame figures. Runs
+     * on the main thread once all the comps have thought.
+     */
+    void ProfileSlot::EndFrame()
+    {
+        for (int c = 0; c < eNumProfileCounters; ++c)
+        {
+            uint32 frameCount = 0;
+            for (int i = 0; i < kMaxThreads; ++i)
+            {
+                frameCount += mThreads[i].mFrameCounts[c];
+                mThreads[i].mFrameCounts[c] = 0;
+            }
+
+            mLastFrameCounts[c] = frameCount;
+            mTotalCounts[c] += frameCount;
+            if (frameCount > mPeakFrameCounts[c])
+            {
+                mPeakFrameCounts[c] = frameCount;
+            }
+        }
+    }
+
+    void ProfileSlot::Reset()
+    {
+        memset(mThreads, 0, sizeof(mThreads));
+        memset(mLastFrameCounts, 0, sizeof(mLastFrameCounts));
+        memset(mPeakFrameCounts, 0, sizeof(mPeakFrameCounts));
+        memset(mTotalCounts, 0, sizeof(mTotalCounts));
+    }
+
+    /*!
+     * Merges every thread's histogram. Percentiles are the upper bound of the
+     * bucket they fall in, capped at the recorded maximum. Everything is
+     * converted from ticks to microseconds here.
+     */
+    void ProfileSlot::Summarize(Summary& rSummary) const
+    {
+        uint32 buckets[kNumBuckets];
+        memset(buckets, 0, sizeof(buckets));
+        double total = 0.0;
+        ProfileTicks maxTicks = 0;
+        memset(&rSummary, 0, sizeof(rSummary));
+
+        for (int i = 0; i < kMaxThreads; ++i)
+        {
+            const ThreadData& rThread = mThreads[i];
+            for (int b = 0; b < kNumBuckets; ++b)
+            {
+                buckets[b] += rThread.mBuckets[b];
+            }
+            rSummary.mCount += rThread.mCount;
+            total += rThread.mTotal;
+            if (rThread.mMax > maxTicks)
+            {
+                maxTicks = rThread.mMax;
+            }
+        }
+
+        if (rSummary.mCount == 0)
+        {
+            return;
+        }
+
+        const uint32 p50Rank = (rSummary.mCount + 1) / 2;
+        const uint32 p95Rank = (rSummary.mCount * 95 + 99) / 100;
+        ProfileTicks p50Ticks = 0;
+        ProfileTicks p95Ticks = 0;
+        uint32 seen = 0;
+        for (int b = 0; b < kNumBuckets; ++b)
+        {
+            seen += buckets[b];
+            if (p50Ticks == 0 && seen >= p50Rank)
+            {
+                p50Ticks = BucketBound(b);
+            }
+            if (seen >= p95Rank)
+            {
+                p95Ticks = BucketBound(b);
+                break;
+            }
+        }
+
+        if (p50Ticks > maxTicks)
+        {
+            p50Ticks = maxTicks;
+        }
+        if (p95Ticks > maxTicks)
+        {
+            p95Ticks = maxTicks;
+        }
+
+        const double ticksPerMicrosecond = Profiler::GetTicksPerMicrosecond();
+        rSummary.mP50 = static_cast<float>(p50Ticks / ticksPerMicrosecond);
+        rSummary.mP95 = static_cast<float>(p95Ticks / ticksPerMicrosecond);
+        rSummary.mMax = static_cast<float>(maxTicks / ticksPerMicrosecond);
+        rSummary.mMean = static_cast<float>(total / rSummary.mCount / ticksPerMicrosecond);
+    }
+
+    ProfileTicks Profiler::ReadTicks()
+    {
+#if defined(PLATFORM_WINDOWS)
+        LARGE_INTEGER ticks;
+        QueryPerformanceCounter(&ticks);
+        return static_cast<ProfileTicks>(ticks.QuadPart);
+#elif defined(PLATFORM_PS3)
+        return static_cast<ProfileTicks>(__mftb());
+#else
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<ProfileTicks>(now.tv_sec) * 1000000000ull + now.tv_nsec;
+#endif
+    }
+
+    uint32 Profiler::TicksToMicroseconds(ProfileTicks ticks)
+    {
+        return static_cast<uint32>(ticks / GetTicksPerMicrosecond());
+    }
+
+    double Profiler::GetTicksPerMicrosecond()
+    {
+        // Benign race: every thread computes the same value
+        if (sTicksPerSecond == 0)
+        {
+#if defined(PLATFORM_WINDOWS)
+            LARGE_INTEGER frequency;
+            QueryPerformanceFrequency(&frequency);
+            sTicksPerSecond = static_cast<ProfileTicks>(frequency.QuadPart);
+#elif defined(PLATFORM_PS3)
+            sTicksPerSecond = static_cast<ProfileTicks>(sys_time_get_timebase_frequency());
+#else
+            sTicksPerSecond = 1000000000ull;
+#endif
+        }
+
+        return static_cast<double>(sTicksPerSecond) / 1000000.0;
+    }
+
+    /*!
+     * Hands each thread its own histogram index the first time it records
+     */
+    int Profiler::GetThreadIndex()
+    {
+        if (tThreadIndex == 0)
+        {
+#if defined(PLATFORM_WINDOWS)
+            long index = InterlockedIncrement(&sNextThreadIndex);
+#else
+            long index = __sync_add_and_fetch(&sNextThreadIndex, 1);
+#endif
+            tThreadIndex = (index < ProfileSlot::kMaxThreads) ? static_cast<int>(index) : ProfileSlot::kMaxThreads;
+        }
+
+        return tThreadIndex - 1;
+    }
+
+    /*!
+     * Makes pSlot the target of EUPHORIA_COUNT on this thread, returning the old one
+     */
+    ProfileSlot* Profiler::EnterScope(ProfileSlot* pSlot)
+    {
+        if (Timeline::IsCapturing())
+        {
+            Timeline::Begin(pSlot->GetName());
+        }
+
+        ProfileSlot* pOuterSlot = tpCurrentSlot;
+        tpCurrentSlot = pSlot;
+        return pOuterSlot;
+    }
+
+    void Profiler::LeaveScope(ProfileSlot* pOuterSlot)
+    {
+        tpCurrentSlot = pOuterSlot;
+
+        if (Timeline::IsCapturing())
+        {
+            Timeline::End();
+        }
+    }
+
+    void Profiler::Count(ProfileCounter counter)
+    {
+        ProfileSlot* pSlot = (tpCurrentSlot != NULL) ? tpCurrentSlot : &sProfile_Unscoped;
+        pSlot->Count(counter);
+
+        if (Timeline::IsCapturing())
+        {
+            Timeline::Instant(kCounterNames[counter]);
+        }
+    }
+
+    void Profiler::EndFrame()
+    {
+        for (ProfileSlot* pSlot = ProfileSlot::GetFirst(); pSlot != NULL; pSlot = pSlot->GetNext())
+        {
+            pSlot->EndFrame();
+        }
+        ++sNumFrames;
+
+        Timeline::EndFrame();
+    }
+
+    void Profiler::Show()
+    {
+        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "%-48s %8s %8s %8s %8s %10s\n", "Euphoria (us)", "count", "p50", "p95", "max", "mean");
+        for (const ProfileSlot* pSlot = ProfileSlot::GetFirst(); pSlot != NULL; pSlot = pSlot->GetNext())
+        {
+            ProfileSlot::Summary summary;
+            pSlot->Summarize(summary);
+            if (summary.mCount != 0)
+            {
+                LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "%-48s %8u %8.2f %8.2f %8.2f %10.2f\n", pSlot->GetName(),
+                    summary.mCount, summary.mP50, summary.mP95, summary.mMax, summary.mMean);
+            }
+        }
+    }
+
+    void Profiler::ShowCounters()
+    {
+        const float numFrames = (sNumFrames != 0) ? static_cast<float>(sNumFrames) : 1.0f;
+
+        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "%-48s %-18s %8s %8s %10s   (%u frames)\n", "Euphoria calls", "counter", "last", "peak", "avg", sNumFrames);
+        for (const ProfileSlot* pSlot = ProfileSlot::GetFirst(); pSlot != NULL; pSlot = pSlot->GetNext())
+        {
+            for (int c = 0; c < eNumProfileCounters; ++c)
+            {
+                const ProfileCounter counter = static_cast<ProfileCounter>(c);
+                if (pSlot->GetTotalCount(counter) != 0)
+                {
+                    LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "%-48s %-18s %8u %8u %10.2f\n", pSlot->GetName(), kCounterNames[c],
+                        pSlot->GetLastFrameCount(counter), pSlot->GetPeakFrameCount(counter), pSlot->GetTotalCount(counter) / numFrames);
+                }
+            }
+        }
+    }
+
+    /*!
+     * Writes every slot, including unused ones, as comma separated values,
+     * followed by the non-zero counters
+     */
+    bool Profiler::Dump(const char* pPath)
+    {
+        FILE* pFile = fopen(pPath, "w");
+        if (pFile == NULL)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaProfile: could not open %s\n", pPath);
+            return false;
+        }
+
+        fprintf(pFile, "name,count,p50_us,p95_us,max_us,mean_us\n");
+        for (const ProfileSlot* pSlot = ProfileSlot::GetFirst(); pSlot != NULL; pSlot = pSlot->GetNext())
+        {
+            ProfileSlot::Summary summary;
+            pSlot->Summarize(summary);
+            fprintf(pFile, "%s,%u,%.3f,%.3f,%.3f,%.3f\n", pSlot->GetName(),
+                summary.mCount, summary.mP50, summary.mP95, summary.mMax, summary.mMean);
+        }
+
+        const float numFrames = (sNumFrames != 0) ? static_cast<float>(sNumFrames) : 1.0f;
+        fprintf(pFile, "\nname,counter,last,peak,total,avg_per_frame\n");
+        for (const ProfileSlot* pSlot = ProfileSlot::GetFirst(); pSlot != NULL; pSlot = pSlot->GetNext())
+        {
+            for (int c = 0; c < eNumProfileCounters; ++c)
+            {
+                const ProfileCounter counter = static_cast<ProfileCounter>(c);
+                if (pSlot->GetTotalCount(counter) != 0)
+                {
+                    fprintf(pFile, "%s,%s,%u,%u,%u,%.2f\n", pSlot->GetName(), kCounterNames[c], pSlot->GetLastFrameCount(counter),
+                        pSlot->GetPeakFrameCount(counter), pSlot->GetTotalCount(counter), pSlot->GetTotalCount(counter) / numFrames);
+                }
+            }
+        }
+
+        fclose(pFile);
+        return true;
+    }
+
+    void Profiler::Reset()
+    {
+        for (ProfileSlot* pSlot = ProfileSlot::GetFirst(); pSlot != NULL; pSlot = pSlot->GetNext())
+        {
+            pSlot->Reset();
+        }
+        sNumFrames = 0;
+    }
+
+    /*!
+     * Returns true if the message was a profiler message. See the class comment.
+     */
+    bool Profiler::HandleMessage(const char* msg)
+    {
+        static const char kPrefix[] = "EuphoriaProfile ";
+        if (strncmp(msg, kPrefix, sizeof(kPrefix) - 1) != 0)
+        {
+            return false;
+        }
+
+        const char* pCommand = msg + sizeof(kPrefix) - 1;
+        char path[256];
+        if (strcmp(pCommand, "show") == 0)
+        {
+            Show();
+        }
+        else if (strcmp(pCommand, "counters") == 0)
+        {
+            ShowCounters();
+        }
+        else if (strcmp(pCommand, "reset") == 0)
+        {
+            Reset();
+        }
+        else if (sscanf(pCommand, "dump %255s", path) == 1)
+        {
+            Dump(path);
+        }
+        else
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaProfile: unknown command %s\n", pCommand);
+        }
+
+        return true;
+    }
+}
+
+// EUPHORIA_PROFILE_ENABLED
+#endif
@@ -0,0 +1,251 @@
+#ifndef EUPHORIA_PROFILER_H
+#define EUPHORIA_PROFILER_H
+
+#include "RoninConfig.h"
+
+/*!
+ * Timing for performance Think/OnEvent and state ENTER/UPDATE, plus counts of the
+ * expensive engine calls made inside them. On by default in
+ * debug builds; a profiling configuration can define EUPHORIA_PROFILE_ENABLED to 1.
+ * When it is off, the macros at the bottom of this file expand to nothing and none
+ * of the classes exist.
+ */
+#ifndef EUPHORIA_PROFILE_ENABLED
+#ifdef _DEBUG
+#define EUPHORIA_PROFILE_ENABLED 1
+#else
+#define EUPHORIA_PROFILE_ENABLED 0
+#endif
+#endif
+
+#if EUPHORIA_PROFILE_ENABLED
+
+#if defined(PLATFORM_WINDOWS)
+#define EUPHORIA_CACHE_ALIGN __declspec(align(128))
+#else
+#define EUPHORIA_CACHE_ALIGN __attribute__((aligned(128)))
+#endif
+
+namespace euphoria
+{
+    typedef unsigned long long ProfileTicks;
+
+    /*!
+     * Engine calls counted per frame with EUPHORIA_COUNT
+     */
+    enum ProfileCounter
+    {
+        eCountCheckLOS,
+        eCountRayCastClosest,
+        eCountIsSupported,                  //!< Both IsSupported and IsSupportedEuphoria
+        eCountFindEdgesInRadius,
+        eCountDistanceToEdge,
+        eCountStartBehavior,
+        eCountStopBehavior,
+        eCountStopAllBehaviors,
+        eCountStartBlock,
+        eCountCreateConstraint,
+        eNumProfileCounters
+    };
+
+    /*!
+     * One named timing point. Each thread records into its own cache-line aligned
+     * block, so recording takes no locks; readers merge the blocks and accept that a
+     * sample landing mid-read may be missed. Counters are recorded the same way and
+     * folded into per-frame figures by Profiler::EndFrame.
+     *
+     * Slots are file-scope statics that link themselves into a global list on
+     * construction. Define them with the EUPHORIA_PROFILE_DEFINE_* macros.
+     */
+    class ProfileSlot
+    {
+    public:
+        enum
+        {
+            kMaxThreads = 8,        //!< Threads past this share the last histogram
+            kNumBuckets = 40        //!< Bucket i holds samples in [2^(i-1), 2^i) ticks
+        };
+
+        struct Summary
+        {
+            uint32 mCount;
+            float mP50;             //!< Microseconds, rounded up to the bucket bound
+            float mP95;
+            float mMax;
+            float mMean;
+        };
+
+        // CREATORS
+        explicit ProfileSlot(const char* pName);
+
+        // MANIPULATORS
+        void Record(ProfileTicks ticks);
+        inline void Count(ProfileCounter counter);
+        void EndFrame();
+        void Reset();
+
+        // ACCESSORS
+        inline const char* GetName() const;
+        inline ProfileSlot* GetNext() const;
+        void Summarize(Summary& rSummary) const;
+        inline uint32 GetLastFrameCount(ProfileCounter counter) const;
+        inline uint32 GetPeakFrameCount(ProfileCounter counter) const;
+        inline uint32 GetTotalCount(ProfileCounter counter) const;
+
+        static inline ProfileSlot* GetFirst();
+
+    private:
+        //! Written only by its own thread
+        struct EUPHORIA_CACHE_ALIGN ThreadData
+        {
+            uint32 mBuckets[kNumBuckets];
+            uint32 mCount;
+            ProfileTicks mMax;
+            double mTotal;
+            uint32 mFrameCounts[eNumProfileCounters];
+        };
+
+        // MEMBERS
+        ThreadData mThreads[kMaxThreads];
+        const char* mpName;
+        ProfileSlot* mpNext;
+        uint32 mLastFrameCounts[eNumProfileCounters];
+        uint32 mPeakFrameCounts[eNumProfileCounters];
+        uint32 mTotalCounts[eNumProfileCounters];
+
+        // STATIC MEMBERS
+        static ProfileSlot* msFirst;
+
+        // NOT IMPLEMENTED
+        ProfileSlot(const ProfileSlot&);
+        ProfileSlot& operator=(const ProfileSlot&);
+    };
+
+    /*!
+     * Times its own lifetime into a slot
+     */
+    class ProfileScope
+    {
+    public:
+        // CREATORS
+        inline explicit ProfileScope(ProfileSlot& rSlot);
+        inline ~ProfileScope();
+
+    private:
+        // MEMBERS
+        ProfileSlot& mrSlot;
+        ProfileSlot* mpOuterSlot;
+        ProfileTicks mStart;
+
+        // NOT IMPLEMENTED
+        ProfileScope(const ProfileScope&);
+        ProfileScope& operator=(const ProfileScope&);
+    };
+
+    /*!
+     * Clock and reporting for the slots. Driven from EuphoriaManager::HandleMessage:
+     *
+     *   EuphoriaProfile show           traces count/p50/p95/max/mean per slot
+     *   EuphoriaProfile counters       traces last/peak/average per frame of each counter
+     *   EuphoriaProfile dump <path>    writes both tables to a file
+     *   EuphoriaProfile reset          clears every slot
+     */
+    class Profiler
+    {
+    public:
+        static ProfileTicks ReadTicks();
+        static uint32 TicksToMicroseconds(ProfileTicks ticks);
+        static double GetTicksPerMicrosecond();
+        static int GetThreadIndex();
+        static ProfileSlot* EnterScope(ProfileSlot* pSlot);
+        static void LeaveScope(ProfileSlot* pOuterSlot);
+        static void Count(ProfileCounter counter);
+        static void EndFrame();
+
+        static void Show();
+        static void ShowCounters();
+        static bool Dump(const char* pPath);
+        static void Reset();
+        static bool HandleMessage(const char* msg);
+    };
+
+    // INLINES
+    const char* ProfileSlot::GetName() const
+    {
+        return mpName;
+    }
+
+    ProfileSlot* ProfileSlot::GetNext() const
+    {
+        return mpNext;
+    }
+
+    ProfileSlot* ProfileSlot::GetFirst()
+    {
+        return msFirst;
+    }
+
+    void ProfileSlot::Count(ProfileCounter counter)
+    {
+        ++mThreads[Profiler::GetThreadIndex()].mFrameCounts[counter];
+    }
+
+    uint32 ProfileSlot::GetLastFrameCount(ProfileCounter counter) const
+    {
+        return mLastFrameCounts[counter];
+    }
+
+    uint32 ProfileSlot::GetPeakFrameCount(ProfileCounter counter) const
+    {
+        return mPeakFrameCounts[counter];
+    }
+
+    uint32 ProfileSlot::GetTotalCount(ProfileCounter counter) const
+    {
+        return mTotalCounts[counter];
+    }
+
+    /*!
+     * Counts made while the scope is open go to its slot rather than the outer one
+     */
+    ProfileScope::ProfileScope(ProfileSlot& rSlot)
+        : mrSlot(rSlot), mpOuterSlot(Profiler::EnterScope(&rSlot)), mStart(Profiler::ReadTicks())
+    {
+    }
+
+    ProfileScope::~ProfileScope()
+    {
+        mrSlot.Record(Profiler::ReadTicks() - mStart);
+        Profiler::LeaveScope(mpOuterSlot);
+    }
+}
+
+#define EUPHORIA_PROFILE_DEFINE_SCOPE(Class, Label) \
+    static euphoria::ProfileSlot sProfile_##Class##_##Label(#Class "::" #Label)
+
+#define EUPHORIA_PROFILE_DEFINE_PERFORMANCE(Class) \
+    static euphoria::ProfileSlot sProfile_##Class##_Think(#Class "::Think"); \
+    static euphoria::ProfileSlot sProfile_##Class##_OnEvent(#Class "::OnEvent")
+
+#define EUPHORIA_PROFILE_DEFINE_STATE(Class, State) \
+    static euphoria::ProfileSlot sProfile_##Class##_##State##_ENTER(#Class "::" #State "::ENTER"); \
+    static euphoria::ProfileSlot sProfile_##Class##_##State##_UPDATE(#Class "::" #State "::UPDATE")
+
+#define EUPHORIA_PROFILE_SCOPE(Class, Label) \
+    euphoria::ProfileScope profileScope(sProfile_##Class##_##Label)
+
+#define EUPHORIA_COUNT(Counter) euphoria::Profiler::Count(euphoria::Counter)
+
+#else
+
+// A repeated typedef is legal at namespace scope, unlike a stray semicolon in C++03
+#define EUPHORIA_PROFILE_DEFINE_SCOPE(Class, Label) typedef int ProfileUnused_##Class
+#define EUPHORIA_PROFILE_DEFINE_PERFORMANCE(Class) typedef int ProfileUnused_##Class
+#define EUPHORIA_PROFILE_DEFINE_STATE(Class, State) typedef int ProfileUnused_##Class
+#define EUPHORIA_PROFILE_SCOPE(Class, Label) ((void)0)
+#define EUPHORIA_COUNT(Counter) ((void)0)
+
+#endif
+
+// EUPHORIA_PROFILER_H
+#endif
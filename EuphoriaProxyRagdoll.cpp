@@ -0,0 +1,504 @@
+#include "EuphoriaProxyRagdoll.h"
+#include "LECLog.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace euphoria
+{
+    // USING DECLARATIONS
+    using lec::LecTraceChannel;
+    using namespace RavenMath;
+
+    // LOCAL CONST INITIALIZATION
+    namespace
+    {
+        // Standing pose, measured up from the Ren's origin at the feet
+        const float kProxyPelvisHeight = 0.95f;
+        const float kProxyHeadHeight = 1.7f;
+        const float kProxyHalfStance = 0.15f;
+
+        const float kProxyGravity = -9.81f;
+        const float kProxyDamping = 0.99f;
+        const float kProxyGroundFriction = 0.6f;        //!< Share of sliding speed kept per step on the ground
+        const float kProxyMaxStep = 1.0f / 30.0f;
+        const float kProxySettleSpeed = 0.1f;
+        const float kProxyHandOffRatio = 0.8f;          //!< Hand off inside this share of the distance, so a body doesn't flip back and forth
+        const float kProxyDefaultDistance = 25.0f;
+        const float kProxyToppleSpeed = 1.0f;           //!< Head speed that tips over a proxy started with no push
+
+        // Share of a hit's velocity each particle takes, in ParticleType order.
+        // The feet are planted, so a push tips the body over them instead of
+        // sliding it along the ground upright.
+        const float kProxyLaunchShare[] = { 1.0f, 1.0f, 0.5f, 0.5f };
+
+        const Vec3 kProxyUnitX = { 1.0f, 0.0f, 0.0f, 0.0f };
+    }
+
+    // Define statics
+    // Legs hang free from the pelvis. The soft head to feet links stop the
+    // torso folding over a pelvis still standing on its legs, so the body
+    // topples as a whole and only bends when it lands.
+    const ProxyRagdoll::Link ProxyRagdoll::msLinks[] = {
+        { ePelvis,      eHead,          kProxyHeadHeight - kProxyPelvisHeight,  1.0f },
+        { ePelvis,      eLeftFoot,      kProxyPelvisHeight,                     1.0f },
+        { ePelvis,      eRightFoot,     kProxyPelvisHeight,                     1.0f },
+        { eLeftFoot,    eRightFoot,     2.0f * kProxyHalfStance,                1.0f },
+        { eHead,        eLeftFoot,      kProxyHeadHeight,                       0.3f },
+        { eHead,        eRightFoot,     kProxyHeadHeight,                       0.3f }
+    };
+
+    ProxyRagdoll::ProxyRagdoll()
+        : mNumBodies(0), mbHasViewer(false), mfDistance(kProxyDefaultDistance),
+          mNumStarted(0), mNumHandedOff(0), mNumSettled(0), mPeakBodies(0)
+    {
+        for (int i = 0; i < kMaxBodies; ++i)
+        {
+            mPackedIndex[i] = kInvalidHandle;
+        }
+        Vec3Set(mViewerPos, 0.0f, 0.0f, 0.0f);
+    }
+
+    /*!
+     * Packs a new body and gives it the lowest free handle. Returns
+     * kInvalidHandle when every proxy is in use.
+     */
+    int ProxyRagdoll::Allocate()
+    {
+        if (mNumBodies == kMaxBodies)
+        {
+            return kInvalidHandle;
+        }
+
+        int handle = 0;
+        while (mPackedIndex[handle] != kInvalidHandle)
+        {
+            ++handle;
+        }
+
+        const uint32 body = mNumBodies++;
+        mPackedIndex[handle] = body;
+        mHandleAt[body] = handle;
+        if (mNumBodies > mPeakBodies)
+        {
+            mPeakBodies = mNumBodies;
+        }
+        return handle;
+    }
+
+    /*!
+     * Starts a proxy in the standing pose of renTransform, launched by velocity.
+     * A proxy with little or no push is tipped forward so that it still falls.
+     * Returns kInvalidHandle when every proxy is in use.
+     */
+    int ProxyRagdoll::Start(const Mat44& renTransform, const Vec3& velocity, float groundHeight)
+    {
+        const int handle = Allocate();
+        if (handle == kInvalidHandle)
+        {
+            return kInvalidHandle;
+        }
+
+        const uint32 body = mPackedIndex[handle];
+        mGroundHeight[body] = groundHeight;
+        mStillTime[body] = 0.0f;
+
+        Vec3 right = ROW_X_BASIS(renTransform);
+        Vec3 up = ROW_Y_BASIS(renTransform);
+        Vec3 forward = ROW_Z_BASIS(renTransform);
+        Vec3 cross;
+        Vec3Cross(cross, right, up);
+        mHandedness[body] = (Vec3Dot(cross, forward) >= 0.0f) ? 1.0f : -1.0f;
+
+        const Vec3& origin = ROW_TRANSLATION(renTransform);
+        Vec3 particles[eNumParticles];
+        Vec3AddScaled(particles[ePelvis], origin, up, kProxyPelvisHeight);
+        Vec3AddScaled(particles[eHead], origin, up, kProxyHeadHeight);
+        Vec3AddScaled(particles[eLeftFoot], origin, right, -kProxyHalfStance);
+        Vec3AddScaled(particles[eRightFoot], origin, right, kProxyHalfStance);
+
+        for (int p = 0; p < eNumParticles; ++p)
+        {
+            const uint32 i = Index(static_cast<ParticleType>(p), body);
+            mPosX[i] = particles[p].x;
+            mPosY[i] = particles[p].y;
+            mPosZ[i] = particles[p].z;
+            mPrevX[i] = particles[p].x;
+            mPrevY[i] = particles[p].y;
+            mPrevZ[i] = particles[p].z;
+        }
+        AddVelocity(handle, velocity);
+
+        // Standing still on its feet the proxy would balance forever
+        if (velocity.x * velocity.x + velocity.z * velocity.z < kProxyToppleSpeed * kProxyToppleSpeed)
+        {
+            const uint32 head = Index(eHead, body);
+            mPrevX[head] -= forward.x * kProxyToppleSpeed * kProxyMaxStep;
+            mPrevY[head] -= forward.y * kProxyToppleSpeed * kProxyMaxStep;
+            mPrevZ[head] -= forward.z * kProxyToppleSpeed * kProxyMaxStep;
+        }
+
+        ++mNumStarted;
+        return handle;
+    }
+
+    /*!
+     * Adds a hit's velocity to the proxy, mostly to the upper body (see
+     * kProxyLaunchShare). Also used for a second hit on a running proxy.
+     */
+    void ProxyRagdoll::AddVelocity(int handle, const Vec3& velocity)
+    {
+        LECASSERT(handle >= 0 && handle < kMaxBodies && mPackedIndex[handle] != kInvalidHandle);
+        const uint32 body = mPackedIndex[handle];
+
+        // Verlet keeps velocity as the step from the previous position
+        for (int p = 0; p < eNumParticles; ++p)
+        {
+            const uint32 i = Index(static_cast<ParticleType>(p), body);
+            const float step = kProxyLaunchShare[p] * kProxyMaxStep;
+            mPrevX[i] -= velocity.x * step;
+            mPrevY[i] -= velocity.y * step;
+            mPrevZ[i] -= velocity.z * step;
+        }
+        mStillTime[body] = 0.0f;
+    }
+
+    /*!
+     * Frees the proxy. The last packed body moves into its place.
+     */
+    void ProxyRagdoll::Stop(int handle, bool bHandedOff)
+    {
+        LECASSERT(handle >= 0 && handle < kMaxBodies && mPackedIndex[handle] != kInvalidHandle);
+        const uint32 body = mPackedIndex[handle];
+        const uint32 last = --mNumBodies;
+        if (body != last)
+        {
+            for (int p = 0; p < eNumParticles; ++p)
+            {
+                const uint32 to = Index(static_cast<ParticleType>(p), body);
+                const uint32 from = Index(static_cast<ParticleType>(p), last);
+                mPosX[to] = mPosX[from];
+                mPosY[to] = mPosY[from];
+                mPosZ[to] = mPosZ[from];
+                mPrevX[to] = mPrevX[from];
+                mPrevY[to] = mPrevY[from];
+                mPrevZ[to] = mPrevZ[from];
+            }
+            mGroundHeight[body] = mGroundHeight[last];
+            mStillTime[body] = mStillTime[last];
+            mHandedness[body] = mHandedness[last];
+            mHandleAt[body] = mHandleAt[last];
+            mPackedIndex[mHandleAt[body]] = body;
+        }
+        mPackedIndex[handle] = kInvalidHandle;
+
+        if (bHandedOff)
+        {
+            ++mNumHandedOff;
+        }
+        else
+        {
+            ++mNumSettled;
+        }
+    }
+
+    /*!
+     * Copies out one body, for a hot load
+     */
+    void ProxyRagdoll::SaveBody(int handle, BodyState& outState) const
+    {
+        LECASSERT(handle >= 0 && handle < kMaxBodies && mPackedIndex[handle] != kInvalidHandle);
+        const uint32 body = mPackedIndex[handle];
+        for (int p = 0; p < eNumParticles; ++p)
+        {
+            const uint32 i = Index(static_cast<ParticleType>(p), body);
+            Vec3Set(outState.mPos[p], mPosX[i], mPosY[i], mPosZ[i]);
+            Vec3Set(outState.mPrev[p], mPrevX[i], mPrevY[i], mPrevZ[i]);
+        }
+        outState.mGroundHeight = mGroundHeight[body];
+        outState.mStillTime = mStillTime[body];
+        outState.mHandedness = mHandedness[body];
+    }
+
+    /*!
+     * Puts back a body saved by the module this one replaced. Returns its new
+     * handle, or kInvalidHandle when every proxy is in use.
+     */
+    int ProxyRagdoll::RestoreBody(const BodyState& rState)
+    {
+        const int handle = Allocate();
+        if (handle == kInvalidHandle)
+        {
+            return kInvalidHandle;
+        }
+
+        const uint32 body = mPackedIndex[handle];
+        for (int p = 0; p < eNumParticles; ++p)
+        {
+            const uint32 i = Index(static_cast<ParticleType>(p), body);
+            mPosX[i] = rState.mPos[p].x;
+            mPosY[i] = rState.mPos[p].y;
+            mPosZ[i] = rState.mPos[p].z;
+            mPrevX[i] = rState.mPrev[p].x;
+            mPrevY[i] = rState.mPrev[p].y;
+            mPrevZ[i] = rState.mPrev[p].z;
+        }
+        mGroundHeight[body] = rState.mGroundHeight;
+        mStillTime[body] = rState.mStillTime;
+        mHandedness[body] = rState.mHandedness;
+        return handle;
+    }
+
+    /*!
+     * Steps every proxy. Called once per frame from ThinkAll before the
+     * components think.
+     */
+    void ProxyRagdoll::Step(float elapsedTime)
+    {
+        const uint32 numBodies = mNumBodies;
+        if (numBodies == 0)
+        {
+            return;
+        }
+
+        const float dt = (elapsedTime < kProxyMaxStep) ? elapsedTime : kProxyMaxStep;
+        const float gravityStep = kProxyGravity * dt * dt;
+
+        // Integrate
+        for (int p = 0; p < eNumParticles; ++p)
+        {
+            float* const pX = mPosX + p * kMaxBodies;
+            float* const pY = mPosY + p * kMaxBodies;
+            float* const pZ = mPosZ + p * kMaxBodies;
+            float* const pPrevX = mPrevX + p * kMaxBodies;
+            float* const pPrevY = mPrevY + p * kMaxBodies;
+            float* const pPrevZ = mPrevZ + p * kMaxBodies;
+            for (uint32 b = 0; b < numBodies; ++b)
+            {
+                const float vx = (pX[b] - pPrevX[b]) * kProxyDamping;
+                const float vy = (pY[b] - pPrevY[b]) * kProxyDamping;
+                const float vz = (pZ[b] - pPrevZ[b]) * kProxyDamping;
+                pPrevX[b] = pX[b];
+                pPrevY[b] = pY[b];
+                pPrevZ[b] = pZ[b];
+                pX[b] += vx;
+                pY[b] += vy + gravityStep;
+                pZ[b] += vz;
+            }
+        }
+
+        for (int iteration = 0; iteration < kNumIterations; ++iteration)
+        {
+            // Links, each pulled from both ends by its stiffness
+            for (int l = 0; l < kNumLinks; ++l)
+            {
+                const Link& rLink = msLinks[l];
+                float* const pAX = mPosX + rLink.mA * kMaxBodies;
+                float* const pAY = mPosY + rLink.mA * kMaxBodies;
+                float* const pAZ = mPosZ + rLink.mA * kMaxBodies;
+                float* const pBX = mPosX + rLink.mB * kMaxBodies;
+                float* const pBY = mPosY + rLink.mB * kMaxBodies;
+                float* const pBZ = mPosZ + rLink.mB * kMaxBodies;
+                for (uint32 b = 0; b < numBodies; ++b)
+                {
+                    const float dx = pBX[b] - pAX[b];
+                    const float dy = pBY[b] - pAY[b];
+                    const float dz = pBZ[b] - pAZ[b];
+                    const float length = Sqrt(dx * dx + dy * dy + dz * dz);
+                    const float k = (length > rm_epsilonFloat) ? 0.5f * rLink.mStiffness * (length - rLink.mRestLength) / length : 0.0f;
+                    pAX[b] += dx * k;
+                    pAY[b] += dy * k;
+                    pAZ[b] += dz * k;
+                    pBX[b] -= dx * k;
+                    pBY[b] -= dy * k;
+                    pBZ[b] -= dz * k;
+                }
+            }
+
+            // Ground, with friction on whatever touches it
+            for (int p = 0; p < eNumParticles; ++p)
+            {
+                float* const pX = mPosX + p * kMaxBodies;
+                float* const pY = mPosY + p * kMaxBodies;
+                float* const pZ = mPosZ + p * kMaxBodies;
+                float* const pPrevX = mPrevX + p * kMaxBodies;
+                float* const pPrevY = mPrevY + p * kMaxBodies;
+                float* const pPrevZ = mPrevZ + p * kMaxBodies;
+                for (uint32 b = 0; b < numBodies; ++b)
+                {
+                    if (pY[b] < mGroundHeight[b])
+                    {
+                        pY[b] = mGroundHeight[b];
+                        pPrevY[b] = pY[b];
+                        pPrevX[b] = pX[b] - (pX[b] - pPrevX[b]) * kProxyGroundFriction;
+                        pPrevZ[b] = pZ[b] - (pZ[b] - pPrevZ[b]) * kProxyGroundFriction;
+                    }
+                }
+            }
+        }
+
+        // Stillness, from the pelvis
+        const float* const pX = mPosX + ePelvis * kMaxBodies;
+        const float* const pY = mPosY + ePelvis * kMaxBodies;
+        const float* const pZ = mPosZ + ePelvis * kMaxBodies;
+        const float* const pPrevX = mPrevX + ePelvis * kMaxBodies;
+        const float* const pPrevY = mPrevY + ePelvis * kMaxBodies;
+        const float* const pPrevZ = mPrevZ + ePelvis * kMaxBodies;
+        const float maxStill = kProxySettleSpeed * dt;
+        for (uint32 b = 0; b < numBodies; ++b)
+        {
+            const float dx = pX[b] - pPrevX[b];
+            const float dy = pY[b] - pPrevY[b];
+            const float dz = pZ[b] - pPrevZ[b];
+            mStillTime[b] = (dx * dx + dy * dy + dz * dz < maxStill * maxStill) ? mStillTime[b] + dt : 0.0f;
+        }
+    }
+
+    void ProxyRagdoll::SetViewerPosition(const Vec3& position)
+    {
+        Vec3Set(mViewerPos, position);
+        mbHasViewer = true;
+    }
+
+    /*!
+     * True if an NPC at position should use a proxy
+     */
+    bool ProxyRagdoll::IsDistant(const Vec3& position) const
+    {
+        return mbHasViewer && mfDistance > 0.0f && Vec3DistSqr(position, mViewerPos) > mfDistance * mfDistance;
+    }
+
+    /*!
+     * True if a proxy at position should be handed to the real ragdoll
+     */
+    bool ProxyRagdoll::IsNear(const Vec3& position) const
+    {
+        const float handOffDistance = mfDistance * kProxyHandOffRatio;
+        return mbHasViewer && Vec3DistSqr(position, mViewerPos) < handOffDistance * handOffDistance;
+    }
+
+    /*!
+     * Distance from position to the viewer, or negative if the game has not set one
+     */
+    float ProxyRagdoll::GetViewerDistance(const Vec3& position) const
+    {
+        return mbHasViewer ? Sqrt(Vec3DistSqr(position, mViewerPos)) : -1.0f;
+    }
+
+    bool ProxyRagdoll::IsSettled(int handle, float settleTime) const
+    {
+        LECASSERT(handle >= 0 && handle < kMaxBodies && mPackedIndex[handle] != kInvalidHandle);
+        return mStillTime[mPackedIndex[handle]] > settleTime;
+    }
+
+    /*!
+     * The pelvis velocity, in the units AddVelocity takes, for carrying the
+     * proxy's momentum over to the real ragdoll
+     */
+    void ProxyRagdoll::GetVelocity(int handle, Vec3& outVelocity) const
+    {
+        LECASSERT(handle >= 0 && handle < kMaxBodies && mPackedIndex[handle] != kInvalidHandle);
+        const uint32 i = Index(ePelvis, mPackedIndex[handle]);
+        const float invStep = 1.0f / kProxyMaxStep;
+        Vec3Set(outVelocity, (mPosX[i] - mPrevX[i]) * invStep, (mPosY[i] - mPrevY[i]) * invStep, (mPosZ[i] - mPrevZ[i]) * invStep);
+    }
+
+    void ProxyRagdoll::GetAxes(uint32 body, Vec3& outRight, Vec3& outUp, Vec3& outForward) const
+    {
+        const uint32 pelvis = Index(ePelvis, body);
+        const uint32 head = Index(eHead, body);
+        const uint32 leftFoot = Index(eLeftFoot, body);
+        const uint32 rightFoot = Index(eRightFoot, body);
+
+        Vec3 up;
+        Vec3Set(up, mPosX[head] - mPosX[pelvis], mPosY[head] - mPosY[pelvis], mPosZ[head] - mPosZ[pelvis]);
+        Vec3NormalizeSafe(outUp, up, kVecUnitY);
+
+        // Across the feet, square to the spine
+        Vec3 right;
+        Vec3Set(right, mPosX[rightFoot] - mPosX[leftFoot], mPosY[rightFoot] - mPosY[leftFoot], mPosZ[rightFoot] - mPosZ[leftFoot]);
+        Vec3AddScaled(right, right, outUp, -Vec3Dot(right, outUp));
+        Vec3NormalizeSafe(outRight, right, kProxyUnitX);
+
+        Vec3Cross(outForward, outRight, outUp);
+        Vec3Mul(outForward, outForward, mHandedness[body]);
+    }
+
+    /*!
+     * The Ren transform for the proxy's pose: axes from the spine and feet,
+     * origin below the pelvis where the feet would be
+     */
+    void ProxyRagdoll::GetRenTransform(int handle, Mat44& outTransform) const
+    {
+        LECASSERT(handle >= 0 && handle < kMaxBodies && mPackedIndex[handle] != kInvalidHandle);
+        const uint32 body = mPackedIndex[handle];
+
+        Mat44SetIdentity(outTransform);
+        GetAxes(body, ROW_X_BASIS(outTransform), ROW_Y_BASIS(outTransform), ROW_Z_BASIS(outTransform));
+
+        const uint32 pelvis = Index(ePelvis, body);
+        Vec3 pelvisPos;
+        Vec3Set(pelvisPos, mPosX[pelvis], mPosY[pelvis], mPosZ[pelvis]);
+        Vec3AddScaled(ROW_TRANSLATION(outTransform), pelvisPos, ROW_Y_BASIS(outTransform), -kProxyPelvisHeight);
+    }
+
+    /*!
+     * The getup for the proxy's pose, on the same thresholds as
+     * EuphoriaComp::DetermineGetupPosition
+     */
+    GetupPosition ProxyRagdoll::ClassifyGetup(int handle) const
+    {
+        LECASSERT(handle >= 0 && handle < kMaxBodies && mPackedIndex[handle] != kInvalidHandle);
+
+        Vec3 right;
+        Vec3 up;
+        Vec3 forward;
+        GetAxes(mPackedIndex[handle], right, up, forward);
+
+        if (up.y >= kfGetupCos45)
+        {
+            return eGetupUpright;
+        }
+        if (forward.y <= kfGetupCos125)
+        {
+            return eGetupFront;
+        }
+        if (forward.y <= kfGetupCos55)
+        {
+            Vec3 side;
+            Vec3Cross(side, up, forward);
+            return (side.y >= kfGetupCos90) ? eGetupRight : eGetupLeft;
+        }
+        return eGetupBack;
+    }
+
+    /*!
+     * Handles "EuphoriaProxy distance <metres>|stats". Returns true if the
+     * message was ours.
+     */
+    bool ProxyRagdoll::HandleMessage(const char* msg)
+    {
+        static const char kPrefix[] = "EuphoriaProxy ";
+        if (strncmp(msg, kPrefix, sizeof(kPrefix) - 1) != 0)
+        {
+            return false;
+        }
+
+        const char* pCommand = msg + sizeof(kPrefix) - 1;
+        float distance;
+        if (sscanf(pCommand, "distance %f", &distance) == 1 && distance >= 0.0f)
+        {
+            mfDistance = distance;
+        }
+        else if (strcmp(pCommand, "stats") == 0)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaProxy: %u running (peak %u), beyond %.1fm%s, %u started, %u handed off, %u settled\n",
+                       mNumBodies, mPeakBodies, mfDistance, mbHasViewer ? "" : " (no viewer yet)", mNumStarted, mNumHandedOff, mNumSettled);
+        }
+        else
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaProxy: unknown command %s\n", pCommand);
+        }
+        return true;
+    }
+}
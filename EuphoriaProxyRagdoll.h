@@ -0,0 +1,151 @@
+#ifndef EUPHORIA_PROXY_RAGDOLL_H
+#define EUPHORIA_PROXY_RAGDOLL_H
+
+#include "RoninConfig.h"
+#include "RavenMath.h"
+#include "EuphoriaStruct.h"
+
+namespace euphoria
+{
+    /*!
+     * A cheap stand-in for the ragdoll, for NPCs too far from the viewer to be
+     * worth an agent. Each body is four particles (pelvis, head and feet) held
+     * together by distance constraints and stepped with Verlet integration
+     * against a flat ground plane found once at the start. The NPC's Ren is
+     * posed from the particles each frame, so the whole body tips, falls and
+     * slides; the limbs keep whatever animation was playing. A hit launches
+     * the upper body more than the planted feet, so the proxy pivots over
+     * them and falls rather than gliding upright.
+     *
+     * Particles are stored particle-major across bodies (every pelvis, then
+     * every head, ...) and bodies are kept packed, so each step is a handful of
+     * straight loops over all proxies at once.
+     *
+     * The game supplies the viewer position through EuphoriaManager. Until it
+     * does, nothing is far away and proxies are never used.
+     *
+     *   EuphoriaProxy distance <metres>    Use proxies beyond this, 0 turns them off
+     *   EuphoriaProxy stats
+     */
+    class ProxyRagdoll
+    {
+    public:
+        enum
+        {
+            kMaxBodies = 128,
+            kInvalidHandle = -1
+        };
+
+        enum ParticleType
+        {
+            ePelvis,
+            eHead,
+            eLeftFoot,
+            eRightFoot,
+            eNumParticles
+        };
+
+        //! One body's particles and timers, carried across a hot load
+        struct BodyState
+        {
+            RavenMath::Vec3 mPos[eNumParticles];
+            RavenMath::Vec3 mPrev[eNumParticles];
+            float mGroundHeight;
+            float mStillTime;
+            float mHandedness;
+        };
+
+    private:
+        enum
+        {
+            kNumLinks = 6,
+            kNumIterations = 4
+        };
+
+        struct Link
+        {
+            ParticleType mA;
+            ParticleType mB;
+            float mRestLength;
+            float mStiffness;                   //!< Share of the error corrected per iteration
+        };
+
+        // STATIC MEMBERS
+        static const Link msLinks[kNumLinks];
+
+        // MEMBERS
+        // Particle p of the body packed at b is at [p * kMaxBodies + b]
+        float mPosX[eNumParticles * kMaxBodies];
+        float mPosY[eNumParticles * kMaxBodies];
+        float mPosZ[eNumParticles * kMaxBodies];
+        float mPrevX[eNumParticles * kMaxBodies];
+        float mPrevY[eNumParticles * kMaxBodies];
+        float mPrevZ[eNumParticles * kMaxBodies];
+
+        // Per packed body
+        float mGroundHeight[kMaxBodies];
+        float mStillTime[kMaxBodies];
+        float mHandedness[kMaxBodies];          //!< Sign to rebuild the Ren's forward axis from its right and up axes
+        int mHandleAt[kMaxBodies];
+
+        // Per handle
+        int mPackedIndex[kMaxBodies];           //!< kInvalidHandle when the handle is free
+        uint32 mNumBodies;
+
+        RavenMath::Vec3 mViewerPos;
+        bool mbHasViewer;
+        float mfDistance;
+
+        uint32 mNumStarted;
+        uint32 mNumHandedOff;
+        uint32 mNumSettled;
+        uint32 mPeakBodies;
+
+        // NOT IMPLEMENTED
+        ProxyRagdoll(const ProxyRagdoll&);
+        ProxyRagdoll& operator=(const ProxyRagdoll&);
+
+        // METHODS
+        int Allocate();
+        inline uint32 Index(ParticleType particle, uint32 body) const;
+        void GetAxes(uint32 body, RavenMath::Vec3& outRight, RavenMath::Vec3& outUp, RavenMath::Vec3& outForward) const;
+
+    public:
+        // CREATORS
+        ProxyRagdoll();
+
+        // MANIPULATORS
+        int Start(const RavenMath::Mat44& renTransform, const RavenMath::Vec3& velocity, float groundHeight);
+        void AddVelocity(int handle, const RavenMath::Vec3& velocity);
+        void Stop(int handle, bool bHandedOff);
+        int RestoreBody(const BodyState& rState);
+        void Step(float elapsedTime);
+        void SetViewerPosition(const RavenMath::Vec3& position);
+        bool HandleMessage(const char* msg);
+
+        // ACCESSORS
+        bool IsDistant(const RavenMath::Vec3& position) const;
+        bool IsNear(const RavenMath::Vec3& position) const;
+        float GetViewerDistance(const RavenMath::Vec3& position) const;
+        bool IsSettled(int handle, float settleTime) const;
+        void GetVelocity(int handle, RavenMath::Vec3& outVelocity) const;
+        void SaveBody(int handle, BodyState& outState) const;
+        void GetRenTransform(int handle, RavenMath::Mat44& outTransform) const;
+        GetupPosition ClassifyGetup(int handle) const;
+        inline uint32 GetNumBodies() const;
+    };
+
+    // INLINES
+    uint32 ProxyRagdoll::Index(ParticleType particle, uint32 body) const
+    {
+        return particle * kMaxBodies + body;
+    }
+
+    uint32 ProxyRagdoll::GetNumBodies() const
+    {
+        return mNumBodies;
+    }
+}
+
+// EUPHORIA_PROXY_RAGDOLL_H
+#endif
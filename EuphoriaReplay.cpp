@@ -0,0 +1,403 @@
+#include "EuphoriaReplay.h"
+
+#if EUPHORIA_PROFILE_ENABLED
+
+#include "EuphoriaComp.h"
+#include "EuphoriaHotLoad.h"
+#include "EuphoriaManager.h"
+#include "EuphoriaParams.h"
+#include "LECAlign.h"
+#include "LECLog.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace euphoria
+{
+    // USING DECLARATIONS
+    using lec::LecTraceChannel;
+    using Ronin::EuphoriaComp;
+    using Ronin::gpEuphoriaManager;
+
+    // Define statics
+    Replay::Mode Replay::msMode = Replay::eModeOff;
+    bool Replay::msbInjecting = false;
+    uint32 Replay::msInputDepth = 0;
+
+    // LOCAL CONST INITIALIZATION
+    namespace
+    {
+        const uint32 kReplayFileMagic = 0x50525545;    // 'EURP'
+        const uint32 kReplayFileVersion = 2;
+        const size_t kReplayWriteBufferSize = 64 * 1024;
+
+        //! Each record is this byte followed by its fields, unpadded
+        enum ReplayRecordType
+        {
+            eRecordFrame = 1,               //!< float elapsedTime
+            eRecordStartPerformance,        //!< uint32 renID, uint8 size, params
+            eRecordAnimationEvent,          //!< uint32 renID, uint32 eventNameCRC
+            eRecordBehaviorEvent,           //!< uint32 renID, uint32 eventType
+            eRecordResult                   //!< uint8 size, result
+        };
+
+        DECLARE_ALIGNED struct ReplayParams
+        {
+            LECALIGNEDCLASS(16);
+
+            unsigned char mBytes[EuphoriaCompHotLoadState::kMaxParamsSize];
+        } END_DECLARE_ALIGNED;
+
+        // Recording
+        FILE* spReplayFile = NULL;
+
+        // Replaying, the whole recording is read in up front
+        unsigned char* spReplayData = NULL;
+        uint32 sReplaySize = 0;
+        uint32 sReplayPos = 0;
+
+        uint32 sReplayFrame = 0;
+
+        void WriteBytes(const void* pData, uint32 size)
+        {
+            fwrite(pData, 1, size, spReplayFile);
+        }
+
+        void WriteRecordType(ReplayRecordType type)
+        {
+            const unsigned char byte = static_cast<unsigned char>(type);
+            WriteBytes(&byte, sizeof(byte));
+        }
+
+        bool ReadBytes(void* pData, uint32 size)
+        {
+            if (size > sReplaySize - sReplayPos)
+            {
+                return false;
+            }
+            memcpy(pData, spReplayData + sReplayPos, size);
+            sReplayPos += size;
+            return true;
+        }
+
+        EuphoriaComp* FindReplayComp(uint32 renID)
+        {
+            EuphoriaComp* pEuphoriaComp = gpEuphoriaManager->GetEuphoriaComp(static_cast<Ronin::RenID>(renID));
+            if (pEuphoriaComp == NULL)
+            {
+                LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaReplay: no component for %u at frame %u\n", renID, sReplayFrame);
+            }
+            return pEuphoriaComp;
+        }
+    }
+
+    /*!
+     * Starts writing a recording to pPath, ending any recording or replay in progress
+     */
+    bool Replay::StartRecording(const char* pPath)
+    {
+        Stop();
+
+        spReplayFile = fopen(pPath, "wb");
+        if (spReplayFile == NULL)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaReplay: could not open %s\n", pPath);
+            return false;
+        }
+        setvbuf(spReplayFile, NULL, _IOFBF, kReplayWriteBufferSize);
+
+        const uint32 header[3] = { kReplayFileMagic, kReplayFileVersion, EuphoriaCompHotLoadState::kMaxParamsSize };
+        WriteBytes(header, sizeof(header));
+
+        sReplayFrame = 0;
+        msMode = eModeRecording;
+        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaReplay: recording to %s\n", pPath);
+        return true;
+    }
+
+    /*!
+     * Loads the recording at pPath and starts playing it from the next ThinkAll
+     */
+    bool Replay::StartReplay(const char* pPath)
+    {
+        Stop();
+
+        FILE* pFile = fopen(pPath, "rb");
+        if (pFile == NULL)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaReplay: could not open %s\n", pPath);
+            return false;
+        }
+
+        fseek(pFile, 0, SEEK_END);
+        const long fileSize = ftell(pFile);
+        fseek(pFile, 0, SEEK_SET);
+
+        uint32 header[3];
+        if (fileSize < static_cast<long>(sizeof(header)) || fread(header, sizeof(header), 1, pFile) != 1 ||
+            header[0] != kReplayFileMagic || header[1] != kReplayFileVersion || header[2] != EuphoriaCompHotLoadState::kMaxParamsSize)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaReplay: %s is not a recording\n", pPath);
+            fclose(pFile);
+            return false;
+        }
+
+        sReplaySize = static_cast<uint32>(fileSize) - sizeof(header);
+        spReplayData = lec_new unsigned char[sReplaySize];
+        const bool bRead = (sReplaySize == 0) || (fread(spReplayData, sReplaySize, 1, pFile) == 1);
+        fclose(pFile);
+        if (!bRead)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaReplay: could not read %s\n", pPath);
+            Stop();
+            return false;
+        }
+
+        sReplayPos = 0;
+        sReplayFrame = 0;
+        msMode = eModeReplaying;
+        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaReplay: playing %s\n", pPath);
+        return true;
+    }
+
+    void Replay::Stop()
+    {
+        if (msMode == eModeRecording)
+        {
+            fclose(spReplayFile);
+            spReplayFile = NULL;
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaReplay: recorded %u frames\n", sReplayFrame);
+        }
+        else if (msMode == eModeReplaying)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaReplay: stopped after %u frames\n", sReplayFrame);
+        }
+
+        lec_delete [] spReplayData;
+        spReplayData = NULL;
+        sReplaySize = 0;
+        sReplayPos = 0;
+
+        msMode = eModeOff;
+        msbInjecting = false;
+    }
+
+    /*!
+     * Called at the top of ThinkAll. Returns the elapsed time to think with, which
+     * is the recorded one while replaying.
+     */
+    float Replay::BeginFrame(float elapsedTime)
+    {
+        if (msMode == eModeRecording)
+        {
+            WriteRecordType(eRecordFrame);
+            WriteBytes(&elapsedTime, sizeof(elapsedTime));
+            ++sReplayFrame;
+        }
+        else if (msMode == eModeReplaying)
+        {
+            if (!SendRecordedInputs())
+            {
+                if (msMode == eModeReplaying)
+                {
+                    LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaReplay: end of recording\n");
+                    Stop();
+                }
+                return elapsedTime;
+            }
+
+            unsigned char type = 0;
+            float recordedTime = 0.0f;
+            if (!ReadBytes(&type, sizeof(type)) || type != eRecordFrame || !ReadBytes(&recordedTime, sizeof(recordedTime)))
+            {
+                StopOutOfStep("expected a frame");
+                return elapsedTime;
+            }
+            ++sReplayFrame;
+            return recordedTime;
+        }
+
+        return elapsedTime;
+    }
+
+    void Replay::RecordStartPerformance(uint32 renID, const void* pParams, uint32 size)
+    {
+        if (msMode != eModeRecording)
+        {
+            return;
+        }
+        LECASSERT(size <= EuphoriaCompHotLoadState::kMaxParamsSize);
+
+        const unsigned char byteSize = static_cast<unsigned char>(size);
+        WriteRecordType(eRecordStartPerformance);
+        WriteBytes(&renID, sizeof(renID));
+        WriteBytes(&byteSize, sizeof(byteSize));
+        WriteBytes(pParams, size);
+    }
+
+    void Replay::RecordAnimationEvent(uint32 renID, uint32 eventNameCRC)
+    {
+        if (msMode != eModeRecording)
+        {
+            return;
+        }
+
+        WriteRecordType(eRecordAnimationEvent);
+        WriteBytes(&renID, sizeof(renID));
+        WriteBytes(&eventNameCRC, sizeof(eventNameCRC));
+    }
+
+    /*!
+     * The event's override data and collision data are not recorded; no
+     * performance reads them.
+     */
+    void Replay::RecordBehaviorEvent(uint32 renID, uint32 eventType)
+    {
+        if (msMode != eModeRecording)
+        {
+            return;
+        }
+
+        WriteRecordType(eRecordBehaviorEvent);
+        WriteBytes(&renID, sizeof(renID));
+        WriteBytes(&eventType, sizeof(eventType));
+    }
+
+    void Replay::WriteResult(const void* pData, uint32 size)
+    {
+        LECASSERT(size <= 0xff);
+
+        const unsigned char byteSize = static_cast<unsigned char>(size);
+        WriteRecordType(eRecordResult);
+        WriteBytes(&byteSize, sizeof(byteSize));
+        WriteBytes(pData, size);
+    }
+
+    /*!
+     * Fills pData with the next recorded query result. Inputs recorded before it
+     * are sent first. If the next record is not a result of this size the replay
+     * has gone out of step; it is stopped and pData is zeroed.
+     */
+    void Replay::ReadResult(void* pData, uint32 size)
+    {
+        unsigned char type = 0;
+        unsigned char recordedSize = 0;
+        if (!SendRecordedInputs() || !ReadBytes(&type, sizeof(type)) || type != eRecordResult ||
+            !ReadBytes(&recordedSize, sizeof(recordedSize)) || recordedSize != size || !ReadBytes(pData, size))
+        {
+            memset(pData, 0, size);
+            StopOutOfStep("expected a query result");
+        }
+    }
+
+    /*!
+     * Sends recorded inputs to their components until the next frame or query
+     * result. Returns false if the recording ran out or the replay was stopped.
+     */
+    bool Replay::SendRecordedInputs()
+    {
+        while (msMode == eModeReplaying && sReplayPos < sReplaySize)
+        {
+            const unsigned char type = spReplayData[sReplayPos];
+            if (type != eRecordStartPerformance && type != eRecordAnimationEvent && type != eRecordBehaviorEvent)
+            {
+                return true;
+            }
+            ++sReplayPos;
+
+            uint32 renID = 0;
+            if (!ReadBytes(&renID, sizeof(renID)))
+            {
+                break;
+            }
+
+            msbInjecting = true;
+            if (type == eRecordStartPerformance)
+            {
+                unsigned char size = 0;
+                ReplayParams params;
+                if (!ReadBytes(&size, sizeof(size)) || size > sizeof(params.mBytes) || !ReadBytes(params.mBytes, size))
+                {
+                    break;
+                }
+
+                EuphoriaComp* pEuphoriaComp = FindReplayComp(renID);
+                if (pEuphoriaComp != NULL)
+                {
+                    pEuphoriaComp->StartPerformance(*reinterpret_cast<const EuphoriaParamsBase*>(params.mBytes));
+                }
+            }
+            else
+            {
+                uint32 value = 0;
+                if (!ReadBytes(&value, sizeof(value)))
+                {
+                    break;
+                }
+
+                EuphoriaComp* pEuphoriaComp = FindReplayComp(renID);
+                if (pEuphoriaComp != NULL && type == eRecordAnimationEvent)
+                {
+                    pEuphoriaComp->HandleAnimationEvent(value);
+                }
+                else if (pEuphoriaComp != NULL)
+                {
+                    pEuphoriaComp->HandleBehaviorEvent(static_cast<BehaviorFeedback::BehaviorEventType>(value), NULL, NULL);
+                }
+            }
+            msbInjecting = false;
+        }
+        msbInjecting = false;
+
+        if (msMode == eModeReplaying && sReplayPos < sReplaySize)
+        {
+            StopOutOfStep("truncated input");
+        }
+        return false;
+    }
+
+    void Replay::StopOutOfStep(const char* pReason)
+    {
+        if (msMode == eModeReplaying)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaReplay: out of step at frame %u (%s), stopping\n", sReplayFrame, pReason);
+            Stop();
+        }
+    }
+
+    /*!
+     * Returns true if the message was a replay message. See the class comment.
+     */
+    bool Replay::HandleMessage(const char* msg)
+    {
+        static const char kPrefix[] = "EuphoriaReplay ";
+        if (strncmp(msg, kPrefix, sizeof(kPrefix) - 1) != 0)
+        {
+            return false;
+        }
+
+        const char* pCommand = msg + sizeof(kPrefix) - 1;
+        char path[256];
+        if (strcmp(pCommand, "stop") == 0)
+        {
+            Stop();
+        }
+        else if (sscanf(pCommand, "record %255s", path) == 1)
+        {
+            StartRecording(path);
+        }
+        else if (sscanf(pCommand, "play %255s", path) == 1)
+        {
+            StartReplay(path);
+        }
+        else
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaReplay: unknown command %s\n", pCommand);
+        }
+
+        return true;
+    }
+}
+
+// EUPHORIA_PROFILE_ENABLED
+#endif
@@ -0,0 +1,183 @@
+#ifndef EUPHORIA_REPLAY_H
+#define EUPHORIA_REPLAY_H
+
+#include "EuphoriaProfiler.h"
+
+#if EUPHORIA_PROFILE_ENABLED
+
+namespace euphoria
+{
+    /*!
+     * Records what enters the Euphoria layer to a binary stream, and plays it back.
+     *
+     * A recording holds, in the order they happened:
+     *  - one record per ThinkAll with its elapsed time
+     *  - performances started and animation/behavior events sent from outside the layer
+     *  - the result of each physics, edge and collision query (the EUPHORIA_COUNT sites)
+     *
+     * During playback, calls from the game into EuphoriaComp are dropped and the
+     * recorded ones are sent instead, and wrapped queries return their recorded
+     * results without calling the engine. Body part transforms, velocities and
+     * behavior start results still come from the engine interfaces, so a replay
+     * follows the recording only as long as those match; a query stream that runs
+     * out of step stops the replay. Components are looked up by RenID and must
+     * already exist.
+     *
+     * Recordings are only readable on a machine of the same endianness.
+     *
+     * Driven from EuphoriaManager::HandleMessage:
+     *
+     *   EuphoriaReplay record <path>
+     *   EuphoriaReplay play <path>
+     *   EuphoriaReplay stop
+     */
+    class Replay
+    {
+    public:
+        enum Mode
+        {
+            eModeOff,
+            eModeRecording,
+            eModeReplaying
+        };
+
+        static bool StartRecording(const char* pPath);
+        static bool StartReplay(const char* pPath);
+        static void Stop();
+        static inline bool IsRecording();
+        static inline bool IsReplaying();
+
+        // Inputs
+        static float BeginFrame(float elapsedTime);
+        static inline bool AcceptInput();
+        static void RecordStartPerformance(uint32 renID, const void* pParams, uint32 size);
+        static void RecordAnimationEvent(uint32 renID, uint32 eventNameCRC);
+        static void RecordBehaviorEvent(uint32 renID, uint32 eventType);
+
+        // Query results
+        template<class T> static inline T Write(T value);
+        template<class T> static inline T Read();
+        static void WriteResult(const void* pData, uint32 size);
+        static void ReadResult(void* pData, uint32 size);
+        static inline void SyncResult(void* pData, uint32 size);
+
+        static bool HandleMessage(const char* msg);
+
+    private:
+        // FRIEND DECLARATIONS
+        friend class ReplayInputScope;
+
+        static bool SendRecordedInputs();
+        static void StopOutOfStep(const char* pReason);
+
+        // STATIC MEMBERS
+        static Mode msMode;
+        static bool msbInjecting;
+        static uint32 msInputDepth;
+    };
+
+    /*!
+     * Marks a call into the layer. Only the outermost one is an input: calls the
+     * layer makes into itself (a performance starting another, ThinkAll running a
+     * component) are reproduced by replaying the input that caused them.
+     */
+    class ReplayInputScope
+    {
+    public:
+        // CREATORS
+        inline ReplayInputScope();
+        inline ~ReplayInputScope();
+
+        // ACCESSORS
+        inline bool IsOutermost() const;
+
+    private:
+        // MEMBERS
+        bool mbOutermost;
+
+        // NOT IMPLEMENTED
+        ReplayInputScope(const ReplayInputScope&);
+        ReplayInputScope& operator=(const ReplayInputScope&);
+    };
+
+    // INLINES
+    bool Replay::IsRecording()
+    {
+        return msMode == eModeRecording;
+    }
+
+    bool Replay::IsReplaying()
+    {
+        return msMode == eModeReplaying;
+    }
+
+    /*!
+     * False for inputs from the game while a replay is supplying them instead
+     */
+    bool Replay::AcceptInput()
+    {
+        return msMode != eModeReplaying || msbInjecting;
+    }
+
+    template<class T> T Replay::Write(T value)
+    {
+        if (msMode == eModeRecording)
+        {
+            WriteResult(&value, sizeof(value));
+        }
+        return value;
+    }
+
+    template<class T> T Replay::Read()
+    {
+        T value = T();
+        ReadResult(&value, sizeof(value));
+        return value;
+    }
+
+    void Replay::SyncResult(void* pData, uint32 size)
+    {
+        if (msMode == eModeRecording)
+        {
+            WriteResult(pData, size);
+        }
+        else if (msMode == eModeReplaying)
+        {
+            ReadResult(pData, size);
+        }
+    }
+
+    ReplayInputScope::ReplayInputScope()
+        : mbOutermost(Replay::msInputDepth == 0)
+    {
+        ++Replay::msInputDepth;
+    }
+
+    ReplayInputScope::~ReplayInputScope()
+    {
+        --Replay::msInputDepth;
+    }
+
+    bool ReplayInputScope::IsOutermost() const
+    {
+        return mbOutermost;
+    }
+}
+
+//! Evaluates to the query's result, recording it; while replaying the query is not made
+#define EUPHORIA_REPLAY_RESULT(Type, Expr) \
+    (euphoria::Replay::IsReplaying() ? euphoria::Replay::Read<Type>() : euphoria::Replay::Write<Type>(Expr))
+
+//! Records an out parameter of the last query, or restores it while replaying
+#define EUPHORIA_REPLAY_DATA(Var) \
+    euphoria::Replay::SyncResult(&(Var), sizeof(Var))
+
+#else
+
+#define EUPHORIA_REPLAY_RESULT(Type, Expr) (Expr)
+#define EUPHORIA_REPLAY_DATA(Var) ((void)0)
+
+#endif
+
+// EUPHORIA_REPLAY_H
+#endif
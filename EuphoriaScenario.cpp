@@ -0,0 +1,463 @@
+#include "EuphoriaScenario.h"
+
+#if EUPHORIA_PROFILE_ENABLED
+
+#include "BoneCRC.h"
+#include "EuphoriaComp.h"
+#include "EuphoriaManager.h"
+#include "EuphoriaParams.h"
+#include "LECLog.h"
+// Component Interfaces
+#include "FortuneGameCompPlugInInterface.h"
+#include "FortuneGamePlugInInterface.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace euphoria
+{
+    // USING DECLARATIONS
+    using lec::LecTraceChannel;
+    using namespace RavenMath;
+    using Ronin::EuphoriaComp;
+    using Ronin::gpEuphoriaManager;
+
+    // Define statics
+    bool Scenario::msbRunning = false;
+
+    // LOCAL CONST INITIALIZATION
+    namespace
+    {
+        enum ScenarioKind
+        {
+            eScenarioExplosion,
+            eScenarioLedge,
+            eScenarioGetup
+        };
+
+        /*!
+         * Placement is uniform over the ring between the radii. Each NPC starts on a
+         * frame picked uniformly from the spread, with a strength picked uniformly
+         * from the range: explosion velocity for getup (where it only has to knock
+         * them down), shove magnitude for ledge. The explosion scenario draws one
+         * velocity for the whole blast.
+         */
+        struct ScenarioDesc
+        {
+            const char* mpName;
+            ScenarioKind mKind;
+            float mMinRadius;
+            float mMaxRadius;
+            uint32 mSpreadFrames;
+            uint32 mGetupFrame;             //!< getup only: when every blend starts
+            uint32 mDurationFrames;
+            float mMinStrength;
+            float mMaxStrength;
+        };
+
+        const ScenarioDesc kScenarios[] =
+        {
+            { "explosion", eScenarioExplosion, 1.0f, 8.0f, 0, 0, 300, 8.0f, 20.0f },
+            { "ledge", eScenarioLedge, 4.0f, 5.0f, 15, 0, 300, 300.0f, 600.0f },
+            { "getup", eScenarioGetup, 0.5f, 6.0f, 0, 90, 300, 2.0f, 4.0f }
+        };
+        const uint32 kNumScenarios = sizeof(kScenarios) / sizeof(kScenarios[0]);
+
+        const float kScenarioSourceMass = 50.0f;
+        const uint32 kDefaultScenarioCount = 100;
+        //! Explode finds its targets in the spatial hash, which sees the placement after one ThinkAll
+        const uint32 kScenarioExplosionFrame = 1;
+
+        //! The EUPHORIA_COUNT counters that are engine queries
+        const ProfileCounter kScenarioQueryCounters[] =
+        {
+            eCountCheckLOS,
+            eCountRayCastClosest,
+            eCountIsSupported,
+            eCountFindEdgesInRadius,
+            eCountDistanceToEdge
+        };
+        const uint32 kNumScenarioQueryCounters = sizeof(kScenarioQueryCounters) / sizeof(kScenarioQueryCounters[0]);
+
+        struct ScenarioActor
+        {
+            Ronin::RenID mRenID;
+            Vec3 mPosition;
+            uint32 mStartFrame;
+            float mStrength;
+            bool mbStarted;
+        };
+
+        const ScenarioDesc* spScenario = NULL;
+        ScenarioActor sScenarioActors[Scenario::kMaxActors];
+        uint32 sNumScenarioActors = 0;
+        Vec3 sAnchorPosition;
+        uint32 sScenarioRandom = 0;
+
+        // Per frame results
+        uint32 sScenarioFrame = 0;
+        ProfileTicks sFrameStartTicks = 0;
+        uint32 sRefusedThisFrame = 0;
+        uint32 sFrameMicroseconds[Scenario::kMaxFrames];
+        uint32 sPeakQueries = 0;
+        uint32 sPeakQueriesFrame = 0;
+        uint32 sPeakDemand = 0;
+        uint32 sPeakDemandFrame = 0;
+        uint32 sTotalRefused = 0;
+
+        //! LCG from Numerical Recipes; only needs to be the same everywhere
+        float ScenarioRandom()
+        {
+            sScenarioRandom = sScenarioRandom * 1664525u + 1013904223u;
+            return static_cast<float>(sScenarioRandom >> 8) * (1.0f / 16777216.0f);
+        }
+
+        float ScenarioRandomRange(float min, float max)
+        {
+            return min + (max - min) * ScenarioRandom();
+        }
+
+        void PlaceActor(ScenarioActor& rActor)
+        {
+            // Uniform over the area of the ring
+            const float minSq = spScenario->mMinRadius * spScenario->mMinRadius;
+            const float maxSq = spScenario->mMaxRadius * spScenario->mMaxRadius;
+            const float radius = Sqrt(ScenarioRandomRange(minSq, maxSq));
+            const float angle = DegToRad(ScenarioRandomRange(0.0f, 360.0f));
+
+            Vec3Set(rActor.mPosition, sAnchorPosition);
+            rActor.mPosition.x += radius * Cosine(angle);
+            rActor.mPosition.z += radius * Sine(angle);
+
+            Mat44 transform;
+            Mat44SetIdentity(transform);
+            Vec3Set(ROW_TRANSLATION(transform), rActor.mPosition);
+            gpEuphoriaManager->GetFortuneGamePlugIn()->GetRenInterface()->RenSetMatrix(rActor.mRenID, transform);
+        }
+
+        void StartActor(ScenarioActor& rActor)
+        {
+            rActor.mbStarted = true;
+
+            EuphoriaComp* pEuphoriaComp = gpEuphoriaManager->GetEuphoriaComp(rActor.mRenID);
+            if (pEuphoriaComp == NULL)
+            {
+                return;
+            }
+
+            if (spScenario->mKind == eScenarioLedge)
+            {
+                // Outwards, away from the anchor
+                ShoveParams params;
+                Vec3Sub(params.mForceNormal, rActor.mPosition, sAnchorPosition);
+                params.mForceNormal.y = 0.0f;
+                Vec3NormalizeSafe(params.mForceNormal, params.mForceNormal, kVecUnitY);
+                params.mForceMagnitude = rActor.mStrength;
+                params.mImpactBone = BoneCRC::eSpine3;
+                pEuphoriaComp->StartPerformance(params);
+            }
+            else
+            {
+                // Knocked down and kept down until StartGetups
+                pEuphoriaComp->DisableRecovery();
+
+                ExplosionParams params;
+                Vec3Set(params.mSourcePos, sAnchorPosition);
+                Vec3Set(params.mNormal, kVecUnitY);
+                params.mSourceMass = kScenarioSourceMass;
+                params.mVelocity = rActor.mStrength;
+                pEuphoriaComp->StartPerformance(params);
+            }
+
+            if (!pEuphoriaComp->IsEuphoriaActive() && !pEuphoriaComp->IsStartPending())
+            {
+                ++sRefusedThisFrame;
+            }
+        }
+
+        /*!
+         * One blast at the anchor, through the same call gameplay uses
+         */
+        void StartExplosion()
+        {
+            const float velocity = ScenarioRandomRange(spScenario->mMinStrength, spScenario->mMaxStrength);
+            const uint32 numReached = gpEuphoriaManager->Explode(sAnchorPosition, kScenarioSourceMass, velocity, spScenario->mMaxRadius + 1.0f, Ronin::RenID_NULL);
+
+            for (uint32 i = 0; i < sNumScenarioActors; ++i)
+            {
+                ScenarioActor& rActor = sScenarioActors[i];
+                rActor.mbStarted = true;
+
+                const EuphoriaComp* pEuphoriaComp = gpEuphoriaManager->GetEuphoriaComp(rActor.mRenID);
+                if (pEuphoriaComp != NULL && !pEuphoriaComp->IsEuphoriaActive() && !pEuphoriaComp->IsStartPending())
+                {
+                    ++sRefusedThisFrame;
+                }
+            }
+
+            if (numReached < sNumScenarioActors)
+            {
+                LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaScenario: the explosion reached %u of %u NPCs\n", numReached, sNumScenarioActors);
+            }
+        }
+
+        void StartGetups()
+        {
+            for (uint32 i = 0; i < sNumScenarioActors; ++i)
+            {
+                EuphoriaComp* pEuphoriaComp = gpEuphoriaManager->GetEuphoriaComp(sScenarioActors[i].mRenID);
+                if (pEuphoriaComp == NULL)
+                {
+                    continue;
+                }
+
+                if (pEuphoriaComp->IsEuphoriaActive())
+                {
+                    BlendParams params;
+                    params.mInitialPosition = pEuphoriaComp->DetermineGetupPosition();
+                    pEuphoriaComp->StartPerformance(params);
+                }
+                pEuphoriaComp->EnableRecovery();
+            }
+        }
+
+        int CompareFrameTimes(const void* pA, const void* pB)
+        {
+            const uint32 a = *static_cast<const uint32*>(pA);
+            const uint32 b = *static_cast<const uint32*>(pB);
+            return (a < b) ? -1 : ((a > b) ? 1 : 0);
+        }
+
+        void ReportScenario()
+        {
+            const uint32 numFrames = sScenarioFrame;
+            if (numFrames == 0)
+            {
+                return;
+            }
+
+            qsort(sFrameMicroseconds, numFrames, sizeof(sFrameMicroseconds[0]), CompareFrameTimes);
+
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaScenario: %s, %u NPCs, %u frames\n", spScenario->mpName, sNumScenarioActors, numFrames);
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaScenario:   ThinkAll p50 %u  p95 %u  p99 %u  max %u us\n",
+                       sFrameMicroseconds[numFrames / 2], sFrameMicroseconds[(numFrames * 95) / 100],
+                       sFrameMicroseconds[(numFrames * 99) / 100], sFrameMicroseconds[numFrames - 1]);
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaScenario:   peak queries %u/frame (frame %u)\n", sPeakQueries, sPeakQueriesFrame);
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaScenario:   peak agent demand %u (frame %u), %u starts refused\n", sPeakDemand, sPeakDemandFrame, sTotalRefused);
+        }
+    }
+
+    /*!
+     * Takes up to count NPCs other than the anchor, places them and schedules their
+     * starts. The first starts go out on the next ThinkAll.
+     */
+    bool Scenario::Start(const char* pName, Ronin::RenID anchor, uint32 count, uint32 seed)
+    {
+        Stop();
+
+        const ScenarioDesc* pScenario = NULL;
+        for (uint32 i = 0; i < kNumScenarios; ++i)
+        {
+            if (strcmp(pName, kScenarios[i].mpName) == 0)
+            {
+                pScenario = &kScenarios[i];
+            }
+        }
+        if (pScenario == NULL)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaScenario: no scenario called %s\n", pName);
+            return false;
+        }
+        if (anchor == Ronin::RenID_NULL)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaScenario: target a Ren to place the NPCs around\n");
+            return false;
+        }
+
+        spScenario = pScenario;
+        sScenarioRandom = seed;
+        Vec3Set_UA(sAnchorPosition, gpEuphoriaManager->GetFortuneGamePlugIn()->GetRenInterface()->RenGetPosition(anchor));
+
+        count = (count > kMaxActors) ? kMaxActors : count;
+        if (spScenario->mKind == eScenarioExplosion && count > Ronin::EuphoriaManager::kMaxExplosionTargets)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaScenario: one explosion starts at most %d NPCs, using that many\n", Ronin::EuphoriaManager::kMaxExplosionTargets);
+            count = Ronin::EuphoriaManager::kMaxExplosionTargets;
+        }
+
+        sNumScenarioActors = 0;
+        const uint32 numComps = gpEuphoriaManager->GetNumEuphoriaComps();
+        for (uint32 comp = 0; comp < numComps && sNumScenarioActors < count; ++comp)
+        {
+            EuphoriaComp* pEuphoriaComp = gpEuphoriaManager->GetEuphoriaCompAt(comp);
+            if (pEuphoriaComp->GetRenID() == anchor)
+            {
+                continue;
+            }
+
+            ScenarioActor& rActor = sScenarioActors[sNumScenarioActors++];
+            rActor.mRenID = pEuphoriaComp->GetRenID();
+            rActor.mStartFrame = static_cast<uint32>(ScenarioRandom() * static_cast<float>(spScenario->mSpreadFrames + 1));
+            rActor.mStartFrame = (rActor.mStartFrame > spScenario->mSpreadFrames) ? spScenario->mSpreadFrames : rActor.mStartFrame;
+            rActor.mStrength = ScenarioRandomRange(spScenario->mMinStrength, spScenario->mMaxStrength);
+            rActor.mbStarted = false;
+            PlaceActor(rActor);
+        }
+        // The placed NPCs are idle, so have the hash pick up where they are now
+        gpEuphoriaManager->RefreshSpatialHash();
+
+        sScenarioFrame = 0;
+        sPeakQueries = 0;
+        sPeakQueriesFrame = 0;
+        sPeakDemand = 0;
+        sPeakDemandFrame = 0;
+        sTotalRefused = 0;
+        msbRunning = true;
+
+        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaScenario: %s with %u NPCs, seed %u\n", pName, sNumScenarioActors, seed);
+        if (sNumScenarioActors < count)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaScenario: only %u NPCs in the level\n", sNumScenarioActors);
+        }
+        return true;
+    }
+
+    /*!
+     * Reports what has been gathered so far and hands the NPCs back
+     */
+    void Scenario::Stop()
+    {
+        if (!msbRunning)
+        {
+            return;
+        }
+        msbRunning = false;
+
+        ReportScenario();
+
+        if (spScenario->mKind == eScenarioGetup)
+        {
+            for (uint32 i = 0; i < sNumScenarioActors; ++i)
+            {
+                EuphoriaComp* pEuphoriaComp = gpEuphoriaManager->GetEuphoriaComp(sScenarioActors[i].mRenID);
+                if (pEuphoriaComp != NULL)
+                {
+                    pEuphoriaComp->EnableRecovery();
+                }
+            }
+        }
+        sNumScenarioActors = 0;
+    }
+
+    /*!
+     * Called from ThinkAll before the components think
+     */
+    void Scenario::BeginFrame()
+    {
+        sFrameStartTicks = Profiler::ReadTicks();
+        sRefusedThisFrame = 0;
+
+        if (spScenario->mKind == eScenarioExplosion)
+        {
+            if (sScenarioFrame == kScenarioExplosionFrame)
+            {
+                StartExplosion();
+            }
+        }
+        else
+        {
+            for (uint32 i = 0; i < sNumScenarioActors; ++i)
+            {
+                ScenarioActor& rActor = sScenarioActors[i];
+                if (!rActor.mbStarted && sScenarioFrame >= rActor.mStartFrame)
+                {
+                    StartActor(rActor);
+                }
+            }
+        }
+
+        if (spScenario->mKind == eScenarioGetup && sScenarioFrame == spScenario->mGetupFrame)
+        {
+            StartGetups();
+        }
+    }
+
+    /*!
+     * Called from ThinkAll after Profiler::EndFrame, so the frame's counts are in
+     */
+    void Scenario::EndFrame()
+    {
+        sFrameMicroseconds[sScenarioFrame] = Profiler::TicksToMicroseconds(Profiler::ReadTicks() - sFrameStartTicks);
+
+        uint32 queries = 0;
+        for (const ProfileSlot* pSlot = ProfileSlot::GetFirst(); pSlot != NULL; pSlot = pSlot->GetNext())
+        {
+            for (uint32 c = 0; c < kNumScenarioQueryCounters; ++c)
+            {
+                queries += pSlot->GetLastFrameCount(kScenarioQueryCounters[c]);
+            }
+        }
+        if (queries > sPeakQueries)
+        {
+            sPeakQueries = queries;
+            sPeakQueriesFrame = sScenarioFrame;
+        }
+
+        uint32 demand = sRefusedThisFrame;
+        for (uint32 i = 0; i < sNumScenarioActors; ++i)
+        {
+            const EuphoriaComp* pEuphoriaComp = gpEuphoriaManager->GetEuphoriaComp(sScenarioActors[i].mRenID);
+            if (pEuphoriaComp != NULL && (pEuphoriaComp->IsEuphoriaActive() || pEuphoriaComp->IsStartPending()))
+            {
+                ++demand;
+            }
+        }
+        if (demand > sPeakDemand)
+        {
+            sPeakDemand = demand;
+            sPeakDemandFrame = sScenarioFrame;
+        }
+        sTotalRefused += sRefusedThisFrame;
+
+        ++sScenarioFrame;
+        if (sScenarioFrame >= spScenario->mDurationFrames || sScenarioFrame >= kMaxFrames)
+        {
+            Stop();
+        }
+    }
+
+    /*!
+     * Returns true if the message was a scenario message. See the class comment.
+     */
+    bool Scenario::HandleMessage(const char* msg, Ronin::RenID target)
+    {
+        static const char kPrefix[] = "EuphoriaScenario ";
+        if (strncmp(msg, kPrefix, sizeof(kPrefix) - 1) != 0)
+        {
+            return false;
+        }
+
+        const char* pCommand = msg + sizeof(kPrefix) - 1;
+        char name[32];
+        uint32 count = kDefaultScenarioCount;
+        uint32 seed = 1;
+        if (strcmp(pCommand, "stop") == 0)
+        {
+            Stop();
+        }
+        else if (sscanf(pCommand, "%31s %u %u", name, &count, &seed) >= 1)
+        {
+            Start(name, target, count, seed);
+        }
+        else
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaScenario: unknown command %s\n", pCommand);
+        }
+
+        return true;
+    }
+}
+
+// EUPHORIA_PROFILE_ENABLED
+#endif
@@ -0,0 +1,72 @@
+#ifndef EUPHORIA_SCENARIO_H
+#define EUPHORIA_SCENARIO_H
+
+#include "EuphoriaProfiler.h"
+
+#if EUPHORIA_PROFILE_ENABLED
+
+#include "Rens/RenTypes.h"
+
+namespace euphoria
+{
+    /*!
+     * Scripted mass reactions for finding where the layer stops scaling. A scenario
+     * takes the NPCs already in the level, teleports them around an anchor Ren (the
+     * message target), and starts performances on them on a seeded schedule, so the
+     * same seed gives the same placement, timing and parameters every time.
+     *
+     *   explosion  NPCs on a disc around the anchor, one EuphoriaManager::Explode
+     *              at the anchor hits them all in the same frame. The count is
+     *              capped at the most NPCs one Explode can start.
+     *   ledge      NPCs on a ring around the anchor, shoved outwards over the frame
+     *              spread. Put the anchor in the middle of a raised platform so the
+     *              shove carries them off the edge into Falling and grabbing.
+     *   getup      NPCs on a disc around the anchor are knocked down with recovery
+     *              off, then all start their getup Blend in the same frame. Put the
+     *              anchor near walls to stress the getup line-of-sight checks.
+     *
+     * While a scenario runs, each ThinkAll is timed and the frame's queries (the
+     * EUPHORIA_COUNT query counters, summed over every slot) and agent demand (NPCs
+     * holding or queued for an agent, plus starts refused for lack of one) are kept. The report at
+     * the end gives frame time percentiles and the peaks.
+     *
+     * Driven from EuphoriaManager::HandleMessage, targeting the anchor:
+     *
+     *   EuphoriaScenario <explosion|ledge|getup> [count] [seed]
+     *   EuphoriaScenario stop
+     */
+    class Scenario
+    {
+    public:
+        enum
+        {
+            kMaxActors = 256,
+            kMaxFrames = 1800
+        };
+
+        static bool Start(const char* pName, Ronin::RenID anchor, uint32 count, uint32 seed);
+        static void Stop();
+        static inline bool IsRunning();
+
+        static void BeginFrame();
+        static void EndFrame();
+
+        static bool HandleMessage(const char* msg, Ronin::RenID target);
+
+    private:
+        // STATIC MEMBERS
+        static bool msbRunning;
+    };
+
+    // INLINES
+    bool Scenario::IsRunning()
+    {
+        return msbRunning;
+    }
+}
+
+// EUPHORIA_PROFILE_ENABLED
+#endif
+
+// EUPHORIA_SCENARIO_H
+#endif
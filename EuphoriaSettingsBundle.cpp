@@ -0,0 +1,190 @@
+#include "EuphoriaSettingsBundle.h"
+
+#if defined(PLATFORM_WINDOWS)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+namespace euphoria
+{
+    // USING DECLARATIONS
+    using lec::LecTraceChannel;
+
+    SettingsBundle::SettingsBundle()
+        : mpHeader(NULL), mpRecords(NULL), mpBlendProfiles(NULL), mpData(NULL), mpFileHandle(NULL), mpMappingHandle(NULL)
+    {
+    }
+
+    SettingsBundle::~SettingsBundle()
+    {
+        Close();
+    }
+
+    /*!
+     * Maps the bundle at pPath. Returns false, leaving the bundle closed, if the
+     * file is missing or was built for a different layout; the caller is
+     * expected to fall back to the per-actor settings assets.
+     *
+     * @note Only Windows maps files here. Other platforms have no file access
+     *       in this plugin, the game supplies the bundle with Attach instead.
+     */
+    bool SettingsBundle::Open(const char* pPath)
+    {
+        Close();
+
+#if defined(PLATFORM_WINDOWS)
+        HANDLE hFile = CreateFileA(pPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (hFile == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        mpFileHandle = hFile;
+
+        uint32 fileSize = static_cast<uint32>(GetFileSize(hFile, NULL));
+        HANDLE hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (hMapping == NULL)
+        {
+            Close();
+            return false;
+        }
+        mpMappingHandle = hMapping;
+
+        mpData = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+
+        if (mpData == NULL || !Validate(fileSize))
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Euphoria settings bundle %s is out of date, ignoring it\n", pPath);
+            Close();
+            return false;
+        }
+
+        return true;
+#else
+        LECUNUSED(pPath);
+        return false;
+#endif
+    }
+
+    /*!
+     * Uses a bundle the game has already loaded, in place. The game owns pData
+     * and must keep it alive until Close. Returns false, leaving the bundle
+     * closed, if it was built for a different layout.
+     */
+    bool SettingsBundle::Attach(const void* pData, uint32 size)
+    {
+        Close();
+
+        mpData = const_cast<void*>(pData);
+        if (mpData == NULL || !Validate(size))
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Euphoria settings bundle is out of date, ignoring it\n");
+            mpData = NULL;
+            Close();
+            return false;
+        }
+
+        return true;
+    }
+
+    /*!
+     * Releases the mapping, or lets go of an attached bundle. Any record pointers
+     * handed out are invalid afterwards.
+     */
+    void SettingsBundle::Close()
+    {
+#if defined(PLATFORM_WINDOWS)
+        // Attached bundles have no mapping and belong to the game
+        if (mpData != NULL && mpMappingHandle != NULL)
+        {
+            UnmapViewOfFile(mpData);
+        }
+        if (mpMappingHandle != NULL)
+        {
+            CloseHandle(static_cast<HANDLE>(mpMappingHandle));
+        }
+        if (mpFileHandle != NULL)
+        {
+            CloseHandle(static_cast<HANDLE>(mpFileHandle));
+        }
+#endif
+
+        mpHeader = NULL;
+        mpRecords = NULL;
+        mpBlendProfiles = NULL;
+        mpData = NULL;
+        mpFileHandle = NULL;
+        mpMappingHandle = NULL;
+    }
+
+    /*!
+     * Checks the header against this build and sets up the record pointer.
+     */
+    bool SettingsBundle::Validate(uint32 fileSize)
+    {
+        if (fileSize < sizeof(Header))
+        {
+            return false;
+        }
+
+        const Header* pHeader = static_cast<const Header*>(mpData);
+        if (pHeader->mMagic != Header::kMagic ||
+            pHeader->mVersion != Header::kVersion ||
+            pHeader->mRecordSize != sizeof(ArchetypeSettingsRecord) ||
+            pHeader->mBlendProfileSize != sizeof(BlendProfile) ||
+            (pHeader->mNumBlendProfiles != 0 && pHeader->mNumBlendProfiles != eNumGetups))
+        {
+            return false;
+        }
+
+        const uint32 recordsSize = pHeader->mNumArchetypes * sizeof(ArchetypeSettingsRecord);
+        if (fileSize < sizeof(Header) + recordsSize + pHeader->mNumBlendProfiles * sizeof(BlendProfile))
+        {
+            return false;
+        }
+
+        mpHeader = pHeader;
+        mpRecords = reinterpret_cast<const ArchetypeSettingsRecord*>(pHeader + 1);
+        if (pHeader->mNumBlendProfiles != 0)
+        {
+            mpBlendProfiles = reinterpret_cast<const BlendProfile*>(reinterpret_cast<const char*>(mpRecords) + recordsSize);
+        }
+        return true;
+    }
+
+    /*!
+     * Returns the settings for an archetype, or NULL if the bundle does not have
+     * them. The record points straight into the bundle.
+     */
+    const ArchetypeSettingsRecord* SettingsBundle::Find(uint32 archetypeKey) const
+    {
+        if (mpRecords == NULL)
+        {
+            return NULL;
+        }
+
+        // Records are sorted by key
+        uint32 low = 0;
+        uint32 high = mpHeader->mNumArchetypes;
+        while (low < high)
+        {
+            uint32 mid = (low + high) / 2;
+            if (mpRecords[mid].mArchetypeKey < archetypeKey)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+
+        if (low < mpHeader->mNumArchetypes && mpRecords[low].mArchetypeKey == archetypeKey)
+        {
+            return &mpRecords[low];
+        }
+
+        return NULL;
+    }
+}
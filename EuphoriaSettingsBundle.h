@@ -0,0 +1,107 @@
+#ifndef EUPHORIA_SETTINGS_BUNDLE_H
+#define EUPHORIA_SETTINGS_BUNDLE_H
+
+#include "RoninConfig.h"
+#include "EuphoriaParams.h"
+
+#ifndef EUPHORIA_SETTINGS_BUNDLE_PATH
+#define EUPHORIA_SETTINGS_BUNDLE_PATH "Data/Euphoria/PerformanceSettings.bin"
+#endif
+
+namespace euphoria
+{
+    /*!
+     * Recovery settings for one performance, as stored in the bundle
+     */
+    struct PerformanceSettingsRecord
+    {
+        float mStationarySpeedThreshold;
+        float mStationaryWaitTime;
+    };
+
+    /*!
+     * All performance settings for one archetype, indexed by ePerformanceType
+     */
+    struct ArchetypeSettingsRecord
+    {
+        uint32 mArchetypeKey;                                   //!< AssetKey of the archetype's DefEuphoriaPerformanceSettings
+        PerformanceSettingsRecord mPerformances[eSize];
+    };
+
+    /*!
+     * Prebuilt bundle of every archetype's performance settings. The file is a
+     * SettingsBundleHeader followed by mNumArchetypes records sorted by key, then
+     * mNumBlendProfiles getup blend profiles (none, or one per GetupPosition). It
+     * is used in place: on Windows Open memory maps it, elsewhere the game loads
+     * it through its file system and hands it over with Attach. Actors look their
+     * archetype up at spawn with a binary search instead of loading and locking a
+     * settings asset each.
+     */
+    class SettingsBundle
+    {
+    public:
+        struct Header
+        {
+            enum
+            {
+                kMagic = 0x53505545,                            // 'EUPS'
+                kVersion = 2
+            };
+
+            uint32 mMagic;
+            uint32 mVersion;
+            uint32 mNumArchetypes;
+            uint32 mRecordSize;                                 //!< sizeof(ArchetypeSettingsRecord) when the bundle was built
+            uint32 mNumBlendProfiles;                           //!< 0, or eNumGetups
+            uint32 mBlendProfileSize;                           //!< sizeof(BlendProfile) when the bundle was built
+        };
+
+    private:
+        // MEMBERS
+        const Header* mpHeader;
+        const ArchetypeSettingsRecord* mpRecords;
+        const BlendProfile* mpBlendProfiles;
+        void* mpData;
+        void* mpFileHandle;
+        void* mpMappingHandle;
+
+        // NOT IMPLEMENTED
+        SettingsBundle(const SettingsBundle&);
+        SettingsBundle& operator=(const SettingsBundle&);
+
+        // METHODS
+        bool Validate(uint32 fileSize);
+
+    public:
+        // CREATORS
+        SettingsBundle();
+        ~SettingsBundle();
+
+        // MANIPULATORS
+        bool Open(const char* pPath);
+        bool Attach(const void* pData, uint32 size);
+        void Close();
+
+        // ACCESSORS
+        inline bool IsOpen() const;
+        const ArchetypeSettingsRecord* Find(uint32 archetypeKey) const;
+        inline const BlendProfile* GetBlendProfiles() const;
+    };
+
+    // INLINES
+    bool SettingsBundle::IsOpen() const
+    {
+        return (mpRecords != NULL);
+    }
+
+    /*!
+     * The bundle's getup tuning, indexed by GetupPosition, or NULL if it has none
+     */
+    const BlendProfile* SettingsBundle::GetBlendProfiles() const
+    {
+        return mpBlendProfiles;
+    }
+}
+
+// EUPHORIA_SETTINGS_BUNDLE_H
+#endif
@@ -0,0 +1,297 @@
+#include "EuphoriaSpatialHash.h"
+#include "LECLog.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace euphoria
+{
+    // USING DECLARATIONS
+    using lec::LecTraceChannel;
+    using namespace RavenMath;
+
+    // LOCAL CONST INITIALIZATION
+    namespace
+    {
+        const float kSpatialDefaultCellSize = 10.0f;
+        const float kSpatialMinCellSize = 1.0f;
+        const float kSpatialMoveEpsilon = 0.01f;        //!< Smaller moves leave the slot, and the built hash, alone
+    }
+
+    SpatialHash::SpatialHash()
+        : mNumStaged(0), mRefreshPhase(0), mbIsDirty(false), mbRefreshAll(false), mNumEntries(0), mfCellSize(kSpatialDefaultCellSize),
+          mfInvCellSize(1.0f / kSpatialDefaultCellSize), mfPendingCellSize(kSpatialDefaultCellSize), mNumDropped(0)
+    {
+        memset(mBucketStart, 0, sizeof(mBucketStart));
+    }
+
+    /*!
+     * Stages the component in slot at position for the next Build. Slots are
+     * filled in order, so a new one is always the next past the end.
+     */
+    void SpatialHash::Update(uint32 slot, Ronin::RenID renID, const Vec3& position)
+    {
+        if (slot >= kMaxEntries)
+        {
+            if (mNumDropped++ == 0)
+            {
+                LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaSpatial: more than %d NPCs, the rest are missed by area queries\n", kMaxEntries);
+            }
+            return;
+        }
+
+        LECASSERT(slot <= mNumStaged);
+        if (slot == mNumStaged)
+        {
+            ++mNumStaged;
+        }
+        else if (mStagedRenIDs[slot] == renID && Vec3DistSqr(mStagedPositions[slot], position) < kSpatialMoveEpsilon * kSpatialMoveEpsilon)
+        {
+            return;
+        }
+
+        mStagedRenIDs[slot] = renID;
+        Vec3Set(mStagedPositions[slot], position);
+        mbIsDirty = true;
+    }
+
+    /*!
+     * Replaces the hash with the first numSlots staged slots, if any of them
+     * have changed. Slots past numSlots belonged to components since destroyed.
+     */
+    void SpatialHash::Build(uint32 numSlots)
+    {
+        ++mRefreshPhase;
+        mbRefreshAll = false;
+        if (numSlots < mNumStaged)
+        {
+            mNumStaged = numSlots;
+            mbIsDirty = true;
+        }
+        if (!mbIsDirty && mfPendingCellSize == mfCellSize)
+        {
+            return;
+        }
+
+        mfCellSize = mfPendingCellSize;
+        mfInvCellSize = 1.0f / mfCellSize;
+
+        uint32 counts[kNumBuckets];
+        memset(counts, 0, sizeof(counts));
+        for (uint32 i = 0; i < mNumStaged; ++i)
+        {
+            mStagedBuckets[i] = BucketOf(CellOf(mStagedPositions[i].x), CellOf(mStagedPositions[i].z));
+            ++counts[mStagedBuckets[i]];
+        }
+
+        uint32 start = 0;
+        for (uint32 bucket = 0; bucket < kNumBuckets; ++bucket)
+        {
+            mBucketStart[bucket] = start;
+            start += counts[bucket];
+            counts[bucket] = mBucketStart[bucket];
+        }
+        mBucketStart[kNumBuckets] = start;
+
+        for (uint32 i = 0; i < mNumStaged; ++i)
+        {
+            const uint32 slot = counts[mStagedBuckets[i]]++;
+            mRenIDs[slot] = mStagedRenIDs[i];
+            mPosX[slot] = mStagedPositions[i].x;
+            mPosY[slot] = mStagedPositions[i].y;
+            mPosZ[slot] = mStagedPositions[i].z;
+        }
+
+        mNumEntries = mNumStaged;
+        mbIsDirty = false;
+    }
+
+    /*!
+     * Drops a destroyed component from the built hash, and moves the last
+     * staged slot into its slot as the manager does with its hot record
+     */
+    void SpatialHash::Remove(Ronin::RenID renID, uint32 slot)
+    {
+        for (uint32 i = 0; i < mNumEntries; ++i)
+        {
+            if (mRenIDs[i] == renID)
+            {
+                mRenIDs[i] = Ronin::RenID_NULL;
+            }
+        }
+
+        // A component created this frame has no slot yet
+        if (slot < mNumStaged)
+        {
+            const uint32 last = --mNumStaged;
+            mStagedRenIDs[slot] = mStagedRenIDs[last];
+            Vec3Set(mStagedPositions[slot], mStagedPositions[last]);
+            mbIsDirty = true;
+        }
+    }
+
+    /*!
+     * Empties the hash, for when every component goes at once
+     */
+    void SpatialHash::Clear()
+    {
+        mNumStaged = 0;
+        mNumEntries = 0;
+        memset(mBucketStart, 0, sizeof(mBucketStart));
+        mbIsDirty = false;
+        mbRefreshAll = false;
+    }
+
+    /*!
+     * Finds the slots of the built entries within radius of centre. Returns how
+     * many were written to pOutSlots, at most maxResults.
+     *
+     * @note A bucket can be shared by several cells, so each entry is also checked
+     *       against the cell being visited; that keeps results unique.
+     */
+    uint32 SpatialHash::GatherSlots(const Vec3& centre, float radius, uint32* pOutSlots, uint32 maxResults) const
+    {
+        const float radiusSq = radius * radius;
+        const int minX = CellOf(centre.x - radius);
+        const int maxX = CellOf(centre.x + radius);
+        const int minZ = CellOf(centre.z - radius);
+        const int maxZ = CellOf(centre.z + radius);
+        uint32 numResults = 0;
+
+        // Covering more cells than there are buckets, a straight scan is cheaper
+        if (static_cast<uint32>(maxX - minX + 1) * static_cast<uint32>(maxZ - minZ + 1) >= kNumBuckets)
+        {
+            for (uint32 i = 0; i < mNumEntries && numResults < maxResults; ++i)
+            {
+                const float dx = mPosX[i] - centre.x;
+                const float dy = mPosY[i] - centre.y;
+                const float dz = mPosZ[i] - centre.z;
+                if (mRenIDs[i] != Ronin::RenID_NULL && dx * dx + dy * dy + dz * dz <= radiusSq)
+                {
+                    pOutSlots[numResults++] = i;
+                }
+            }
+            return numResults;
+        }
+
+        for (int cellX = minX; cellX <= maxX; ++cellX)
+        {
+            for (int cellZ = minZ; cellZ <= maxZ; ++cellZ)
+            {
+                const uint32 bucket = BucketOf(cellX, cellZ);
+                for (uint32 i = mBucketStart[bucket]; i < mBucketStart[bucket + 1]; ++i)
+                {
+                    const float dx = mPosX[i] - centre.x;
+                    const float dy = mPosY[i] - centre.y;
+                    const float dz = mPosZ[i] - centre.z;
+                    if (mRenIDs[i] == Ronin::RenID_NULL || dx * dx + dy * dy + dz * dz > radiusSq ||
+                        CellOf(mPosX[i]) != cellX || CellOf(mPosZ[i]) != cellZ)
+                    {
+                        continue;
+                    }
+                    if (numResults == maxResults)
+                    {
+                        return numResults;
+                    }
+                    pOutSlots[numResults++] = i;
+                }
+            }
+        }
+        return numResults;
+    }
+
+    /*!
+     * Finds the components within radius of centre. Returns how many were
+     * written to pOutRenIDs, at most maxResults.
+     */
+    uint32 SpatialHash::QueryRadius(const Vec3& centre, float radius, Ronin::RenID* pOutRenIDs, uint32 maxResults) const
+    {
+        uint32 slots[kMaxEntries];
+        const uint32 numResults = GatherSlots(centre, radius, slots, (maxResults < kMaxEntries) ? maxResults : static_cast<uint32>(kMaxEntries));
+        for (uint32 i = 0; i < numResults; ++i)
+        {
+            pOutRenIDs[i] = mRenIDs[slots[i]];
+        }
+        return numResults;
+    }
+
+    /*!
+     * Finds the components within range of apex and inside the cone around
+     * direction (a unit vector) whose half angle has cosine cosHalfAngle
+     */
+    uint32 SpatialHash::QueryCone(const Vec3& apex, const Vec3& direction, float cosHalfAngle, float range, Ronin::RenID* pOutRenIDs, uint32 maxResults) const
+    {
+        // A narrow cone fits in a smaller sphere centred halfway along its axis
+        Vec3 centre;
+        Vec3Set(centre, apex);
+        float radius = range;
+        if (cosHalfAngle > 0.25f)
+        {
+            Vec3AddScaled(centre, apex, direction, 0.5f * range);
+            radius = range * Sqrt(1.25f - cosHalfAngle);
+        }
+
+        uint32 slots[kMaxEntries];
+        const uint32 numCandidates = GatherSlots(centre, radius, slots, kMaxEntries);
+
+        const float rangeSq = range * range;
+        const float cosSq = cosHalfAngle * cosHalfAngle;
+        uint32 numResults = 0;
+        for (uint32 i = 0; i < numCandidates && numResults < maxResults; ++i)
+        {
+            const uint32 slot = slots[i];
+            const float dx = mPosX[slot] - apex.x;
+            const float dy = mPosY[slot] - apex.y;
+            const float dz = mPosZ[slot] - apex.z;
+            const float distSq = dx * dx + dy * dy + dz * dz;
+            const float along = dx * direction.x + dy * direction.y + dz * direction.z;
+
+            // Compared squared, so the sign of both sides has to be handled
+            const bool bInCone = (cosHalfAngle >= 0.0f) ? (along >= 0.0f && along * along >= cosSq * distSq)
+                                                        : (along >= 0.0f || along * along <= cosSq * distSq);
+            if (distSq <= rangeSq && bInCone)
+            {
+                pOutRenIDs[numResults++] = mRenIDs[slot];
+            }
+        }
+        return numResults;
+    }
+
+    /*!
+     * Handles "EuphoriaSpatial cell <metres>|stats". Returns true if the message was ours.
+     */
+    bool SpatialHash::HandleMessage(const char* msg)
+    {
+        static const char kPrefix[] = "EuphoriaSpatial ";
+        if (strncmp(msg, kPrefix, sizeof(kPrefix) - 1) != 0)
+        {
+            return false;
+        }
+
+        const char* pCommand = msg + sizeof(kPrefix) - 1;
+        float cellSize;
+        if (sscanf(pCommand, "cell %f", &cellSize) == 1 && cellSize >= kSpatialMinCellSize)
+        {
+            // The built entries are bucketed for the old size until the next rebuild
+            mfPendingCellSize = cellSize;
+        }
+        else if (strcmp(pCommand, "stats") == 0)
+        {
+            uint32 usedBuckets = 0;
+            uint32 largestBucket = 0;
+            for (uint32 bucket = 0; bucket < kNumBuckets; ++bucket)
+            {
+                const uint32 size = mBucketStart[bucket + 1] - mBucketStart[bucket];
+                usedBuckets += (size > 0) ? 1 : 0;
+                largestBucket = (size > largestBucket) ? size : largestBucket;
+            }
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaSpatial: %u NPCs in %u of %u buckets (largest %u), %.1fm cells, %u dropped\n",
+                       mNumEntries, usedBuckets, kNumBuckets, largestBucket, mfCellSize, mNumDropped);
+        }
+        else
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaSpatial: unknown command %s\n", pCommand);
+        }
+        return true;
+    }
+}
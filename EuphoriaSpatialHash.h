@@ -0,0 +1,130 @@
+#ifndef EUPHORIA_SPATIAL_HASH_H
+#define EUPHORIA_SPATIAL_HASH_H
+
+#include "RoninConfig.h"
+#include "RavenMath.h"
+#include "Rens/RenTypes.h"
+
+namespace euphoria
+{
+    /*!
+     * Where every Euphoria NPC was at the end of ThinkAll, hashed on a grid
+     * over the ground plane so radius and cone queries only look at the cells
+     * they overlap.
+     *
+     * Each component keeps the staged slot matching its hot record. ThinkAll
+     * re-reads the position of a component that thought this frame, and of a
+     * rolling 1 in kRefreshFrames of the idle ones, whose animation may still
+     * move them. The rest keep their staged position. Build sorts the entries
+     * by bucket in one counting pass, so a bucket's entries are contiguous,
+     * and only runs when a slot has changed. Components destroyed during the
+     * frame are removed straight away; ones created during it show up after
+     * the next rebuild. Components past kMaxEntries are not hashed, and the
+     * first one dropped is traced.
+     *
+     *   EuphoriaSpatial cell <metres>|stats
+     */
+    class SpatialHash
+    {
+    public:
+        enum
+        {
+            kMaxEntries = 1024,
+            kRefreshFrames = 4      //!< Idle positions are at most this many frames old. Power of two.
+        };
+
+    private:
+        enum
+        {
+            kNumBuckets = 256       //!< Power of two
+        };
+
+        // MEMBERS
+        // Staged by Update, one slot per hot record
+        Ronin::RenID mStagedRenIDs[kMaxEntries];
+        RavenMath::Vec3 mStagedPositions[kMaxEntries];
+        uint32 mStagedBuckets[kMaxEntries];             //!< Filled in by Build
+        uint32 mNumStaged;
+        uint32 mRefreshPhase;
+        bool mbIsDirty;                                 //!< A slot has changed since the last Build
+        bool mbRefreshAll;
+
+        // Built, sorted by bucket
+        Ronin::RenID mRenIDs[kMaxEntries];
+        float mPosX[kMaxEntries];
+        float mPosY[kMaxEntries];
+        float mPosZ[kMaxEntries];
+        uint32 mBucketStart[kNumBuckets + 1];
+        uint32 mNumEntries;
+
+        float mfCellSize;
+        float mfInvCellSize;
+        float mfPendingCellSize;
+        uint32 mNumDropped;
+
+        // NOT IMPLEMENTED
+        SpatialHash(const SpatialHash&);
+        SpatialHash& operator=(const SpatialHash&);
+
+        // METHODS
+        inline int CellOf(float coord) const;
+        inline uint32 BucketOf(int cellX, int cellZ) const;
+        uint32 GatherSlots(const RavenMath::Vec3& centre, float radius, uint32* pOutSlots, uint32 maxResults) const;
+
+    public:
+        // CREATORS
+        SpatialHash();
+
+        // MANIPULATORS
+        void Update(uint32 slot, Ronin::RenID renID, const RavenMath::Vec3& position);
+        void Build(uint32 numSlots);
+        void Remove(Ronin::RenID renID, uint32 slot);
+        void Clear();
+        inline void RefreshAll();
+        bool HandleMessage(const char* msg);
+
+        // ACCESSORS
+        uint32 QueryRadius(const RavenMath::Vec3& centre, float radius, Ronin::RenID* pOutRenIDs, uint32 maxResults) const;
+        uint32 QueryCone(const RavenMath::Vec3& apex, const RavenMath::Vec3& direction, float cosHalfAngle, float range, Ronin::RenID* pOutRenIDs, uint32 maxResults) const;
+        inline bool IsDue(uint32 slot, Ronin::RenID renID) const;
+        inline uint32 GetNumEntries() const;
+    };
+
+    // INLINES
+    int SpatialHash::CellOf(float coord) const
+    {
+        const float cell = coord * mfInvCellSize;
+        const int truncated = static_cast<int>(cell);
+        return (cell < static_cast<float>(truncated)) ? truncated - 1 : truncated;
+    }
+
+    uint32 SpatialHash::BucketOf(int cellX, int cellZ) const
+    {
+        return (static_cast<uint32>(cellX) * 73856093u ^ static_cast<uint32>(cellZ) * 19349663u) & (kNumBuckets - 1);
+    }
+
+    /*!
+     * Has every slot re-read at the end of the next ThinkAll, for callers that
+     * have moved NPCs that are not thinking
+     */
+    void SpatialHash::RefreshAll()
+    {
+        mbRefreshAll = true;
+    }
+
+    /*!
+     * True if the component in slot should have its position re-read this frame
+     */
+    bool SpatialHash::IsDue(uint32 slot, Ronin::RenID renID) const
+    {
+        return mbRefreshAll || slot >= mNumStaged || mStagedRenIDs[slot] != renID || ((slot + mRefreshPhase) & (kRefreshFrames - 1)) == 0;
+    }
+
+    uint32 SpatialHash::GetNumEntries() const
+    {
+        return mNumEntries;
+    }
+}
+
+// EUPHORIA_SPATIAL_HASH_H
+#endif
@@ -25,6 +25,13 @@ namespace euphoria
         eNumGetups
     };
 
+    // CONSTANTS
+    //! Cosines of the spine angles separating the getup positions. Every getup classifier uses these.
+    const float kfGetupCos45 = 0.70710678f;
+    const float kfGetupCos55 = 0.57357644f;
+    const float kfGetupCos90 = 0.0f;
+    const float kfGetupCos125 = -0.57357644f;
+
     /*!
      * These values are used to indicate limbs which can grab edges in the game
      * world.
@@ -36,6 +43,33 @@ namespace euphoria
         eNumArms        //! "number of appendages that can grab"
     };
 
+    /*!
+     * Tuning for getting up from a given GetupPosition. InitiateBlend splits the
+     * getup blend time into the SuperBlend and BlendToAnimation phases using these
+     * values, and BLENDTO uses the rest for the blend-to-frame behavior and the
+     * recovery conditions. The manager owns one per position, loaded from the
+     * settings bundle when it has them and the compiled defaults otherwise.
+     * They can also be edited in place at runtime with the BlendProfile
+     * message, so any field may change between two blends.
+     */
+    struct BlendProfile
+    {
+        float mBlendTimeScale;                  //!< Scale applied to the primary block's remaining time
+        float mPhaseTwoRatio;                   //!< Fraction of the blend time given to phase two
+        float mPhaseOneEffectorRamp;            //!< Multipliers of the phase one time (frames per second)
+        float mPhaseOneCoreBlend;
+        float mPhaseTwoEffectorRamp;            //!< Multipliers of the phase two time, or frame counts when mbPhaseTwoFixedFrames
+        float mPhaseTwoCoreBlend;
+        float mPhaseTwoBodyBlendStart;
+        float mPhaseTwoBodyBlendDuration;
+        bool mbPhaseTwoFixedFrames;
+        bool mbUseTurnCorrection;               //!< Scale phase two time by the turn correction
+        int mBlendToRampDuration;               //!< BLENDTO blend-to-frame ramp, in frames
+        int mBlendToFrames;                     //!< BLENDTO blend-to-frame duration, in frames
+        float mStationaryWaitTime;              //!< BLENDTO recovery conditions
+        float mStationarySpeedThreshold;
+    };
+
     /*!
      * Used to pass information about grabbed edges between performances and the
      * actual code that does the edge searching
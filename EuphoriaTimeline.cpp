@@ -0,0 +1,371 @@
+#include "EuphoriaTimeline.h"
+
+#if EUPHORIA_PROFILE_ENABLED
+
+#include "LECLog.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(PLATFORM_WINDOWS)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#ifndef EUPHORIA_THREAD_LOCAL
+#define EUPHORIA_THREAD_LOCAL __declspec(thread)
+#endif
+#else
+#ifndef EUPHORIA_THREAD_LOCAL
+#define EUPHORIA_THREAD_LOCAL __thread
+#endif
+#endif
+
+namespace euphoria
+{
+    // USING DECLARATIONS
+    using lec::LecTraceChannel;
+
+    // Define statics
+    volatile bool Timeline::msbCapturing = false;
+
+    // LOCAL CONST INITIALIZATION
+    namespace
+    {
+        struct TimelineEvent
+        {
+            const char* mpName;
+            ProfileTicks mTicks;
+            uint32 mTrack;
+            char mPhase;                //!< Chrome trace phase: 'B', 'E' or 'i'
+        };
+
+        struct TimelineChunk
+        {
+            TimelineChunk* mpNext;
+            uint32 mNumEvents;
+            TimelineEvent mEvents[Timeline::kEventsPerChunk];
+        };
+
+        //! Chunks from a previous capture are recognised by their capture ID and dropped
+        EUPHORIA_THREAD_LOCAL TimelineChunk* tpTimelineChunk = NULL;
+        EUPHORIA_THREAD_LOCAL uint32 tTimelineCaptureId = 0;
+        EUPHORIA_THREAD_LOCAL uint32 tTimelineTrack = 0;
+
+        TimelineChunk* sActiveChunks[ProfileSlot::kMaxThreads];
+        TimelineChunk* spQueueHead = NULL;
+        TimelineChunk* spQueueTail = NULL;
+        uint32 sNumQueuedChunks = 0;
+        volatile long sQueueLock = 0;
+        uint32 sCaptureId = 0;
+
+        // Only touched by whichever thread is writing
+        FILE* spTimelineFile = NULL;
+        ProfileTicks sStartTicks = 0;
+        uint32 sSeenTracks[Timeline::kMaxTracks];
+        uint32 sNumSeenTracks = 0;
+
+#if defined(PLATFORM_WINDOWS)
+        HANDLE shWriterThread = NULL;
+        volatile bool sbStopWriter = false;
+#endif
+
+        void LockQueue()
+        {
+#if defined(PLATFORM_WINDOWS)
+            while (InterlockedExchange(&sQueueLock, 1) != 0)
+            {
+                Sleep(0);
+            }
+#else
+            while (__sync_lock_test_and_set(&sQueueLock, 1) != 0)
+            {
+            }
+#endif
+        }
+
+        void UnlockQueue()
+        {
+#if defined(PLATFORM_WINDOWS)
+            InterlockedExchange(&sQueueLock, 0);
+#else
+            __sync_lock_release(&sQueueLock);
+#endif
+        }
+
+        void EnqueueChunk(TimelineChunk* pChunk)
+        {
+            pChunk->mpNext = NULL;
+            LockQueue();
+            if (spQueueTail != NULL)
+            {
+                spQueueTail->mpNext = pChunk;
+            }
+            else
+            {
+                spQueueHead = pChunk;
+            }
+            spQueueTail = pChunk;
+            ++sNumQueuedChunks;
+            UnlockQueue();
+        }
+
+        /*!
+         * Names a track the first time it appears in the file
+         */
+        void WriteTrackName(uint32 track)
+        {
+            for (uint32 i = 0; i < sNumSeenTracks; ++i)
+            {
+                if (sSeenTracks[i] == track)
+                {
+                    return;
+                }
+            }
+            if (sNumSeenTracks == Timeline::kMaxTracks)
+            {
+                return;
+            }
+            sSeenTracks[sNumSeenTracks++] = track;
+
+            if (track == 0)
+            {
+                fprintf(spTimelineFile, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"EuphoriaManager\"}}");
+            }
+            else
+            {
+                fprintf(spTimelineFile, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"Ren %u\"}}", track, track);
+            }
+        }
+
+        void WriteChunk(const TimelineChunk* pChunk)
+        {
+            for (uint32 i = 0; i < pChunk->mNumEvents; ++i)
+            {
+                const TimelineEvent& rEvent = pChunk->mEvents[i];
+                const uint32 ts = Profiler::TicksToMicroseconds(rEvent.mTicks - sStartTicks);
+
+                WriteTrackName(rEvent.mTrack);
+                if (rEvent.mPhase == 'E')
+                {
+                    fprintf(spTimelineFile, ",\n{\"ph\":\"E\",\"ts\":%u,\"pid\":1,\"tid\":%u}", ts, rEvent.mTrack);
+                }
+                else if (rEvent.mPhase == 'i')
+                {
+                    fprintf(spTimelineFile, ",\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%u,\"pid\":1,\"tid\":%u}", rEvent.mpName, ts, rEvent.mTrack);
+                }
+                else
+                {
+                    fprintf(spTimelineFile, ",\n{\"name\":\"%s\",\"ph\":\"B\",\"ts\":%u,\"pid\":1,\"tid\":%u}", rEvent.mpName, ts, rEvent.mTrack);
+                }
+            }
+        }
+
+        void WriteQueuedChunks()
+        {
+            for (;;)
+            {
+                LockQueue();
+                TimelineChunk* pChunk = spQueueHead;
+                if (pChunk != NULL)
+                {
+                    --sNumQueuedChunks;
+                    spQueueHead = pChunk->mpNext;
+                    if (spQueueHead == NULL)
+                    {
+                        spQueueTail = NULL;
+                    }
+                }
+                UnlockQueue();
+
+                if (pChunk == NULL)
+                {
+                    return;
+                }
+
+                WriteChunk(pChunk);
+                lec_delete pChunk;
+            }
+        }
+
+#if defined(PLATFORM_WINDOWS)
+        DWORD WINAPI TimelineWriterThread(LPVOID)
+        {
+            while (!sbStopWriter)
+            {
+                WriteQueuedChunks();
+                Sleep(10);
+            }
+            WriteQueuedChunks();
+            return 0;
+        }
+#endif
+
+        void Append(const char* pName, char phase)
+        {
+            TimelineChunk* pChunk = tpTimelineChunk;
+            if (pChunk == NULL || tTimelineCaptureId != sCaptureId || pChunk->mNumEvents == Timeline::kEventsPerChunk)
+            {
+                if (pChunk != NULL && tTimelineCaptureId == sCaptureId)
+                {
+                    EnqueueChunk(pChunk);
+                }
+
+                pChunk = lec_new TimelineChunk;
+                pChunk->mpNext = NULL;
+                pChunk->mNumEvents = 0;
+                sActiveChunks[Profiler::GetThreadIndex()] = pChunk;
+                tpTimelineChunk = pChunk;
+                tTimelineCaptureId = sCaptureId;
+            }
+
+            TimelineEvent& rEvent = pChunk->mEvents[pChunk->mNumEvents];
+            rEvent.mpName = pName;
+            rEvent.mTicks = Profiler::ReadTicks();
+            rEvent.mTrack = tTimelineTrack;
+            rEvent.mPhase = phase;
+            ++pChunk->mNumEvents;
+        }
+    }
+
+    /*!
+     * Opens pPath and starts recording. Stops any capture already running.
+     */
+    bool Timeline::Start(const char* pPath)
+    {
+        Stop();
+
+        spTimelineFile = fopen(pPath, "w");
+        if (spTimelineFile == NULL)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaTimeline: could not open %s\n", pPath);
+            return false;
+        }
+
+        fprintf(spTimelineFile, "{\"traceEvents\":[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Euphoria\"}}");
+        sStartTicks = Profiler::ReadTicks();
+        sNumSeenTracks = 0;
+        ++sCaptureId;
+
+#if defined(PLATFORM_WINDOWS)
+        sbStopWriter = false;
+        shWriterThread = CreateThread(NULL, 0, TimelineWriterThread, NULL, 0, NULL);
+#endif
+
+        msbCapturing = true;
+        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaTimeline: capturing to %s\n", pPath);
+        return true;
+    }
+
+    /*!
+     * Stops recording and finishes the file. Events still being appended by other
+     * threads at this instant may be lost, so stop from the main thread between
+     * frames.
+     */
+    void Timeline::Stop()
+    {
+        if (!msbCapturing)
+        {
+            return;
+        }
+        msbCapturing = false;
+
+        for (int i = 0; i < ProfileSlot::kMaxThreads; ++i)
+        {
+            if (sActiveChunks[i] != NULL)
+            {
+                EnqueueChunk(sActiveChunks[i]);
+                sActiveChunks[i] = NULL;
+            }
+        }
+        ++sCaptureId;
+
+#if defined(PLATFORM_WINDOWS)
+        if (shWriterThread != NULL)
+        {
+            sbStopWriter = true;
+            WaitForSingleObject(shWriterThread, INFINITE);
+            CloseHandle(shWriterThread);
+            shWriterThread = NULL;
+        }
+#endif
+        WriteQueuedChunks();
+
+        fprintf(spTimelineFile, "\n]}\n");
+        fclose(spTimelineFile);
+        spTimelineFile = NULL;
+        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaTimeline: capture written\n");
+    }
+
+    void Timeline::Begin(const char* pName)
+    {
+        Append(pName, 'B');
+    }
+
+    void Timeline::End()
+    {
+        Append(NULL, 'E');
+    }
+
+    void Timeline::Instant(const char* pName)
+    {
+        Append(pName, 'i');
+    }
+
+    /*!
+     * Sets the track this thread's events go to, returning the old one
+     */
+    uint32 Timeline::SetTrack(uint32 track)
+    {
+        const uint32 outerTrack = tTimelineTrack;
+        tTimelineTrack = track;
+        return outerTrack;
+    }
+
+    /*!
+     * Called by Profiler::EndFrame on the main thread. Without a writer thread,
+     * this is where queued chunks get written during a capture.
+     */
+    void Timeline::EndFrame()
+    {
+#if !defined(PLATFORM_WINDOWS)
+        // A stale read only delays the flush by a frame
+        if (msbCapturing && sNumQueuedChunks >= kFlushChunks)
+        {
+            WriteQueuedChunks();
+        }
+#endif
+    }
+
+    /*!
+     * Returns true if the message was a timeline message. See the class comment.
+     */
+    bool Timeline::HandleMessage(const char* msg)
+    {
+        static const char kPrefix[] = "EuphoriaTimeline ";
+        if (strncmp(msg, kPrefix, sizeof(kPrefix) - 1) != 0)
+        {
+            return false;
+        }
+
+        const char* pCommand = msg + sizeof(kPrefix) - 1;
+        char path[256];
+        if (strcmp(pCommand, "stop") == 0)
+        {
+            Stop();
+        }
+        else if (sscanf(pCommand, "start %255s", path) == 1)
+        {
+            Start(path);
+        }
+        else
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaTimeline: unknown command %s\n", pCommand);
+        }
+
+        return true;
+    }
+}
+
+// EUPHORIA_PROFILE_ENABLED
+#endif
@@ -0,0 +1,101 @@
+#ifndef EUPHORIA_TIMELINE_H
+#define EUPHORIA_TIMELINE_H
+
+#include "EuphoriaProfiler.h"
+
+#if EUPHORIA_PROFILE_ENABLED
+
+namespace euphoria
+{
+    /*!
+     * Captures profiler activity to a Chrome trace JSON file, which opens in
+     * chrome://tracing and the Perfetto UI. While capturing, every ProfileScope
+     * becomes a slice (ThinkAll, each comp's Think, performance Think/OnEvent, state
+     * ENTER/UPDATE) and every EUPHORIA_COUNT becomes an instant event, so behavior
+     * starts/stops and collision queries show up inside the state that made them.
+     * Each NPC gets its own track, keyed by RenID; track 0 is the manager.
+     *
+     * Events go into per-thread chunks in memory. Full chunks are handed to a writer
+     * thread on Windows. Elsewhere the main thread writes them at the end of a frame
+     * once kFlushChunks have queued up, so a long capture stays bounded in memory.
+     *
+     * Driven from EuphoriaManager::HandleMessage:
+     *
+     *   EuphoriaTimeline start <path>
+     *   EuphoriaTimeline stop
+     */
+    class Timeline
+    {
+    public:
+        enum
+        {
+            kEventsPerChunk = 2048,
+            kFlushChunks = 8,           //!< Queued chunks that make EndFrame write, without a writer thread
+            kMaxTracks = 1024           //!< Tracks past this are still written but go unnamed
+        };
+
+        static bool Start(const char* pPath);
+        static void Stop();
+        static inline bool IsCapturing();
+
+        static void Begin(const char* pName);
+        static void End();
+        static void Instant(const char* pName);
+        static uint32 SetTrack(uint32 track);
+        static void EndFrame();
+
+        static bool HandleMessage(const char* msg);
+
+    private:
+        // STATIC MEMBERS
+        static volatile bool msbCapturing;
+    };
+
+    /*!
+     * Puts events from this thread on another track for the scope's lifetime
+     */
+    class TimelineTrackScope
+    {
+    public:
+        // CREATORS
+        inline explicit TimelineTrackScope(uint32 track);
+        inline ~TimelineTrackScope();
+
+    private:
+        // MEMBERS
+        uint32 mOuterTrack;
+
+        // NOT IMPLEMENTED
+        TimelineTrackScope(const TimelineTrackScope&);
+        TimelineTrackScope& operator=(const TimelineTrackScope&);
+    };
+
+    // INLINES
+    bool Timeline::IsCapturing()
+    {
+        return msbCapturing;
+    }
+
+    TimelineTrackScope::TimelineTrackScope(uint32 track)
+        : mOuterTrack(Timeline::SetTrack(track))
+    {
+    }
+
+    TimelineTrackScope::~TimelineTrackScope()
+    {
+        Timeline::SetTrack(mOuterTrack);
+    }
+}
+
+//! RenIDs are integral handles; the track is the RenID's value
+#define EUPHORIA_PROFILE_TRACK(RenId) \
+    euphoria::TimelineTrackScope timelineTrack(static_cast<uint32>(RenId))
+
+#else
+
+#define EUPHORIA_PROFILE_TRACK(RenId) ((void)0)
+
+#endif
+
+// EUPHORIA_TIMELINE_H
+#endif
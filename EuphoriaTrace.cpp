@@ -0,0 +1,437 @@
+#include "EuphoriaTrace.h"
+
+#if EUPHORIA_TRACE_LEVEL > 0
+
+#include "LECLog.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(PLATFORM_WINDOWS)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#ifndef EUPHORIA_THREAD_LOCAL
+#define EUPHORIA_THREAD_LOCAL __declspec(thread)
+#endif
+#else
+#ifndef EUPHORIA_THREAD_LOCAL
+#define EUPHORIA_THREAD_LOCAL __thread
+#endif
+#endif
+
+namespace euphoria
+{
+    // USING DECLARATIONS
+    using lec::LecTraceChannel;
+
+    // LOCAL CONST INITIALIZATION
+    namespace
+    {
+        const uint32 kTraceFileMagic = 0x52545545;     // 'EUTR'
+        const uint32 kTraceFileVersion = 1;
+        const uint32 kMaxDumpSites = 512;
+        const uint32 kUnknownSite = 0xffffffff;
+
+        struct TraceRecord
+        {
+            const TraceSite* mpSite;
+            uint32 mFrame;
+            TraceArg mArgs[Trace::kMaxArgs];
+        };
+
+        //! Ring buffer written only by its own thread
+        struct TraceBuffer
+        {
+            uint32 mWriteCount;
+            TraceRecord mRecords[Trace::kRecordsPerThread];
+        };
+
+        //! As laid out in a dump
+        struct TraceFileRecord
+        {
+            uint32 mSite;
+            uint32 mFrame;
+            uint32 mThread;
+            uint32 mArgs[Trace::kMaxArgs];
+        };
+
+        TraceBuffer* sTraceBuffers[Trace::kMaxThreads];
+        volatile long sNextTraceThread = 0;
+        volatile uint32 sTraceFrame = 0;
+        EUPHORIA_THREAD_LOCAL TraceBuffer* tpTraceBuffer = NULL;
+        EUPHORIA_THREAD_LOCAL bool tbTraceDropped = false;
+
+        /*!
+         * Returns this thread's buffer, creating it on the thread's first trace.
+         * Returns NULL once every buffer has been handed out.
+         */
+        TraceBuffer* GetTraceBuffer()
+        {
+            if (tpTraceBuffer == NULL && !tbTraceDropped)
+            {
+#if defined(PLATFORM_WINDOWS)
+                long index = InterlockedIncrement(&sNextTraceThread) - 1;
+#else
+                long index = __sync_add_and_fetch(&sNextTraceThread, 1) - 1;
+#endif
+                if (index < Trace::kMaxThreads)
+                {
+                    TraceBuffer* pBuffer = lec_new TraceBuffer;
+                    pBuffer->mWriteCount = 0;
+                    sTraceBuffers[index] = pBuffer;
+                    tpTraceBuffer = pBuffer;
+                }
+                else
+                {
+                    tbTraceDropped = true;
+                }
+            }
+
+            return tpTraceBuffer;
+        }
+
+        void RecordArgs(const TraceSite* pSite, const TraceArg* pArgs, int numArgs)
+        {
+            TraceBuffer* pBuffer = GetTraceBuffer();
+            if (pBuffer == NULL)
+            {
+                return;
+            }
+
+            TraceRecord& rRecord = pBuffer->mRecords[pBuffer->mWriteCount & (Trace::kRecordsPerThread - 1)];
+            rRecord.mpSite = pSite;
+            rRecord.mFrame = sTraceFrame;
+            for (int i = 0; i < Trace::kMaxArgs; ++i)
+            {
+                rRecord.mArgs[i].mUInt = (i < numArgs) ? pArgs[i].mUInt : 0;
+            }
+
+            ++pBuffer->mWriteCount;
+        }
+
+        bool WriteString(FILE* pFile, const char* pString)
+        {
+            const uint32 length = static_cast<uint32>(strlen(pString));
+            return fwrite(&length, sizeof(length), 1, pFile) == 1 && fwrite(pString, 1, length, pFile) == length;
+        }
+
+        bool ReadString(FILE* pFile, char* pString, uint32 maxLength)
+        {
+            uint32 length = 0;
+            if (fread(&length, sizeof(length), 1, pFile) != 1 || length >= maxLength)
+            {
+                return false;
+            }
+            pString[length] = '\0';
+            return fread(pString, 1, length, pFile) == length;
+        }
+
+        /*!
+         * printf for a recorded trace: each conversion takes the next argument,
+         * read as an int or a float depending on the conversion character.
+         */
+        void FormatRecord(FILE* pFile, const char* pFormat, const uint32* pArgs)
+        {
+            TraceArg arg;
+            int nextArg = 0;
+            char spec[32];
+
+            for (const char* p = pFormat; *p != '\0'; ++p)
+            {
+                if (*p != '%')
+                {
+                    fputc(*p, pFile);
+                    continue;
+                }
+                if (p[1] == '%')
+                {
+                    fputc('%', pFile);
+                    ++p;
+                    continue;
+                }
+
+                // Copy the conversion spec up to and including its type character
+                int length = 0;
+                const char* pSpec = p;
+                while (*pSpec != '\0' && strchr("diouxXcfFeEgG", *pSpec) == NULL && length < (int) sizeof(spec) - 2)
+                {
+                    spec[length++] = *pSpec++;
+                }
+                if (*pSpec == '\0')
+                {
+                    break;
+                }
+                spec[length++] = *pSpec;
+                spec[length] = '\0';
+                p = pSpec;
+
+                arg.mUInt = (nextArg < Trace::kMaxArgs) ? pArgs[nextArg] : 0;
+                ++nextArg;
+                if (strchr("fFeEgG", *pSpec) != NULL)
+                {
+                    fprintf(pFile, spec, static_cast<double>(arg.mFloat));
+                }
+                else
+                {
+                    fprintf(pFile, spec, arg.mInt);
+                }
+            }
+        }
+    }
+
+    void Trace::Record(const TraceSite* pSite)
+    {
+        RecordArgs(pSite, NULL, 0);
+    }
+
+    void Trace::Record(const TraceSite* pSite, TraceArg a)
+    {
+        RecordArgs(pSite, &a, 1);
+    }
+
+    void Trace::Record(const TraceSite* pSite, TraceArg a, TraceArg b)
+    {
+        TraceArg args[2] = { a, b };
+        RecordArgs(pSite, args, 2);
+    }
+
+    void Trace::Record(const TraceSite* pSite, TraceArg a, TraceArg b, TraceArg c)
+    {
+        TraceArg args[3] = { a, b, c };
+        RecordArgs(pSite, args, 3);
+    }
+
+    /*!
+     * Stamps later records with the next frame number
+     */
+    void Trace::EndFrame()
+    {
+        sTraceFrame = sTraceFrame + 1;
+    }
+
+    /*!
+     * Writes the buffers as: header, the table of call sites referenced, then every
+     * record oldest first per thread. Call sites are written with their strings so
+     * the dump decodes without the executable. Meant to be run while the game is
+     * paused; records written during the dump may be torn.
+     */
+    bool Trace::Dump(const char* pPath)
+    {
+        const TraceSite* sites[kMaxDumpSites];
+        uint32 numSites = 0;
+        uint32 numRecords = 0;
+
+        // Gather the sites in use
+        for (int t = 0; t < kMaxThreads; ++t)
+        {
+            const TraceBuffer* pBuffer = sTraceBuffers[t];
+            if (pBuffer == NULL)
+            {
+                continue;
+            }
+
+            const uint32 count = (pBuffer->mWriteCount < kRecordsPerThread) ? pBuffer->mWriteCount : kRecordsPerThread;
+            for (uint32 i = 0; i < count; ++i)
+            {
+                const TraceSite* pSite = pBuffer->mRecords[i].mpSite;
+                uint32 s = 0;
+                while (s < numSites && sites[s] != pSite)
+                {
+                    ++s;
+                }
+                if (s == numSites && numSites < kMaxDumpSites)
+                {
+                    sites[numSites++] = pSite;
+                }
+            }
+            numRecords += count;
+        }
+
+        FILE* pFile = fopen(pPath, "wb");
+        if (pFile == NULL)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaTrace: could not open %s\n", pPath);
+            return false;
+        }
+
+        const uint32 header[4] = { kTraceFileMagic, kTraceFileVersion, numSites, numRecords };
+        fwrite(header, sizeof(header), 1, pFile);
+
+        for (uint32 s = 0; s < numSites; ++s)
+        {
+            const uint32 fields[3] = { static_cast<uint32>(sites[s]->mLine), sites[s]->mChannel, sites[s]->mLevel };
+            fwrite(fields, sizeof(fields), 1, pFile);
+            WriteString(pFile, sites[s]->mpFormat);
+            WriteString(pFile, sites[s]->mpFile);
+        }
+
+        for (int t = 0; t < kMaxThreads; ++t)
+        {
+            const TraceBuffer* pBuffer = sTraceBuffers[t];
+            if (pBuffer == NULL)
+            {
+                continue;
+            }
+
+            const uint32 writeCount = pBuffer->mWriteCount;
+            const uint32 count = (writeCount < kRecordsPerThread) ? writeCount : kRecordsPerThread;
+            for (uint32 i = writeCount - count; i != writeCount; ++i)
+            {
+                const TraceRecord& rRecord = pBuffer->mRecords[i & (kRecordsPerThread - 1)];
+
+                TraceFileRecord fileRecord;
+                fileRecord.mSite = kUnknownSite;
+                for (uint32 s = 0; s < numSites; ++s)
+                {
+                    if (sites[s] == rRecord.mpSite)
+                    {
+                        fileRecord.mSite = s;
+                        break;
+                    }
+                }
+                fileRecord.mFrame = rRecord.mFrame;
+                fileRecord.mThread = static_cast<uint32>(t);
+                for (int a = 0; a < kMaxArgs; ++a)
+                {
+                    fileRecord.mArgs[a] = rRecord.mArgs[a].mUInt;
+                }
+                fwrite(&fileRecord, sizeof(fileRecord), 1, pFile);
+            }
+        }
+
+        fclose(pFile);
+        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaTrace: wrote %u records to %s\n", numRecords, pPath);
+        return true;
+    }
+
+    /*!
+     * Turns a dump into one line per record: frame, thread, file(line), message.
+     * Dumps must be decoded on a machine of the same endianness.
+     */
+    bool Trace::Decode(const char* pInPath, const char* pOutPath)
+    {
+        FILE* pIn = fopen(pInPath, "rb");
+        if (pIn == NULL)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaTrace: could not open %s\n", pInPath);
+            return false;
+        }
+
+        uint32 header[4];
+        if (fread(header, sizeof(header), 1, pIn) != 1 || header[0] != kTraceFileMagic || header[1] != kTraceFileVersion || header[2] > kMaxDumpSites)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaTrace: %s is not a trace dump\n", pInPath);
+            fclose(pIn);
+            return false;
+        }
+
+        FILE* pOut = fopen(pOutPath, "w");
+        if (pOut == NULL)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaTrace: could not open %s\n", pOutPath);
+            fclose(pIn);
+            return false;
+        }
+
+        const uint32 numSites = header[2];
+        const uint32 numRecords = header[3];
+        const uint32 kMaxString = 256;
+        uint32* pSiteLines = lec_new uint32[numSites + 1];
+        char* pSiteStrings = lec_new char[(numSites + 1) * kMaxString * 2];
+
+        bool bOk = true;
+        for (uint32 s = 0; s < numSites && bOk; ++s)
+        {
+            uint32 fields[3];
+            bOk = fread(fields, sizeof(fields), 1, pIn) == 1 &&
+                  ReadString(pIn, &pSiteStrings[s * kMaxString * 2], kMaxString) &&
+                  ReadString(pIn, &pSiteStrings[s * kMaxString * 2 + kMaxString], kMaxString);
+            pSiteLines[s] = bOk ? fields[0] : 0;
+        }
+
+        for (uint32 r = 0; r < numRecords && bOk; ++r)
+        {
+            TraceFileRecord record;
+            bOk = fread(&record, sizeof(record), 1, pIn) == 1;
+            if (!bOk)
+            {
+                break;
+            }
+
+            if (record.mSite >= numSites)
+            {
+                fprintf(pOut, "%6u %u  <unknown site>\n", record.mFrame, record.mThread);
+                continue;
+            }
+
+            const char* pFormat = &pSiteStrings[record.mSite * kMaxString * 2];
+            const char* pFile = &pSiteStrings[record.mSite * kMaxString * 2 + kMaxString];
+            fprintf(pOut, "%6u %u  %s(%u): ", record.mFrame, record.mThread, pFile, pSiteLines[record.mSite]);
+            FormatRecord(pOut, pFormat, record.mArgs);
+        }
+
+        lec_delete [] pSiteStrings;
+        lec_delete [] pSiteLines;
+        fclose(pOut);
+        fclose(pIn);
+
+        if (!bOk)
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaTrace: %s is truncated\n", pInPath);
+        }
+        return bOk;
+    }
+
+    /*!
+     * Empties the buffers. Like Dump, only safe while nothing is tracing.
+     */
+    void Trace::Clear()
+    {
+        for (int t = 0; t < kMaxThreads; ++t)
+        {
+            if (sTraceBuffers[t] != NULL)
+            {
+                sTraceBuffers[t]->mWriteCount = 0;
+            }
+        }
+    }
+
+    /*!
+     * Returns true if the message was a trace message. See the class comment.
+     */
+    bool Trace::HandleMessage(const char* msg)
+    {
+        static const char kPrefix[] = "EuphoriaTrace ";
+        if (strncmp(msg, kPrefix, sizeof(kPrefix) - 1) != 0)
+        {
+            return false;
+        }
+
+        const char* pCommand = msg + sizeof(kPrefix) - 1;
+        char inPath[256];
+        char outPath[256];
+        if (strcmp(pCommand, "clear") == 0)
+        {
+            Clear();
+        }
+        else if (sscanf(pCommand, "dump %255s", outPath) == 1)
+        {
+            Dump(outPath);
+        }
+        else if (sscanf(pCommand, "decode %255s %255s", inPath, outPath) == 2)
+        {
+            Decode(inPath, outPath);
+        }
+        else
+        {
+            LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EuphoriaTrace: unknown command %s\n", pCommand);
+        }
+
+        return true;
+    }
+}
+
+// EUPHORIA_TRACE_LEVEL
+#endif
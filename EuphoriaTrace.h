@@ -0,0 +1,139 @@
+#ifndef EUPHORIA_TRACE_H
+#define EUPHORIA_TRACE_H
+
+#include "RoninConfig.h"
+
+/*!
+ * Binary trace log for per-frame code. A trace records a pointer to its call site
+ * (format string, file, line) plus up to three raw 32-bit arguments into a ring
+ * buffer owned by the calling thread; nothing is formatted until the buffers are
+ * dumped and decoded, which happens offline (see Trace::Decode).
+ *
+ * Filtering is done at compile time: a trace is built only if its level is at or
+ * below EUPHORIA_TRACE_LEVEL and its channel bit is set in EUPHORIA_TRACE_CHANNELS.
+ * Anything filtered out folds to a constant-false branch, and with the level at
+ * zero the macros expand to nothing at all.
+ *
+ * Arguments may be int, unsigned int, float or bool. Formats may use any integer
+ * or floating-point conversion but not %s; strings are not captured.
+ */
+#ifndef EUPHORIA_TRACE_LEVEL
+#ifdef _DEBUG
+#define EUPHORIA_TRACE_LEVEL 2
+#else
+#define EUPHORIA_TRACE_LEVEL 0
+#endif
+#endif
+
+#ifndef EUPHORIA_TRACE_CHANNELS
+#define EUPHORIA_TRACE_CHANNELS 0xffffffffu
+#endif
+
+#if EUPHORIA_TRACE_LEVEL > 0
+
+namespace euphoria
+{
+    enum TraceChannel
+    {
+        eTraceGetup     = 1 << 0,
+        eTraceBlend     = 1 << 1,
+        eTraceEPA       = 1 << 2,
+        eTraceBalance   = 1 << 3,
+        eTraceExplosion = 1 << 4
+    };
+
+    enum TraceLevel
+    {
+        eTraceError     = 1,
+        eTraceInfo      = 2,
+        eTraceVerbose   = 3
+    };
+
+    /*!
+     * Describes one trace call site. Always a function-local static const aggregate,
+     * so it is initialized at compile time and its address is the format ID.
+     */
+    struct TraceSite
+    {
+        const char* mpFormat;
+        const char* mpFile;
+        int mLine;
+        uint32 mChannel;
+        uint32 mLevel;
+    };
+
+    union TraceArg
+    {
+        int mInt;
+        uint32 mUInt;
+        float mFloat;
+    };
+
+    inline TraceArg MakeTraceArg(int value)             { TraceArg arg; arg.mInt = value; return arg; }
+    inline TraceArg MakeTraceArg(unsigned int value)    { TraceArg arg; arg.mUInt = value; return arg; }
+    inline TraceArg MakeTraceArg(float value)           { TraceArg arg; arg.mFloat = value; return arg; }
+    inline TraceArg MakeTraceArg(bool value)            { TraceArg arg; arg.mInt = value ? 1 : 0; return arg; }
+
+    /*!
+     * Recording, dumping and decoding. Driven from EuphoriaManager::HandleMessage:
+     *
+     *   EuphoriaTrace dump <path>              writes every thread's buffer to a binary file
+     *   EuphoriaTrace decode <in> <out>        turns a dump into text
+     *   EuphoriaTrace clear                    empties the buffers
+     */
+    class Trace
+    {
+    public:
+        enum
+        {
+            kMaxArgs = 3,
+            kMaxThreads = 8,            //!< Traces from threads past this are dropped
+            kRecordsPerThread = 4096    //!< Must be a power of two
+        };
+
+        static void Record(const TraceSite* pSite);
+        static void Record(const TraceSite* pSite, TraceArg a);
+        static void Record(const TraceSite* pSite, TraceArg a, TraceArg b);
+        static void Record(const TraceSite* pSite, TraceArg a, TraceArg b, TraceArg c);
+        static void EndFrame();
+
+        static bool Dump(const char* pPath);
+        static bool Decode(const char* pInPath, const char* pOutPath);
+        static void Clear();
+        static bool HandleMessage(const char* msg);
+    };
+}
+
+#define EUPHORIA_TRACE_ON(Channel, Level) \
+    ((EUPHORIA_TRACE_CHANNELS & euphoria::Channel) != 0 && euphoria::Level <= EUPHORIA_TRACE_LEVEL)
+
+#define EUPHORIA_TRACE_SITE(Channel, Level, Format) \
+    static const euphoria::TraceSite kTraceSite = { Format, __FILE__, __LINE__, euphoria::Channel, euphoria::Level }
+
+#define EUPHORIA_TRACE0(Channel, Level, Format) \
+    do { if (EUPHORIA_TRACE_ON(Channel, Level)) { EUPHORIA_TRACE_SITE(Channel, Level, Format); \
+        euphoria::Trace::Record(&kTraceSite); } } while (0)
+
+#define EUPHORIA_TRACE1(Channel, Level, Format, A) \
+    do { if (EUPHORIA_TRACE_ON(Channel, Level)) { EUPHORIA_TRACE_SITE(Channel, Level, Format); \
+        euphoria::Trace::Record(&kTraceSite, euphoria::MakeTraceArg(A)); } } while (0)
+
+#define EUPHORIA_TRACE2(Channel, Level, Format, A, B) \
+    do { if (EUPHORIA_TRACE_ON(Channel, Level)) { EUPHORIA_TRACE_SITE(Channel, Level, Format); \
+        euphoria::Trace::Record(&kTraceSite, euphoria::MakeTraceArg(A), euphoria::MakeTraceArg(B)); } } while (0)
+
+#define EUPHORIA_TRACE3(Channel, Level, Format, A, B, C) \
+    do { if (EUPHORIA_TRACE_ON(Channel, Level)) { EUPHORIA_TRACE_SITE(Channel, Level, Format); \
+        euphoria::Trace::Record(&kTraceSite, euphoria::MakeTraceArg(A), euphoria::MakeTraceArg(B), euphoria::MakeTraceArg(C)); } } while (0)
+
+#else
+
+#define EUPHORIA_TRACE0(Channel, Level, Format) ((void)0)
+#define EUPHORIA_TRACE1(Channel, Level, Format, A) ((void)0)
+#define EUPHORIA_TRACE2(Channel, Level, Format, A, B) ((void)0)
+#define EUPHORIA_TRACE3(Channel, Level, Format, A, B, C) ((void)0)
+
+#endif
+
+// EUPHORIA_TRACE_H
+#endif
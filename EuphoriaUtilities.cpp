@@ -1,3 +1,6 @@
+#include "EuphoriaDebugDraw.h"
+#include "EuphoriaProfiler.h"
+#include "EuphoriaReplay.h"
 #include "EuphoriaUtilities.h"
 #include "BoneCRC.h"
 #include "AnimationComponentPlugInInterface.h"
@@ -138,13 +141,19 @@ namespace euphoria
 
         GameHooks::FortuneGamePlugInInterface* pEngineInterface = gpEuphoriaManager->GetFortuneGamePlugIn();
         EdgeSystemManagerPlugInInterface* pEdgeMgr = pEngineInterface->GetEdgeSystemInterface();
-        uint32 numEdgesFound = pEdgeMgr->FindEdgesInRadius(edges, maxEdges, posGrabbingHand, skMaxReachDistance, EdgeSystem::kAny);
+        EUPHORIA_COUNT(eCountFindEdgesInRadius);
+        uint32 numEdgesFound = EUPHORIA_REPLAY_RESULT(uint32, pEdgeMgr->FindEdgesInRadius(edges, maxEdges, posGrabbingHand, skMaxReachDistance, EdgeSystem::kAny));
+        EUPHORIA_REPLAY_DATA(edges);
         if (numEdgesFound > 0)
         {
             outGrabbedEdge.mHandle = edges[0];
             pEdgeMgr->GetEdgePosition(outGrabbedEdge.mHandle, outGrabbedEdge.mvStart, outGrabbedEdge.mvEnd);
 
-            outDistanceToEdge = pEdgeMgr->DistanceToEdge(outGrabbedEdge.mHandle, posGrabbingHand, outClosestPoint);
+            EUPHORIA_COUNT(eCountDistanceToEdge);
+            outDistanceToEdge = EUPHORIA_REPLAY_RESULT(float, pEdgeMgr->DistanceToEdge(outGrabbedEdge.mHandle, posGrabbingHand, outClosestPoint));
+            EUPHORIA_REPLAY_DATA(outClosestPoint);
+            EUPHORIA_DEBUG_LINE(eDrawGrabEdges, outGrabbedEdge.mvStart, outGrabbedEdge.mvEnd, kDebugColorYellow);
+            EUPHORIA_DEBUG_LINE(eDrawGrabEdges, posGrabbingHand, outClosestPoint, kDebugColorCyan);
 
             // Check to see whether this edge is attached to a physics object
             RenID edgeOwner = pEdgeMgr->GetEdgeRen(outGrabbedEdge.mHandle);
@@ -7,6 +7,9 @@ BalancePerformance.cpp
 #include "EuphoriaBehaviorCRC.h"
 #include "PhysicsComponentPlugInInterface.h"
 #include "EuphoriaComp.h"
+#include "EuphoriaProfiler.h"
+#include "EuphoriaReplay.h"
+#include "EuphoriaTrace.h"
 
 namespace euphoria
 {
@@ -25,6 +28,12 @@ namespace euphoria
     DEFINE_STATE(BalancePerformance, FALLING);
     DEFINE_STATE(BalancePerformance, CLEANUP);
 
+    EUPHORIA_PROFILE_DEFINE_PERFORMANCE(BalancePerformance);
+    EUPHORIA_PROFILE_DEFINE_STATE(BalancePerformance, IDLE);
+    EUPHORIA_PROFILE_DEFINE_STATE(BalancePerformance, BALANCING);
+    EUPHORIA_PROFILE_DEFINE_STATE(BalancePerformance, FALLING);
+    EUPHORIA_PROFILE_DEFINE_STATE(BalancePerformance, CLEANUP);
+
     // This is not in GetStateController on purpose
     static bool sBalanceControllerInitialized = false;
 
@@ -132,7 +141,8 @@ namespace euphoria
     void BalancePerformance::Start()
     {
         PhysicsCompPlugInInterface* pPhysicsComp = mpOwner->GetPhysicsInterface();
-        if (pPhysicsComp->IsSupported())
+        EUPHORIA_COUNT(eCountIsSupported);
+        if (EUPHORIA_REPLAY_RESULT(bool, pPhysicsComp->IsSupported()))
         {
             mpStateMachine->ManualTransition(STATEID(BALANCING));
         }
@@ -155,12 +165,14 @@ namespace euphoria
      */
     void BalancePerformance::Think(float elapsedTime)
     {
+        EUPHORIA_PROFILE_SCOPE(BalancePerformance, Think);
         mpStateMachine->Advance(elapsedTime);
     }
 
     void BalancePerformance::OnEvent(const EuphoriaEvent& event)
     {
-        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Balance NOT handling events\n");
+        EUPHORIA_PROFILE_SCOPE(BalancePerformance, OnEvent);
+        EUPHORIA_TRACE0(eTraceBalance, eTraceInfo, "Balance NOT handling events\n");
     }
 
     /*!
@@ -198,10 +210,13 @@ namespace euphoria
     //
     void BalancePerformance::STATEFN_ENTER(IDLE)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(BalancePerformance, IDLE_ENTER);
+        EUPHORIA_ENTER_STATE(IDLE);
     }
 
     StateID BalancePerformance::STATEFN_UPDATE(IDLE)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(BalancePerformance, IDLE_UPDATE);
         return STATEID_INVALID;
     }
 
@@ -219,9 +234,12 @@ namespace euphoria
     //
     void BalancePerformance::STATEFN_ENTER(BALANCING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(BalancePerformance, BALANCING_ENTER);
+        EUPHORIA_ENTER_STATE(BALANCING);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "BalancePerformance::BALANCING ENTERED\n");
 
         AnimationCompPlugInInterface* pAnimComp = mpOwner->GetAnimationInterface();
+        EUPHORIA_COUNT(eCountStartBehavior);
         bool bStaggerStarted = pAnimComp->StartBehavior(EuphoriaBehaviorCRC::eStaggerBalance);
         LECASSERT(bStaggerStarted);
         LECUNUSED(bStaggerStarted);
@@ -229,12 +247,14 @@ namespace euphoria
 
     StateID BalancePerformance::STATEFN_UPDATE(BALANCING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(BalancePerformance, BALANCING_UPDATE);
         return STATEID_INVALID;
     }
 
     void BalancePerformance::STATEFN_EXIT(BALANCING)(const StateDataDefault& krStateData)
     {
         AnimationCompPlugInInterface* pAnimComp = mpOwner->GetAnimationInterface();
+        EUPHORIA_COUNT(eCountStopAllBehaviors);
         pAnimComp->StopAllBehaviors();
     }
 
@@ -248,15 +268,19 @@ namespace euphoria
     //
     void BalancePerformance::STATEFN_ENTER(FALLING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(BalancePerformance, FALLING_ENTER);
+        EUPHORIA_ENTER_STATE(FALLING);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "BalancePerformance::FALLING ENTERED\n");
 
         // Legs behavior
         AnimationCompPlugInInterface* pAnimComp = mpOwner->GetAnimationInterface();
+        EUPHORIA_COUNT(eCountStartBehavior);
         bool bStaggerStarted = pAnimComp->StartBehavior(EuphoriaBehaviorCRC::eStaggerBalance);
         LECASSERT(bStaggerStarted);
         LECUNUSED(bStaggerStarted);
 
         // Arms behavior
+        EUPHORIA_COUNT(eCountStartBehavior);
         bool bLandingFallWindmillStarted = pAnimComp->StartBehavior(EuphoriaBehaviorCRC::eLandingFall);
         LECASSERT(bLandingFallWindmillStarted);
         LECUNUSED(bLandingFallWindmillStarted);
@@ -264,12 +288,14 @@ namespace euphoria
 
     StateID BalancePerformance::STATEFN_UPDATE(FALLING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(BalancePerformance, FALLING_UPDATE);
         return STATEID_INVALID;
     }
 
     void BalancePerformance::STATEFN_EXIT(FALLING)(const StateDataDefault& krStateData)
     {
         AnimationCompPlugInInterface* pAnimComp = mpOwner->GetAnimationInterface();
+        EUPHORIA_COUNT(eCountStopAllBehaviors);
         pAnimComp->StopAllBehaviors();
     }
 
@@ -283,11 +309,14 @@ namespace euphoria
     //
     void BalancePerformance::STATEFN_ENTER(CLEANUP)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(BalancePerformance, CLEANUP_ENTER);
+        EUPHORIA_ENTER_STATE(CLEANUP);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "BalancePerformance::CLEANUP\n");
     }
 
     StateID BalancePerformance::STATEFN_UPDATE(CLEANUP)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(BalancePerformance, CLEANUP_UPDATE);
         // SM will always end in CLEANUP and start in IDLE. Does this have to be explicit?
         return STATEID(IDLE); 
     }
@@ -30,7 +30,6 @@ namespace euphoria
         static BalanceStateController msStateController;
 
         // MEMBERS
-        Ronin::StateMachineInstance* mpStateMachine;
         BalanceParams mParams;
 
         // UNIMPLEMENTED METHODS
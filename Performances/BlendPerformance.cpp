@@ -9,6 +9,14 @@ BlendPerformance.cpp
 #include "EuphoriaBehaviorCRC.h"
 #include "EuphoriaEvent.h"
 #include "EuphoriaComp.h"
+#include "EuphoriaHotLoad.h"
+#include "EuphoriaDebugDraw.h"
+#include "EuphoriaManager.h"
+#include "EuphoriaNameCRC.h"
+#include "EuphoriaOverrideBlock.h"
+#include "EuphoriaProfiler.h"
+#include "EuphoriaReplay.h"
+#include "EuphoriaTrace.h"
 #include "FortuneGamePlugInInterface.h"
 #include "PhysicsComponentPlugInInterface.h"
 #include "RoninPhysics/RoninPhysics_Base.h"
@@ -31,41 +39,80 @@ namespace euphoria
     // Chore crcs
     const crc32_t BlendPerformance::msParameterizedChoreTable[] = {     // Make sure all entries for this table are present and are in enum order
         CRC32_NULL,
-        CRCINIT("CHORE_PARAMETERIZED_GETUP_FROM_FRONT"),
-        CRCINIT("CHORE_PARAMETERIZED_GETUP_FROM_BACK"),
-        CRCINIT("CHORE_PARAMETERIZED_GETUP_FROM_LEFT"),
-        CRCINIT("CHORE_PARAMETERIZED_GETUP_FROM_RIGHT"),
-        CRCINIT("CHORE_PARAMETERIZED_UPRIGHT_RECOVERY"),
-        CRCINIT("CHORE_DEATH")
+        EuphoriaNameCRC::eChoreParamGetupFront,
+        EuphoriaNameCRC::eChoreParamGetupBack,
+        EuphoriaNameCRC::eChoreParamGetupLeft,
+        EuphoriaNameCRC::eChoreParamGetupRight,
+        EuphoriaNameCRC::eChoreParamRecoverUpright,
+        EuphoriaNameCRC::eChoreDeath
     };
     const crc32_t BlendPerformance::msParameterizedBlockTable[] = {     // Make sure all entries for this table are present and are in enum order
         CRC32_NULL,
-        CRCINIT("CBLK_Param_Getup_Front"),
-        CRCINIT("CBLK_Param_Getup_Back"),
-        CRCINIT("CBLK_Param_Getup_Left"),
-        CRCINIT("CBLK_Param_Getup_Right"),
-        CRCINIT("CBLK_Param_Recover_Upright"),
-        CRCINIT("CBLK_StaticDeadPose")
+        EuphoriaNameCRC::eBlockParamGetupFront,
+        EuphoriaNameCRC::eBlockParamGetupBack,
+        EuphoriaNameCRC::eBlockParamGetupLeft,
+        EuphoriaNameCRC::eBlockParamGetupRight,
+        EuphoriaNameCRC::eBlockParamRecoverUpright,
+        EuphoriaNameCRC::eBlockStaticDeadPose
     };
     const crc32_t BlendPerformance::msNonParameterizedChoreTable[] = {  // Make sure all entries for this table are present and are in enum order
         CRC32_NULL,
-        CRCINIT("CHORE_GETUP_FROM_FRONT"),
-        CRCINIT("CHORE_GETUP_FROM_BACK"),
-        CRCINIT("CHORE_GETUP_FROM_LEFT"),
-        CRCINIT("CHORE_GETUP_FROM_RIGHT"),
-        CRCINIT("CHORE_UPRIGHT_RECOVERY"),
-        CRCINIT("CHORE_DEATH")
+        EuphoriaNameCRC::eChoreGetupFront,
+        EuphoriaNameCRC::eChoreGetupBack,
+        EuphoriaNameCRC::eChoreGetupLeft,
+        EuphoriaNameCRC::eChoreGetupRight,
+        EuphoriaNameCRC::eChoreRecoverUpright,
+        EuphoriaNameCRC::eChoreDeath
     };
     const crc32_t BlendPerformance::msNonParameterizedBlockTable[] = {  // Make sure all entries for this table are present and are in enum order
         CRC32_NULL,
-        CRCINIT("CBLK_Euph_Getup_Front"),
-        CRCINIT("CBLK_Euph_Getup_Back"),
-        CRCINIT("CBLK_Euph_Getup_Left"),
-        CRCINIT("CBLK_Euph_Getup_Right"),
-        CRCINIT("CBLK_Euph_Recover_Upright"),
-        CRCINIT("CBLK_StaticDeadPose")
+        EuphoriaNameCRC::eBlockGetupFront,
+        EuphoriaNameCRC::eBlockGetupBack,
+        EuphoriaNameCRC::eBlockGetupLeft,
+        EuphoriaNameCRC::eBlockGetupRight,
+        EuphoriaNameCRC::eBlockRecoverUpright,
+        EuphoriaNameCRC::eBlockStaticDeadPose
     };
 
+    // Behavior override blocks
+    const OverrideBlock BlendPerformance::msBlendToFrameOverrideTable[] = {    // Make sure all entries for this table are present and are in enum order
+        // BodyStiffness, BlendWeightStart, BlendWeightEnd
+        // BlendRampDuration, BlendFrames (patched from the blend profile), RootPart, AlignToPart, blendErrorLimit
+        // TransformUpdate, DynamicKeyFraming, Debug
+        { 3, { 1.0f, 0.0f, 1.0f }, 4, { 4, 10, 1, 1 },    3, { true, false, false }, 0, { { 0.0f } }, 0, { CRC32_NULL }, 0, { NULL } },   // eGetupNone
+        { 3, { 1.0f, 0.0f, 1.0f }, 5, { 3, 4, 1, 1, 6 },  3, { true, false, false }, 0, { { 0.0f } }, 0, { CRC32_NULL }, 0, { NULL } },   // eGetupFront
+        { 3, { 1.0f, 0.0f, 1.0f }, 5, { 3, 4, 1, 1, 6 },  3, { true, false, false }, 0, { { 0.0f } }, 0, { CRC32_NULL }, 0, { NULL } },   // eGetupBack
+        { 3, { 1.0f, 0.0f, 1.0f }, 5, { 3, 4, 1, 1, 6 },  3, { true, false, false }, 0, { { 0.0f } }, 0, { CRC32_NULL }, 0, { NULL } },   // eGetupLeft
+        { 3, { 1.0f, 0.0f, 1.0f }, 5, { 3, 4, 1, 1, 6 },  3, { true, false, false }, 0, { { 0.0f } }, 0, { CRC32_NULL }, 0, { NULL } },   // eGetupRight
+        { 3, { 1.0f, 0.0f, 1.0f }, 5, { 2, 2, 1, 1, 6 },  3, { true, false, false }, 0, { { 0.0f } }, 0, { CRC32_NULL }, 0, { NULL } },   // eGetupUpright
+        { 3, { 1.0f, 0.0f, 1.0f }, 4, { 4, 10, 1, 1 },    3, { true, false, false }, 0, { { 0.0f } }, 0, { CRC32_NULL }, 0, { NULL } }    // eGetupDead
+    };
+    const OverrideBlock BlendPerformance::msSuperBlendOverrideTable[] = {      // Make sure all entries for this table are present and are in enum order
+        // BodyStiffness, offVec (patched), effectorRampDuration (patched), coreBlendDuration (patched), group
+        { 4, { 1.0f, 0.0f, 0.0f, 0.0f }, 2, { 0, 0 }, 0, { false }, 0, { { 0.0f } }, 0, { CRC32_NULL }, 1, { "handsFeetHead" } },          // eGetupNone
+        { 4, { 1.0f, 0.0f, 0.0f, 0.0f }, 2, { 0, 0 }, 0, { false }, 0, { { 0.0f } }, 0, { CRC32_NULL }, 1, { "handsFeetHeadPelvis" } },    // eGetupFront
+        { 4, { 1.0f, 0.0f, 0.0f, 0.0f }, 2, { 0, 0 }, 0, { false }, 0, { { 0.0f } }, 0, { CRC32_NULL }, 1, { "handsFeetHead" } },          // eGetupBack
+        { 4, { 1.0f, 0.0f, 0.0f, 0.0f }, 2, { 0, 0 }, 0, { false }, 0, { { 0.0f } }, 0, { CRC32_NULL }, 1, { "lower" } },                  // eGetupLeft
+        { 4, { 1.0f, 0.0f, 0.0f, 0.0f }, 2, { 0, 0 }, 0, { false }, 0, { { 0.0f } }, 0, { CRC32_NULL }, 1, { "lower" } },                  // eGetupRight
+        { 4, { 1.0f, 0.0f, 0.0f, 0.0f }, 2, { 0, 0 }, 0, { false }, 0, { { 0.0f } }, 0, { CRC32_NULL }, 1, { "handsFeetHeadPelvis" } },    // eGetupUpright - All Core group causing sinking bug
+        { 4, { 1.0f, 0.0f, 0.0f, 0.0f }, 2, { 0, 0 }, 0, { false }, 0, { { 0.0f } }, 0, { CRC32_NULL }, 1, { "handsFeetHead" } }           // eGetupDead
+    };
+    const OverrideBlock BlendPerformance::msBlendToAnimOverrideTable[] = {     // Make sure all entries for this table are present and are in enum order
+        // effectorRampDuration, coreBlendDuration, bodyBlendStart, bodyBlendDuration (all patched), group
+        { 0, { 0.0f }, 4, { 0, 0, 0, 0 }, 0, { false }, 0, { { 0.0f } }, 0, { CRC32_NULL }, 1, { "lower" } },    // eGetupNone
+        { 0, { 0.0f }, 4, { 0, 0, 0, 0 }, 0, { false }, 0, { { 0.0f } }, 0, { CRC32_NULL }, 1, { "all" } },      // eGetupFront
+        { 0, { 0.0f }, 4, { 0, 0, 0, 0 }, 0, { false }, 0, { { 0.0f } }, 0, { CRC32_NULL }, 1, { "all" } },      // eGetupBack
+        { 0, { 0.0f }, 4, { 0, 0, 0, 0 }, 0, { false }, 0, { { 0.0f } }, 0, { CRC32_NULL }, 1, { "all" } },      // eGetupLeft
+        { 0, { 0.0f }, 4, { 0, 0, 0, 0 }, 0, { false }, 0, { { 0.0f } }, 0, { CRC32_NULL }, 1, { "all" } },      // eGetupRight
+        { 0, { 0.0f }, 4, { 0, 0, 0, 0 }, 0, { false }, 0, { { 0.0f } }, 0, { CRC32_NULL }, 1, { "all" } },      // eGetupUpright
+        { 0, { 0.0f }, 4, { 0, 0, 0, 0 }, 0, { false }, 0, { { 0.0f } }, 0, { CRC32_NULL }, 1, { "lower" } }     // eGetupDead
+    };
+
+    // Getup classification hysteresis
+    const float BlendPerformance::msReclassifyCosThreshold = 0.98480775f;  // cos(10 degrees) of spine rotation
+    const float BlendPerformance::msReclassifyDistSqThreshold = 0.1f * 0.1f;  // 10cm of spine travel
+    const float BlendPerformance::msGetupStableWindow = 0.15f;            // seconds a new classification must hold
+
     // Define all of the states for this Performance
     DEFINE_STATE(BlendPerformance, IDLE);
     DEFINE_STATE(BlendPerformance, TRANSITIONING);
@@ -75,12 +122,28 @@ namespace euphoria
     DEFINE_STATE(BlendPerformance, BLENDTO);
     DEFINE_STATE(BlendPerformance, CLEANUP);
 
+    EUPHORIA_PROFILE_DEFINE_PERFORMANCE(BlendPerformance);
+    EUPHORIA_PROFILE_DEFINE_STATE(BlendPerformance, IDLE);
+    EUPHORIA_PROFILE_DEFINE_STATE(BlendPerformance, TRANSITIONING);
+    EUPHORIA_PROFILE_DEFINE_STATE(BlendPerformance, INTERRUPT);
+    EUPHORIA_PROFILE_DEFINE_STATE(BlendPerformance, BONKED);
+    EUPHORIA_PROFILE_DEFINE_STATE(BlendPerformance, STUCK);
+    EUPHORIA_PROFILE_DEFINE_STATE(BlendPerformance, BLENDTO);
+    EUPHORIA_PROFILE_DEFINE_STATE(BlendPerformance, CLEANUP);
+
     /*!
      *
      */
     BlendPerformance::BlendPerformance(EuphoriaComp* pOwner)
-        : EuphoriaPerformance(pOwner), mpStateMachine(NULL), mBlendPhase(ePhaseNone), mBlendStartTime(0.0f), mBlendDuration(0.0f), mBlendPhaseTwoStart(0.0f)
+        : EuphoriaPerformance(pOwner), mBlendPhase(ePhaseNone), mBlendStartTime(0.0f), mBlendDuration(0.0f), mBlendPhaseTwoStart(0.0f),
+          mpPhaseTwoOverrides(NULL),
+          mClassifiedPosition(eGetupNone), mfLastClassifyTime(0.0f)
     {
+        Vec3SetZero(mvClassifiedSpinePos);
+        Vec3SetZero(mvClassifiedSpineUp);
+        Vec3SetZero(mvClassifiedSpineForward);
+        ResetGetupClassification(eGetupNone);
+
         // Create a state machine instance for this class instance
         mpStateMachine = GetStateController().CreateInstance(this);
     }
@@ -121,6 +184,7 @@ namespace euphoria
      */
     void BlendPerformance::Think(float elapsedTime)
     {
+        EUPHORIA_PROFILE_SCOPE(BlendPerformance, Think);
         mpStateMachine->Advance(elapsedTime);
     }
 
@@ -129,6 +193,7 @@ namespace euphoria
      */
     void BlendPerformance::OnEvent(const EuphoriaEvent& event)
     {
+        EUPHORIA_PROFILE_SCOPE(BlendPerformance, OnEvent);
         mpStateMachine->OnEvent(event);
     }
 
@@ -153,6 +218,57 @@ namespace euphoria
         mParams = params;
     }
 
+    /*!
+     * Plays the getup chore for params.mInitialPosition without blending, for
+     * a body that has no agent to run the blend with (a passive or proxy
+     * ragdoll). The performance is not started and nothing needs to think.
+     */
+    void BlendPerformance::StartGetupChore(const BlendParams& params)
+    {
+        SetParams(params);
+        DetermineGetupChoreSimple((params.mInitialPosition != eGetupNone) ? params.mInitialPosition : eGetupUpright);
+    }
+
+    /*!
+     * Saves the blend timing and the getup the blend is heading for
+     */
+    void BlendPerformance::SaveResumeData(unsigned char* pData) const
+    {
+        typedef char ResumeDataFits[(sizeof(ResumeData) <= PerformanceResumeState::kMaxDataSize) ? 1 : -1];
+        LECUNUSED(sizeof(ResumeDataFits));
+
+        ResumeData data;
+        data.initialPosition = mParams.mInitialPosition;
+        data.phaseTwoPosition = (mpPhaseTwoOverrides != NULL) ? static_cast<GetupPosition>(mpPhaseTwoOverrides - msBlendToAnimOverrideTable) : eGetupNone;
+        data.blendPhase = mBlendPhase;
+        data.blendStartTime = mBlendStartTime;
+        data.blendDuration = mBlendDuration;
+        data.blendPhaseTwoStart = mBlendPhaseTwoStart;
+        data.lastClassifyTime = mfLastClassifyTime;
+        data.phaseTwo = mPhaseTwo;
+        memcpy(pData, &data, sizeof(data));
+    }
+
+    /*!
+     * The classifier restarts with full confidence in the saved getup, which
+     * is what it had settled on
+     */
+    void BlendPerformance::LoadResumeData(const unsigned char* pData)
+    {
+        ResumeData data;
+        memcpy(&data, pData, sizeof(data));
+        mParams.mInitialPosition = data.initialPosition;
+        mpPhaseTwoOverrides = (data.blendPhase != ePhaseNone) ? &msBlendToAnimOverrideTable[data.phaseTwoPosition] : NULL;
+        mBlendPhase = data.blendPhase;
+        mBlendStartTime = data.blendStartTime;
+        mBlendDuration = data.blendDuration;
+        mBlendPhaseTwoStart = data.blendPhaseTwoStart;
+        mPhaseTwo = data.phaseTwo;
+
+        ResetGetupClassification(mParams.mInitialPosition);
+        mfLastClassifyTime = data.lastClassifyTime;
+    }
+
     /*!
      * Returns the local static copy of the state controller. Initializes it if
      * necessary.
@@ -200,6 +316,7 @@ namespace euphoria
 
             if (ePosition != eGetupNone)
             {
+                EUPHORIA_COUNT(eCountStopAllBehaviors);
                 mpOwner->GetAnimationInterface()->StopAllBehaviors();
                 mParams.mInitialPosition = ePosition;
 
@@ -208,6 +325,7 @@ namespace euphoria
             else if (unstick)
             {
                 // unknown recovery position
+                EUPHORIA_COUNT(eCountStopAllBehaviors);
                 mpOwner->GetAnimationInterface()->StopAllBehaviors();
 
                 return STATEID(STUCK);
@@ -228,24 +346,27 @@ namespace euphoria
             // tick
             if (mBlendStartTime == 0.0f)
             {
-                mBlendStartTime = mpStateMachine->GetTimeInCurrentState();
+                mBlendStartTime = GetTimeInState();
             }
-            float elapsedBlendTime = mpStateMachine->GetTimeInCurrentState() - mBlendStartTime;
+            float elapsedBlendTime = GetTimeInState() - mBlendStartTime;
 
             switch (mBlendPhase)
             {
                 case ePhaseOne:
                     if (elapsedBlendTime >= mBlendPhaseTwoStart)
                     {
+                        LECASSERT(mpPhaseTwoOverrides);
                         ParameterOverrideDataInterface* pPhaseTwoData = mpOwner->GetAnimationInterface()->GetPODI();
+                        ApplyOverrideBlock(pPhaseTwoData, *mpPhaseTwoOverrides);
                         pPhaseTwoData->SetInt(0, (int) mPhaseTwo.effectorRampDuration);
                         pPhaseTwoData->SetInt(1, (int) mPhaseTwo.coreBlendDuration);
                         pPhaseTwoData->SetInt(2, (int) mPhaseTwo.bodyBlendStart);
                         pPhaseTwoData->SetInt(3, (int) mPhaseTwo.bodyBlendDuration);
-                        pPhaseTwoData->SetChar(0, mPhaseTwo.group);
 
                         // Start phase two of the blend
+                        EUPHORIA_COUNT(eCountStopBehavior);
                         mpOwner->GetAnimationInterface()->StopBehavior(EuphoriaBehaviorCRC::eSuperBlend);
+                        EUPHORIA_COUNT(eCountStartBehavior);
                         mpOwner->GetAnimationInterface()->StartBehavior(EuphoriaBehaviorCRC::eBlendToAnim, pPhaseTwoData->GetPOD());
                         mBlendPhase = ePhaseTwo;
                     }
@@ -289,7 +410,9 @@ namespace euphoria
                 Vec3 rayTo;
                 Vec3AddScaled(rayTo, rayFrom, vecTo, maxHeight);
 
-                if (!mpOwner->GetEngineInterface()->CheckLOS(rayFrom, rayTo, 0.0f, RoninPhysics::kAll, NULL, mpOwner->GetRenID()))
+                EUPHORIA_COUNT(eCountCheckLOS);
+                EUPHORIA_DEBUG_LINE(eDrawProbeRays, rayFrom, rayTo, kDebugColorWhite);
+                if (!EUPHORIA_REPLAY_RESULT(bool, mpOwner->GetEngineInterface()->CheckLOS(rayFrom, rayTo, 0.0f, RoninPhysics::kAll, NULL, mpOwner->GetRenID())))
                 {
                     return true;
                 }
@@ -304,8 +427,19 @@ namespace euphoria
      */
     float BlendPerformance::InitiateBlend(float fGetupBlendTime, GetupPosition ePosition, float turnCorrect, const RavenMath::Vec3& offVec)
     {
-        float fSecondBlendTime = fGetupBlendTime * 0.75f;
+        const BlendProfile& rProfile = gpEuphoriaManager->GetBlendProfile(ePosition);
+
+        //AMAC  Upright idle anim is too long, its profile scales the blend down until the anim is fixed
+        fGetupBlendTime = fGetupBlendTime * rProfile.mBlendTimeScale;
+        mBlendDuration = fGetupBlendTime;
+
+        float fSecondBlendTime = fGetupBlendTime * rProfile.mPhaseTwoRatio;
+        if (rProfile.mbUseTurnCorrection)
+        {
+            fSecondBlendTime *= turnCorrect;
+        }
         float fFirstBlendTime = fGetupBlendTime - fSecondBlendTime;
+        float fPhaseTwoScale = rProfile.mbPhaseTwoFixedFrames ? 1.0f : fSecondBlendTime;
 
         // ntoe: duration choice of 30 represents total blend time in a phase 
         //
@@ -322,108 +456,32 @@ namespace euphoria
         //
         // Any further work should be focused on getting mr. ragdoll to his 'lift position'.
         //
+        // Phase timings per position come from the manager's blend profiles, body
+        // groups and stiffness from the override tables
+        //
         // Phase 1
-        mPhaseOne.bodyStiffness			= 1.0f;
-        mPhaseOne.effectorRampDuration	= 15.0f * fFirstBlendTime;
-        mPhaseOne.coreBlendDuration		= 30.0f * fFirstBlendTime;
-        strcpy(mPhaseOne.group, "handsFeetHead");
+        mPhaseOne.effectorRampDuration	= rProfile.mPhaseOneEffectorRamp * fFirstBlendTime;
+        mPhaseOne.coreBlendDuration		= rProfile.mPhaseOneCoreBlend * fFirstBlendTime;
+        mPhaseOne.offVec = offVec;
         // Phase 2
-        mPhaseTwo.effectorRampDuration	= 1.0f * fSecondBlendTime;
-        mPhaseTwo.coreBlendDuration		= 5.0f * fSecondBlendTime;
-        mPhaseTwo.bodyBlendStart		= 0.0f * fSecondBlendTime;
-        mPhaseTwo.bodyBlendDuration		= 5.0f * fSecondBlendTime;
-        strcpy(mPhaseTwo.group, "lower");
-
-        switch (ePosition)
-        {
-            case eGetupBack:
-                // overidden as the easyest to improve..... maybe
-                fSecondBlendTime = fGetupBlendTime * 0.70f;
-                fFirstBlendTime = fGetupBlendTime - fSecondBlendTime;
-                // Phase 1
-                mPhaseOne.bodyStiffness			= 1.0f;
-                mPhaseOne.effectorRampDuration	= 0.0f * fFirstBlendTime;
-                mPhaseOne.coreBlendDuration		= 30.0f * fFirstBlendTime;
-                strcpy(mPhaseOne.group, "handsFeetHead");
-                // Phase 2
-                mPhaseTwo.effectorRampDuration	= 1.0f * fSecondBlendTime;
-                mPhaseTwo.coreBlendDuration		= 5.0f * fSecondBlendTime;
-                mPhaseTwo.bodyBlendStart		= 0.0f * fSecondBlendTime;
-                mPhaseTwo.bodyBlendDuration		= 5.0f * fSecondBlendTime;
-                strcpy(mPhaseTwo.group, "all");
-                break;
-
-            case eGetupLeft:
-            case eGetupRight:
-                // the stationary timer settings could need tweeking for this case
-                fSecondBlendTime = fGetupBlendTime * 0.80f;
-                fFirstBlendTime = fGetupBlendTime - fSecondBlendTime;
-                // Phase 1
-                mPhaseOne.bodyStiffness			= 1.0f;
-                mPhaseOne.effectorRampDuration	= 0.0f * fFirstBlendTime;
-                mPhaseOne.coreBlendDuration		= 30.0f * fFirstBlendTime;
-                strcpy(mPhaseOne.group, "lower");
-                // Phase 2
-                mPhaseTwo.effectorRampDuration	= 1.0f * fSecondBlendTime;
-                mPhaseTwo.coreBlendDuration		= 5.0f * fSecondBlendTime;
-                mPhaseTwo.bodyBlendStart		= 0.0f * fSecondBlendTime;
-                mPhaseTwo.bodyBlendDuration		= 5.0f * fSecondBlendTime;
-                strcpy(mPhaseTwo.group, "all");
-                break;
+        mPhaseTwo.effectorRampDuration	= rProfile.mPhaseTwoEffectorRamp * fPhaseTwoScale;
+        mPhaseTwo.coreBlendDuration		= rProfile.mPhaseTwoCoreBlend * fPhaseTwoScale;
+        mPhaseTwo.bodyBlendStart		= rProfile.mPhaseTwoBodyBlendStart * fPhaseTwoScale;
+        mPhaseTwo.bodyBlendDuration		= rProfile.mPhaseTwoBodyBlendDuration * fPhaseTwoScale;
 
-            case eGetupUpright:
-                // I've not touched this as it may require special treatment [MH]
-                //AMAC  Upright idle anim is too long.  Once this anim is fixed delete all lines with 'AMAC'
-                fGetupBlendTime = fGetupBlendTime * 0.25f;	//AMAC
-                mBlendDuration = fGetupBlendTime;			//AMAC
-
-                fSecondBlendTime = fGetupBlendTime * 0.26f;
-                fFirstBlendTime = fGetupBlendTime - fSecondBlendTime;
-                // Phase 1
-                mPhaseOne.bodyStiffness			= 1.0f;
-                mPhaseOne.effectorRampDuration	= 10.0f * fFirstBlendTime;
-                mPhaseOne.coreBlendDuration		= 20.0f * fFirstBlendTime;
-                strcpy(mPhaseOne.group, "handsFeetHeadPelvis");	// All Core group causing sinking bug
-                // Phase 2
-                mPhaseTwo.effectorRampDuration	= 5.0f;
-                mPhaseTwo.coreBlendDuration		= 10.0f;
-                mPhaseTwo.bodyBlendStart		= 0.0f;
-                mPhaseTwo.bodyBlendDuration		= 20.0f;
-                strcpy(mPhaseTwo.group, "all");
-                break;
-
-            case eGetupFront:
-                // some leg bending perhaps due to anims being offset too much, note that our pd
-                // controllers in super blend ignore y-rotation...
-                fSecondBlendTime = fGetupBlendTime * 0.80f * turnCorrect;
-                fFirstBlendTime = fGetupBlendTime - fSecondBlendTime;
-                // Phase 1
-                mPhaseOne.bodyStiffness			= 1.0f;
-                mPhaseOne.effectorRampDuration	= 0.0f * fFirstBlendTime;
-                mPhaseOne.coreBlendDuration		= 30.0f * fFirstBlendTime;
-                strcpy(mPhaseOne.group, "handsFeetHeadPelvis");
-                // Phase 2
-                mPhaseTwo.effectorRampDuration	= 1.0f * fSecondBlendTime;
-                mPhaseTwo.coreBlendDuration		= 5.0f * fSecondBlendTime;
-                mPhaseTwo.bodyBlendStart		= 0.0f * fSecondBlendTime;
-                mPhaseTwo.bodyBlendDuration		= 5.0f * fSecondBlendTime;
-                strcpy(mPhaseTwo.group, "all");
-                break;
-        }
-
-        mPhaseOne.offVec = offVec;
-        mPhaseOne.effectorRampDuration = 20.0f * fFirstBlendTime;
+        mpPhaseTwoOverrides = &msBlendToAnimOverrideTable[ePosition];
 
         ParameterOverrideDataInterface* pPhaseOneData = mpOwner->GetAnimationInterface()->GetPODI();
-        pPhaseOneData->SetFloat(0, mPhaseOne.bodyStiffness);
+        ApplyOverrideBlock(pPhaseOneData, msSuperBlendOverrideTable[ePosition]);
         pPhaseOneData->SetFloat(1, mPhaseOne.offVec.x);
         pPhaseOneData->SetFloat(2, mPhaseOne.offVec.y);
         pPhaseOneData->SetFloat(3, mPhaseOne.offVec.z);
         pPhaseOneData->SetInt(0, (int) mPhaseOne.effectorRampDuration);
         pPhaseOneData->SetInt(1, (int) mPhaseOne.coreBlendDuration);
-        pPhaseOneData->SetChar(0, mPhaseOne.group);
 
+        EUPHORIA_COUNT(eCountStopAllBehaviors);
         mpOwner->GetAnimationInterface()->StopAllBehaviors();
+        EUPHORIA_COUNT(eCountStartBehavior);
         mpOwner->GetAnimationInterface()->StartBehavior(EuphoriaBehaviorCRC::eSuperBlend, pPhaseOneData->GetPOD());
 
         return fSecondBlendTime;
@@ -445,19 +503,27 @@ namespace euphoria
     
         Vec3Set(vecTo, 1.0f, 0.0f, 0.0f);
         Vec3AddScaled(rayTo, rayFrom, vecTo, proxRange);
-        bool result1 = !mpOwner->GetEngineInterface()->CheckLOS(rayFrom, rayTo, 0.0f, nCollisionFlags, NULL, mpOwner->GetRenID());
+        EUPHORIA_COUNT(eCountCheckLOS);
+        EUPHORIA_DEBUG_LINE(eDrawProbeRays, rayFrom, rayTo, kDebugColorWhite);
+        bool result1 = !EUPHORIA_REPLAY_RESULT(bool, mpOwner->GetEngineInterface()->CheckLOS(rayFrom, rayTo, 0.0f, nCollisionFlags, NULL, mpOwner->GetRenID()));
 
         Vec3Set(vecTo, -1.0f, 0.0f, 0.0f);
         Vec3AddScaled(rayTo, rayFrom, vecTo, proxRange);
-        bool result2 = !mpOwner->GetEngineInterface()->CheckLOS(rayFrom, rayTo, 0.0f, nCollisionFlags, NULL, mpOwner->GetRenID());
+        EUPHORIA_COUNT(eCountCheckLOS);
+        EUPHORIA_DEBUG_LINE(eDrawProbeRays, rayFrom, rayTo, kDebugColorWhite);
+        bool result2 = !EUPHORIA_REPLAY_RESULT(bool, mpOwner->GetEngineInterface()->CheckLOS(rayFrom, rayTo, 0.0f, nCollisionFlags, NULL, mpOwner->GetRenID()));
 
         Vec3Set(vecTo, 0.0f, 0.0f, 1.0f);
         Vec3AddScaled(rayTo, rayFrom, vecTo, proxRange);
-        bool result3 = !mpOwner->GetEngineInterface()->CheckLOS(rayFrom, rayTo, 0.0f, nCollisionFlags, NULL, mpOwner->GetRenID());
+        EUPHORIA_COUNT(eCountCheckLOS);
+        EUPHORIA_DEBUG_LINE(eDrawProbeRays, rayFrom, rayTo, kDebugColorWhite);
+        bool result3 = !EUPHORIA_REPLAY_RESULT(bool, mpOwner->GetEngineInterface()->CheckLOS(rayFrom, rayTo, 0.0f, nCollisionFlags, NULL, mpOwner->GetRenID()));
 
         Vec3Set(vecTo, 0.0f, 0.0f, -1.0f);
         Vec3AddScaled(rayTo, rayFrom, vecTo, proxRange);
-        bool result4 = !mpOwner->GetEngineInterface()->CheckLOS(rayFrom, rayTo, 0.0f, nCollisionFlags, NULL, mpOwner->GetRenID());
+        EUPHORIA_COUNT(eCountCheckLOS);
+        EUPHORIA_DEBUG_LINE(eDrawProbeRays, rayFrom, rayTo, kDebugColorWhite);
+        bool result4 = !EUPHORIA_REPLAY_RESULT(bool, mpOwner->GetEngineInterface()->CheckLOS(rayFrom, rayTo, 0.0f, nCollisionFlags, NULL, mpOwner->GetRenID()));
 
         Vec3Set(*pOutVec, 0.0f, 0.0f, 0.0f);
 
@@ -512,7 +578,9 @@ namespace euphoria
                     pRPE->GetPosition(rayFrom);
                     Vec3Mul(rayTo, vecTo, hitThreshold);
                     Vec3Add(rayTo, rayFrom, rayTo);
-                    if (!mpOwner->GetEngineInterface()->CheckLOS(rayFrom, rayTo, 0.0f, nCollisionFlags, NULL, mpOwner->GetRenID()))
+                    EUPHORIA_COUNT(eCountCheckLOS);
+                    EUPHORIA_DEBUG_LINE(eDrawProbeRays, rayFrom, rayTo, kDebugColorWhite);
+                    if (!EUPHORIA_REPLAY_RESULT(bool, mpOwner->GetEngineInterface()->CheckLOS(rayFrom, rayTo, 0.0f, nCollisionFlags, NULL, mpOwner->GetRenID())))
                     {
                         ePosition = eGetupBack;
                         moveOut = 2.0f;
@@ -520,7 +588,9 @@ namespace euphoria
 
                     Vec3Mul(rayTo, vecTo, -hitThreshold);
                     Vec3Add(rayTo, rayFrom, rayTo);
-                    if (!mpOwner->GetEngineInterface()->CheckLOS(rayFrom, rayTo, 0.0f, nCollisionFlags, NULL, mpOwner->GetRenID()))
+                    EUPHORIA_COUNT(eCountCheckLOS);
+                    EUPHORIA_DEBUG_LINE(eDrawProbeRays, rayFrom, rayTo, kDebugColorWhite);
+                    if (!EUPHORIA_REPLAY_RESULT(bool, mpOwner->GetEngineInterface()->CheckLOS(rayFrom, rayTo, 0.0f, nCollisionFlags, NULL, mpOwner->GetRenID())))
                     {
                         ePosition = eGetupFront;
                         moveOut = 2.0f;
@@ -541,7 +611,9 @@ namespace euphoria
                     pRPE->GetPosition(rayFrom);
                     Vec3Mul(rayTo, vecTo, -hitThreshold);
                     Vec3Add(rayTo, rayFrom, rayTo);
-                    if (!mpOwner->GetEngineInterface()->CheckLOS(rayFrom, rayTo, 0.0f, nCollisionFlags, NULL, mpOwner->GetRenID()))
+                    EUPHORIA_COUNT(eCountCheckLOS);
+                    EUPHORIA_DEBUG_LINE(eDrawProbeRays, rayFrom, rayTo, kDebugColorWhite);
+                    if (!EUPHORIA_REPLAY_RESULT(bool, mpOwner->GetEngineInterface()->CheckLOS(rayFrom, rayTo, 0.0f, nCollisionFlags, NULL, mpOwner->GetRenID())))
                     {
                         ePosition = eGetupLeft;
 
@@ -552,7 +624,9 @@ namespace euphoria
 
                         Vec3Mul(rayTo, vecTo, hitThreshold);
                         Vec3Add(rayTo, rayFrom, rayTo);
-                        if (!mpOwner->GetEngineInterface()->CheckLOS(rayFrom, rayTo, 0.0f, nCollisionFlags, NULL, mpOwner->GetRenID()))
+                        EUPHORIA_COUNT(eCountCheckLOS);
+                        EUPHORIA_DEBUG_LINE(eDrawProbeRays, rayFrom, rayTo, kDebugColorWhite);
+                        if (!EUPHORIA_REPLAY_RESULT(bool, mpOwner->GetEngineInterface()->CheckLOS(rayFrom, rayTo, 0.0f, nCollisionFlags, NULL, mpOwner->GetRenID())))
                         {
                             ePosition = eGetupRight;
                         }
@@ -718,6 +792,7 @@ namespace euphoria
 
         AnimAngleParamsInterface* pAngleParams = mpOwner->GetAnimationInterface()->GetAnimAngleParamsInterface();
         pAngleParams->SetAngle(heading);
+        EUPHORIA_COUNT(eCountStartBlock);
         mpOwner->GetAnimationInterface()->StartBlock(choreCRC, blockCRC, pAngleParams->GetAnimParams(), NULL, true);
 
         return cPosition;
@@ -752,19 +827,116 @@ namespace euphoria
         AnimationCompPlugInInterface* pAnimComp = mpOwner->GetAnimationInterface();
         AnimAngleParamsInterface* pAngleParams = pAnimComp->GetAnimAngleParamsInterface();
         pAngleParams->SetAngle(heading);
+        EUPHORIA_COUNT(eCountStartBlock);
         pAnimComp->StartBlock(choreCRC, blockCRC, pAngleParams->GetAnimParams(), NULL, true);
     }
 
+    /*!
+     * Seeds the classifier with the position the blend was started for. That
+     * position has full confidence; every other position has to earn it.
+     */
+    void BlendPerformance::ResetGetupClassification(GetupPosition position)
+    {
+        for (int i = 0; i < eNumGetups; ++i)
+        {
+            mGetupConfidence[i] = 0.0f;
+        }
+        mGetupConfidence[position] = msGetupStableWindow;
+        mClassifiedPosition = position;
+        mfLastClassifyTime = 0.0f;
+
+        // Force a full classification on the first update
+        Vec3SetZero(mvClassifiedSpineUp);
+        Vec3SetZero(mvClassifiedSpineForward);
+    }
+
+    /*!
+     * Incremental version of EuphoriaComp::DetermineGetupPosition for use while
+     * blending. The full classification (with its support raycasts) is only re-run
+     * once the spine has rotated or travelled far enough to possibly change the
+     * answer. The raw result feeds a confidence score per position, and the
+     * position only changes once a new classification has held for
+     * msGetupStableWindow seconds, so single-frame flips no longer restart the blend.
+     *
+     * @note eGetupNone goes through the same hysteresis as every other position
+     */
+    GetupPosition BlendPerformance::UpdateGetupClassification()
+    {
+        static const Vec3 kUpIdentityVec = { 0.0f, 1.0f, 0.0f };
+        static const Vec3 kForwardIdentityVec = { 0.0f, 0.0f, 1.0f };
+
+        float timeInState = GetTimeInState();
+        float deltaTime = timeInState - mfLastClassifyTime;
+        mfLastClassifyTime = timeInState;
+
+        RoninPhysicsEntity* pRPE = mpOwner->GetAnimationInterface()->GetBodyPartByBone(BoneCRC::eSpine0);
+        Mat44 spineTransform;
+        if (!pRPE->GetTransform(spineTransform))
+        {
+            // Not in Euphoria anymore, nothing to be stable about
+            return eGetupNone;
+        }
+
+        Vec3 spinePos;
+        Vec3Set(spinePos, ROW_TRANSLATION(spineTransform));
+        Vec3 spineUp;
+        Mat33MulVec3(spineUp, spineTransform, kUpIdentityVec);
+        Vec3 spineForward;
+        Mat33MulVec3(spineForward, spineTransform, kForwardIdentityVec);
+
+        if ((Vec3Dot(spineUp, mvClassifiedSpineUp) < msReclassifyCosThreshold) ||
+            (Vec3Dot(spineForward, mvClassifiedSpineForward) < msReclassifyCosThreshold) ||
+            (Vec3DistSqr(spinePos, mvClassifiedSpinePos) > msReclassifyDistSqThreshold))
+        {
+            mClassifiedPosition = mpOwner->DetermineGetupPosition();
+            Vec3Set(mvClassifiedSpinePos, spinePos);
+            Vec3Set(mvClassifiedSpineUp, spineUp);
+            Vec3Set(mvClassifiedSpineForward, spineForward);
+        }
+
+        // The latest classification gains confidence, all others lose it
+        for (int i = 0; i < eNumGetups; ++i)
+        {
+            if (i == mClassifiedPosition)
+            {
+                mGetupConfidence[i] += deltaTime;
+                if (mGetupConfidence[i] > msGetupStableWindow)
+                {
+                    mGetupConfidence[i] = msGetupStableWindow;
+                }
+            }
+            else
+            {
+                mGetupConfidence[i] -= deltaTime;
+                if (mGetupConfidence[i] < 0.0f)
+                {
+                    mGetupConfidence[i] = 0.0f;
+                }
+            }
+        }
+
+        if (mGetupConfidence[mClassifiedPosition] >= msGetupStableWindow)
+        {
+            return mClassifiedPosition;
+        }
+
+        // Not stable yet, stick with what we are doing
+        return mParams.mInitialPosition;
+    }
+
     //
     // IDLE
     //
     void BlendPerformance::STATEFN_ENTER(IDLE)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(BlendPerformance, IDLE_ENTER);
+        EUPHORIA_ENTER_STATE(IDLE);
     }
 
     StateID BlendPerformance::STATEFN_UPDATE(IDLE)(const StateDataDefault& krStateData)
     {
-        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "BlendPerformance::IDLE\n");
+        EUPHORIA_PROFILE_SCOPE(BlendPerformance, IDLE_UPDATE);
+        EUPHORIA_TRACE0(eTraceBlend, eTraceVerbose, "BlendPerformance::IDLE\n");
         return STATEID_INVALID;
     }
 
@@ -782,6 +954,8 @@ namespace euphoria
     //
     void BlendPerformance::STATEFN_ENTER(TRANSITIONING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(BlendPerformance, TRANSITIONING_ENTER);
+        EUPHORIA_ENTER_STATE(TRANSITIONING);
         mpOwner->ResetStationaryTimer();
 
         Vec3 outVec;
@@ -803,6 +977,7 @@ namespace euphoria
 
     StateID BlendPerformance::STATEFN_UPDATE(TRANSITIONING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(BlendPerformance, TRANSITIONING_UPDATE);
         //  Animation Recovery Logic
         if (mpOwner->GetAnimationInterface()->IsBehaviorActiveAndDriving())
         {
@@ -829,6 +1004,7 @@ namespace euphoria
 
     void BlendPerformance::STATEFN_EXIT(TRANSITIONING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_COUNT(eCountStopAllBehaviors);
         mpOwner->GetAnimationInterface()->StopAllBehaviors();
     }
 
@@ -851,6 +1027,9 @@ namespace euphoria
     //
     void BlendPerformance::STATEFN_ENTER(INTERRUPT)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(BlendPerformance, INTERRUPT_ENTER);
+        EUPHORIA_ENTER_STATE(INTERRUPT);
+        EUPHORIA_COUNT(eCountStopAllBehaviors);
         mpOwner->GetAnimationInterface()->StopAllBehaviors();
 
         ParameterOverrideDataInterface* pData = mpOwner->GetAnimationInterface()->GetPODI();
@@ -861,6 +1040,7 @@ namespace euphoria
         out.y = -1.0f;
 
         pData->SetVector(0, out.x, out.y, out.z);
+        EUPHORIA_COUNT(eCountStartBehavior);
         mpOwner->GetAnimationInterface()->StartBehavior(EuphoriaBehaviorCRC::eHeadHit, pData->GetPOD());
 
         mpOwner->ResetStationaryTimer();
@@ -869,11 +1049,13 @@ namespace euphoria
 
     StateID BlendPerformance::STATEFN_UPDATE(INTERRUPT)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(BlendPerformance, INTERRUPT_UPDATE);
         return Rethink(false);
     }
 
     void BlendPerformance::STATEFN_EXIT(INTERRUPT)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_COUNT(eCountStopAllBehaviors);
         mpOwner->GetAnimationInterface()->StopAllBehaviors();
     }
 
@@ -893,7 +1075,11 @@ namespace euphoria
     //
     void BlendPerformance::STATEFN_ENTER(BONKED)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(BlendPerformance, BONKED_ENTER);
+        EUPHORIA_ENTER_STATE(BONKED);
+        EUPHORIA_COUNT(eCountStopAllBehaviors);
         mpOwner->GetAnimationInterface()->StopAllBehaviors();
+        EUPHORIA_COUNT(eCountStartBehavior);
         mpOwner->GetAnimationInterface()->StartBehavior(EuphoriaBehaviorCRC::eCatchFall);
         mpOwner->ResetStationaryTimer();
         mpOwner->SetStationaryTimer(mfStationarySpeedThreshold, mfStationaryWaitTime);
@@ -901,11 +1087,13 @@ namespace euphoria
 
     StateID BlendPerformance::STATEFN_UPDATE(BONKED)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(BlendPerformance, BONKED_UPDATE);
         return Rethink(false);
     }
 
     void BlendPerformance::STATEFN_EXIT(BONKED)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_COUNT(eCountStopAllBehaviors);
         mpOwner->GetAnimationInterface()->StopAllBehaviors();
     }
 
@@ -919,19 +1107,25 @@ namespace euphoria
     //
     void BlendPerformance::STATEFN_ENTER(STUCK)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(BlendPerformance, STUCK_ENTER);
+        EUPHORIA_ENTER_STATE(STUCK);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Blend::STUCK\n");
 
+        EUPHORIA_COUNT(eCountStopAllBehaviors);
         mpOwner->GetAnimationInterface()->StopAllBehaviors();
+        EUPHORIA_COUNT(eCountStartBehavior);
         mpOwner->GetAnimationInterface()->StartBehavior(EuphoriaBehaviorCRC::eUnstick);
     }
 
     StateID BlendPerformance::STATEFN_UPDATE(STUCK)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(BlendPerformance, STUCK_UPDATE);
         return Rethink(false);
     }
 
     void BlendPerformance::STATEFN_EXIT(STUCK)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_COUNT(eCountStopAllBehaviors);
         mpOwner->GetAnimationInterface()->StopAllBehaviors();
     }
 
@@ -945,79 +1139,32 @@ namespace euphoria
     //
     void BlendPerformance::STATEFN_ENTER(BLENDTO)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(BlendPerformance, BLENDTO_ENTER);
+        EUPHORIA_ENTER_STATE(BLENDTO);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Blend::BLENDTO\n");
 
+        ResetGetupClassification(mParams.mInitialPosition);
         DetermineGetupChoreSimple(mParams.mInitialPosition);
 
         ParameterOverrideDataInterface* pData = mpOwner->GetAnimationInterface()->GetPODI();
-        float statTime = 0.1f;
-        float minAvgVel = 2.0f;
-
-        // Defaults
-        pData->SetFloat(0, 1.0f);	// BodyStiffness
-        pData->SetFloat(1, 0.0f);	// BlendWeightStart
-        pData->SetFloat(2, 1.0f);	// BlendWeightEnd
-
-        pData->SetInt(0, 4);		// BlendRampDuration 
-        pData->SetInt(1, 10);		// BlendFrames 
-        pData->SetInt(2, 1);		// RootPart 
-        pData->SetInt(3, 1);		// AlignToPart 
+        ApplyOverrideBlock(pData, msBlendToFrameOverrideTable[mParams.mInitialPosition]);
 
-        pData->SetBool(0, true);	// TransformUpdate
-        pData->SetBool(1, false);	// DynamicKeyFraming
-        pData->SetBool(2, false);	// Debug
-
-        switch (mParams.mInitialPosition)
-        {
-            case eGetupBack:
-                pData->SetFloat(1, 0.0f); 	// BlendWeightStart
-                pData->SetFloat(2, 1.0f);	// BlendWeightEnd
-                pData->SetInt(0, 3);		// BlendRampDuration
-                pData->SetInt(1, 4);		// BlendFrames
-                statTime = 0.12f;
-                minAvgVel = 5.0f;
-                pData->SetInt(4, 6);		// blendErrorLimit
-                break;
-            case eGetupLeft:
-            case eGetupRight:
-                pData->SetFloat(1, 0.0f); 	// BlendWeightStart
-                pData->SetFloat(2, 1.0f);	// BlendWeightEnd
-                pData->SetInt(0, 3);		// BlendRampDuration
-                pData->SetInt(1, 4);		// BlendFrames
-                statTime = 0.12f;
-                minAvgVel = 0.45f;
-                pData->SetInt(4, 6);		// blendErrorLimit
-                break;
-            case eGetupUpright:
-                pData->SetFloat(1, 0.0f); 	// BlendWeightStart
-                pData->SetFloat(2, 1.0f);	// BlendWeightEnd
-                pData->SetInt(0, 2);		// BlendRampDuration
-                pData->SetInt(1, 2);		// BlendFrames
-                statTime = 0.1f;
-                minAvgVel = 5.0f;
-                pData->SetInt(4, 6);		// blendErrorLimit
-                break;
-            case eGetupFront:
-                pData->SetFloat(1, 0.0f); 	// BlendWeightStart
-                pData->SetFloat(2, 1.0f);	// BlendWeightEnd
-                pData->SetInt(0, 3);		// BlendRampDuration
-                pData->SetInt(1, 4);		// BlendFrames
-                statTime = 0.3f;
-                minAvgVel = 1.0f;
-                pData->SetInt(4, 6);		// blendErrorLimit
-                break;
-        }
+        const BlendProfile& rProfile = gpEuphoriaManager->GetBlendProfile(mParams.mInitialPosition);
+        pData->SetInt(0, rProfile.mBlendToRampDuration);    // BlendRampDuration
+        pData->SetInt(1, rProfile.mBlendToFrames);          // BlendFrames
 
+        EUPHORIA_COUNT(eCountStartBehavior);
         mpOwner->GetAnimationInterface()->StartBehavior(EuphoriaBehaviorCRC::eBlendToFrame, pData->GetPOD());
         mpOwner->ResetStationaryTimer();
-        mpOwner->SetStationaryTimer(minAvgVel, statTime);
+        mpOwner->SetStationaryTimer(rProfile.mStationarySpeedThreshold, rProfile.mStationaryWaitTime);
     }
 
     StateID BlendPerformance::STATEFN_UPDATE(BLENDTO)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(BlendPerformance, BLENDTO_UPDATE);
         if (mpOwner->GetAnimationInterface()->IsBehaviorActiveAndDriving())
         {
-            GetupPosition position = mpOwner->DetermineGetupPosition();
+            GetupPosition position = UpdateGetupClassification();
             if (position != eGetupNone)
             {
                 if (mParams.mInitialPosition != position)
@@ -1041,6 +1188,7 @@ namespace euphoria
 
     void BlendPerformance::STATEFN_EXIT(BLENDTO)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_COUNT(eCountStopAllBehaviors);
         mpOwner->GetAnimationInterface()->StopAllBehaviors();
     }
 
@@ -1049,6 +1197,7 @@ namespace euphoria
         switch (event.GetType())
         {
         case EuphoriaEvent::eBehaviorBlendFrameDone:
+            EUPHORIA_COUNT(eCountStopAllBehaviors);
             mpOwner->GetAnimationInterface()->StopAllBehaviors();
             mParams.mInitialPosition = mpOwner->DetermineGetupPosition();
             if (mParams.mInitialPosition != eGetupNone)
@@ -1066,14 +1215,18 @@ namespace euphoria
     //
     void BlendPerformance::STATEFN_ENTER(CLEANUP)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(BlendPerformance, CLEANUP_ENTER);
+        EUPHORIA_ENTER_STATE(CLEANUP);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "..stopping BLEND\n");
 
+        EUPHORIA_COUNT(eCountStopAllBehaviors);
         mpOwner->GetAnimationInterface()->StopAllBehaviors();
         mpOwner->GetAnimationInterface()->EndBehaviorControl();
     }
 
     StateID BlendPerformance::STATEFN_UPDATE(CLEANUP)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(BlendPerformance, CLEANUP_UPDATE);
         // SM will always end in CLEANUP and start in IDLE. Does this have to be explicit?
         return STATEID(IDLE); 
     }
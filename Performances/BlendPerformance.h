@@ -13,6 +13,7 @@ namespace euphoria
 {
     // FORWARD DECLARATIONS
     class BlendPerformance;
+    struct OverrideBlock;
 
     // TYPEDEFS
 	typedef Ronin::StateMachine<BlendPerformance, const Ronin::StateDataDefault, const EuphoriaEvent> BlendStateController;
@@ -33,10 +34,8 @@ namespace euphoria
 
         struct PhaseOneParams
         {
-            float bodyStiffness;
             float effectorRampDuration;   // this is a float but for some reason the NM behavior takes an int
             float coreBlendDuration;      // this is a float but for some reason the NM behavior takes an int
-            char group[64];
             RavenMath::Vec3 offVec;
         };
 
@@ -46,7 +45,19 @@ namespace euphoria
             float coreBlendDuration;      // this is a float but for some reason the NM behavior takes an int
             float bodyBlendStart;         // this is a float but for some reason the NM behavior takes an int
             float bodyBlendDuration;      // this is a float but for some reason the NM behavior takes an int
-            char group[64];
+        };
+
+        //! What TRANSITIONING and BLENDTO keep between updates, for a hot load
+        struct ResumeData
+        {
+            GetupPosition initialPosition;
+            GetupPosition phaseTwoPosition;   // row of msBlendToAnimOverrideTable, eGetupNone if unset
+            Phase blendPhase;
+            float blendStartTime;
+            float blendDuration;
+            float blendPhaseTwoStart;
+            float lastClassifyTime;
+            PhaseTwoParams phaseTwo;
         };
 
     private:
@@ -56,9 +67,14 @@ namespace euphoria
         static const crc32_t msParameterizedBlockTable[eNumGetups];
         static const crc32_t msNonParameterizedChoreTable[eNumGetups];
         static const crc32_t msNonParameterizedBlockTable[eNumGetups];
+        static const OverrideBlock msBlendToFrameOverrideTable[eNumGetups];
+        static const OverrideBlock msSuperBlendOverrideTable[eNumGetups];
+        static const OverrideBlock msBlendToAnimOverrideTable[eNumGetups];
+        static const float msReclassifyCosThreshold;
+        static const float msReclassifyDistSqThreshold;
+        static const float msGetupStableWindow;
 
         // MEMBERS
-        Ronin::StateMachineInstance* mpStateMachine;
 		BlendParams mParams;
 
         // Blending members
@@ -70,6 +86,15 @@ namespace euphoria
 		// Parameters
 		PhaseOneParams mPhaseOne;
 		PhaseTwoParams mPhaseTwo;
+		const OverrideBlock* mpPhaseTwoOverrides;
+
+        // Getup classification (BLENDTO)
+        float mGetupConfidence[eNumGetups];
+        GetupPosition mClassifiedPosition;
+        RavenMath::Vec3 mvClassifiedSpinePos;
+        RavenMath::Vec3 mvClassifiedSpineUp;
+        RavenMath::Vec3 mvClassifiedSpineForward;
+        float mfLastClassifyTime;
 
         // UNIMPLEMENTED METHODS
         // Prevent copying and assignment
@@ -78,6 +103,8 @@ namespace euphoria
 
         // METHODS
         BlendStateController& GetStateController();
+        virtual void SaveResumeData(unsigned char* pData) const;
+        virtual void LoadResumeData(const unsigned char* pData);
 
 		// helpers
 		bool CanRecoverThink();
@@ -93,6 +120,8 @@ namespace euphoria
 		void DetermineGetupChoreSimple(GetupPosition position);
 		void FindParameterizedChore(GetupPosition position, crc32_t* pChoreCRC, crc32_t* pBlockCRC);
 		void FindNonParameterizedChore(GetupPosition position, crc32_t* pChoreCRC, crc32_t* pBlockCRC);
+		void ResetGetupClassification(GetupPosition position);
+		GetupPosition UpdateGetupClassification();
 
         // STATES
         DECLARE_STATE_EVENT(IDLE, const EuphoriaEvent);
@@ -116,6 +145,7 @@ namespace euphoria
 
         void Initialize(const DefEuphoriaPerformanceBlendSettings& params);
 		void SetParams(const BlendParams& params);
+        void StartGetupChore(const BlendParams& params);
 
         // ACCESSORS
 
@@ -7,6 +7,8 @@ EPAPerformance.cpp
 #include "EuphoriaBehaviorCRC.h"
 #include "EuphoriaEvent.h"
 #include "EuphoriaComp.h"
+#include "EuphoriaProfiler.h"
+#include "EuphoriaTrace.h"
 #include "EuphoriaUtilities.h"
 // Schemas
 #include "DefEuphoriaPerformance.schema.h"
@@ -28,6 +30,11 @@ namespace euphoria
 	DEFINE_STATE(EPAPerformance, RUNNING);
 	DEFINE_STATE(EPAPerformance, CLEANUP);
 
+	EUPHORIA_PROFILE_DEFINE_PERFORMANCE(EPAPerformance);
+	EUPHORIA_PROFILE_DEFINE_STATE(EPAPerformance, IDLE);
+	EUPHORIA_PROFILE_DEFINE_STATE(EPAPerformance, RUNNING);
+	EUPHORIA_PROFILE_DEFINE_STATE(EPAPerformance, CLEANUP);
+
     // This is not in GetStateController on purpose
     static bool sEPAControllerInitialized = false;
 
@@ -71,6 +78,7 @@ namespace euphoria
 	 */
 	void EPAPerformance::Think(float elapsedTime)
 	{
+		EUPHORIA_PROFILE_SCOPE(EPAPerformance, Think);
 		mpStateMachine->Advance(elapsedTime);
 	}
 
@@ -79,6 +87,7 @@ namespace euphoria
 	 */
 	void EPAPerformance::OnEvent(const EuphoriaEvent& event)
 	{
+		EUPHORIA_PROFILE_SCOPE(EPAPerformance, OnEvent);
 		mpStateMachine->OnEvent(event);
 	}
 
@@ -130,10 +139,13 @@ namespace euphoria
     //
     void EPAPerformance::STATEFN_ENTER(IDLE)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(EPAPerformance, IDLE_ENTER);
+        EUPHORIA_ENTER_STATE(IDLE);
     }
 
     StateID EPAPerformance::STATEFN_UPDATE(IDLE)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(EPAPerformance, IDLE_UPDATE);
         return STATEID_INVALID;
     }
 
@@ -151,6 +163,8 @@ namespace euphoria
     //
     void EPAPerformance::STATEFN_ENTER(RUNNING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(EPAPerformance, RUNNING_ENTER);
+        EUPHORIA_ENTER_STATE(RUNNING);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EPA::RUNNING ENTERED\n");
 
         // Set conditions for recovery
@@ -162,7 +176,8 @@ namespace euphoria
 
     StateID EPAPerformance::STATEFN_UPDATE(RUNNING)(const StateDataDefault& krStateData)
     {
-        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EPA::RUNNING...\n");
+        EUPHORIA_PROFILE_SCOPE(EPAPerformance, RUNNING_UPDATE);
+        EUPHORIA_TRACE0(eTraceEPA, eTraceVerbose, "EPA::RUNNING...\n");
 
         //if (ShouldFallingPerformanceTakeOver(mpOwner))
         //{
@@ -210,7 +225,7 @@ namespace euphoria
 
 			// check for collisions
 			case EuphoriaEvent::eBehaviorCollision:
-				//if ((mpStateMachine->GetTimeInCurrentState() - mCheckStartTime) > msCheckCollisionDelay)
+				//if ((GetTimeInState() - mCheckStartTime) > msCheckCollisionDelay)
 				//{
 				//	LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Collision\n");
 				//	return STATEID(CRUNCH);
@@ -219,7 +234,7 @@ namespace euphoria
 
 			// check motion transfer to see if character has been over deformed
 			case EuphoriaEvent::eBehaviorMotionTransferOut:
-                //if ((mpStateMachine->GetTimeInCurrentState() - mCheckStartTime) > msCheckTransferDelay)
+                //if ((GetTimeInState() - mCheckStartTime) > msCheckTransferDelay)
                 //{
                 //    LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "MotionTransfer\n");
                 //    return STATEID(CRUNCH);
@@ -235,6 +250,8 @@ namespace euphoria
     //
     void EPAPerformance::STATEFN_ENTER(CLEANUP)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(EPAPerformance, CLEANUP_ENTER);
+        EUPHORIA_ENTER_STATE(CLEANUP);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "EPA::CLEANUP ENTERED\n");
 
         AnimationCompPlugInInterface* pAnimation = mpOwner->GetAnimationInterface();
@@ -246,6 +263,7 @@ namespace euphoria
 
     StateID EPAPerformance::STATEFN_UPDATE(CLEANUP)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(EPAPerformance, CLEANUP_UPDATE);
         // SM will always end in CLEANUP and start in IDLE. Does this have to be explicit?
         return STATEID(IDLE); 
     }
@@ -31,7 +31,6 @@ namespace euphoria
         static EPAStateController msStateController;
 
 		// MEMBERS
-        Ronin::StateMachineInstance* mpStateMachine;
 		EPAParams mParams;
 
         // Reference to the owning component's GrabbedEdgeInfo for convenience
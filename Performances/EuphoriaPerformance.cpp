@@ -1,4 +1,7 @@
 #include "EuphoriaPerformance.h"
+#include "EuphoriaHotLoad.h"
+
+#include <string.h>
 
 namespace euphoria
 {
@@ -12,7 +15,8 @@ namespace euphoria
      * @note Default recovery parameters are set such that the NPC will NOT recover.
      */
     EuphoriaPerformance::EuphoriaPerformance(EuphoriaComp* pOwner)
-        : mpOwner(pOwner), mfStationarySpeedThreshold(0.0f), mfStationaryWaitTime(0.0f)
+        : mpOwner(pOwner), mpStateMachine(NULL), mfStationarySpeedThreshold(0.0f), mfStationaryWaitTime(0.0f),
+          mStateID(STATEID_INVALID), mfStateTimeOffset(0.0f), mbResuming(false)
     {
     }
 
@@ -22,4 +26,45 @@ namespace euphoria
     EuphoriaPerformance::~EuphoriaPerformance()
     {
     }
+
+    /*!
+     * Captures the current state, the time spent in it and whatever the
+     * performance keeps between updates, for a hot load.
+     */
+    void EuphoriaPerformance::SaveResumeState(PerformanceResumeState& rState) const
+    {
+        rState.mStateID = mStateID;
+        rState.mfTimeInState = GetTimeInState();
+        memset(rState.mData, 0, sizeof(rState.mData));
+        SaveResumeData(rState.mData);
+    }
+
+    /*!
+     * Used instead of Start after a hot load. The parameters must already be
+     * set. The saved state is re-entered without its ENTER side effects (see
+     * EUPHORIA_ENTER_STATE), since the agent carried on running it, and the
+     * state's timer picks up where it was.
+     */
+    void EuphoriaPerformance::Resume(const PerformanceResumeState& rState)
+    {
+        LoadResumeData(rState.mData);
+
+        mbResuming = true;
+        mpStateMachine->ManualTransition(rState.mStateID);
+        mbResuming = false;
+
+        mfStateTimeOffset = rState.mfTimeInState;
+    }
+
+    /*!
+     * Performances whose states keep members between updates override these
+     * to carry them across a hot load, in at most kMaxDataSize bytes.
+     */
+    void EuphoriaPerformance::SaveResumeData(unsigned char* ) const
+    {
+    }
+
+    void EuphoriaPerformance::LoadResumeData(const unsigned char* )
+    {
+    }
 }
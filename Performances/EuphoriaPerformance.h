@@ -6,6 +6,7 @@ EuphoriaPerformance.h
 #define EUPHORIA_PERFORMANCE_H
 
 #include "LECAlign.h"
+#include "StateController.h"
 #include "crc32.h"
 
 namespace Ronin
@@ -18,6 +19,7 @@ namespace euphoria
 {
     // FORWARD DECLARATIONS
     class EuphoriaEvent;
+    struct PerformanceResumeState;
 
     /*!
      *
@@ -29,11 +31,23 @@ namespace euphoria
     protected:
         // MEMBERS
         Ronin::EuphoriaComp* mpOwner;
+        Ronin::StateMachineInstance* mpStateMachine;
 
         // For recovery to hard-keyed animation
         float mfStationarySpeedThreshold;
         float mfStationaryWaitTime;
 
+        // Hot load
+        Ronin::StateID mStateID;                    //!< Last state entered
+        float mfStateTimeOffset;                    //!< Time spent in mStateID before a hot load
+        bool mbResuming;                            //!< Resume is re-entering mStateID
+
+        // METHODS
+        inline bool EnterState(Ronin::StateID stateID);
+        inline float GetTimeInState() const;
+        virtual void SaveResumeData(unsigned char* pData) const;
+        virtual void LoadResumeData(const unsigned char* pData);
+
     public:
         // CREATORS
         EuphoriaPerformance(Ronin::EuphoriaComp* pOwner);
@@ -44,9 +58,66 @@ namespace euphoria
         virtual void Stop() = 0;
         virtual void Think(float elapsedTime) = 0;
 		virtual void OnEvent(const EuphoriaEvent& event) = 0;
+        inline void SetStationarySettings(float speedThreshold, float waitTime);
+        void Resume(const PerformanceResumeState& rState);
         
         // ACCESSORS
+        inline float GetStationarySpeedThreshold() const;
+        inline float GetStationaryWaitTime() const;
+        void SaveResumeState(PerformanceResumeState& rState) const;
     } END_DECLARE_ALIGNED;
+
+    /*!
+     * Opens every state's ENTER function. When Resume re-enters a state after a
+     * hot load the agent is already running it, so the rest of ENTER (impulses,
+     * behavior starts, timers) is skipped.
+     */
+#define EUPHORIA_ENTER_STATE(State) \
+    if (!EnterState(STATEID(State))) \
+    { \
+        return; \
+    }
+
+    // INLINES
+    /*!
+     * Sets the recovery conditions directly, for settings that do not come from
+     * a DefEuphoriaPerformance asset (see SettingsBundle).
+     */
+    void EuphoriaPerformance::SetStationarySettings(float speedThreshold, float waitTime)
+    {
+        mfStationarySpeedThreshold = speedThreshold;
+        mfStationaryWaitTime = waitTime;
+    }
+
+    /*!
+     * Records the state being entered. Returns false when Resume is re-entering
+     * the saved state, in which case ENTER must not repeat its side effects.
+     */
+    bool EuphoriaPerformance::EnterState(Ronin::StateID stateID)
+    {
+        mStateID = stateID;
+        mfStateTimeOffset = 0.0f;
+        return !mbResuming;
+    }
+
+    /*!
+     * Time in the current state, carried across a hot load. Use this rather than
+     * the state machine's own timer, which restarts when the state is resumed.
+     */
+    float EuphoriaPerformance::GetTimeInState() const
+    {
+        return mpStateMachine->GetTimeInCurrentState() + mfStateTimeOffset;
+    }
+
+    float EuphoriaPerformance::GetStationarySpeedThreshold() const
+    {
+        return mfStationarySpeedThreshold;
+    }
+
+    float EuphoriaPerformance::GetStationaryWaitTime() const
+    {
+        return mfStationaryWaitTime;
+    }
 }
 
 // EUPHORIA_PERFORMANCE_H
@@ -7,6 +7,10 @@ ExplosionPerformance.cpp
 #include "AnimationComponentPlugInInterface.h"
 #include "EuphoriaBehaviorCRC.h"
 #include "EuphoriaComp.h"
+#include "EuphoriaNameCRC.h"
+#include "EuphoriaOverrideBlock.h"
+#include "EuphoriaProfiler.h"
+#include "EuphoriaTrace.h"
 #include "EuphoriaUtilities.h"
 #include "FortuneGamePlugInInterface.h"
 // Schemas
@@ -19,15 +23,35 @@ namespace euphoria
     using namespace Ronin;
     using namespace lec;
 
+    // LOCAL CONST INITIALIZATION
+    namespace
+    {
+        // @note Hard-Coded tweaks!
+        const float kNpcMassInKG = 75.0f;
+        const float kImpulseFudgeFactor = 5.0f;
+        const float kMaxImpulseMagnitude = 100.0f;
+    }
+
     // Define statics
     // State controller
     ExplosionStateController ExplosionPerformance::msStateController;
 
+    // Behavior override blocks
+    // Spread, Duration | Apply total force each frame | Impulse (patched) | Part to apply the force to
+    const OverrideBlock ExplosionPerformance::msForceOverrides = {
+        2, { 1.0f, 0.1f }, 0, { 0 }, 1, { false }, 1, { { 0.0f, 0.0f, 0.0f } }, 1, { EuphoriaNameCRC::eSpine2 }, 0, { NULL }
+    };
+
     // Define all of the states for this Performance
     DEFINE_STATE(ExplosionPerformance, IDLE);
     DEFINE_STATE(ExplosionPerformance, EXPLODING);
     DEFINE_STATE(ExplosionPerformance, CLEANUP);
 
+    EUPHORIA_PROFILE_DEFINE_PERFORMANCE(ExplosionPerformance);
+    EUPHORIA_PROFILE_DEFINE_STATE(ExplosionPerformance, IDLE);
+    EUPHORIA_PROFILE_DEFINE_STATE(ExplosionPerformance, EXPLODING);
+    EUPHORIA_PROFILE_DEFINE_STATE(ExplosionPerformance, CLEANUP);
+
     // This is not in GetStateController on purpose
     static bool sExplosionControllerInitialized = false;
 
@@ -63,12 +87,14 @@ namespace euphoria
      */
     void ExplosionPerformance::Think(float elapsedTime)
     {
+        EUPHORIA_PROFILE_SCOPE(ExplosionPerformance, Think);
         mpStateMachine->Advance(elapsedTime);
     }
 
     void ExplosionPerformance::OnEvent(const EuphoriaEvent& event)
     {
-        LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Explosion NOT handling events\n");
+        EUPHORIA_PROFILE_SCOPE(ExplosionPerformance, OnEvent);
+        EUPHORIA_TRACE0(eTraceExplosion, eTraceInfo, "Explosion NOT handling events\n");
     }
 
     /*!
@@ -121,10 +147,13 @@ namespace euphoria
     //
     void ExplosionPerformance::STATEFN_ENTER(IDLE)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ExplosionPerformance, IDLE_ENTER);
+        EUPHORIA_ENTER_STATE(IDLE);
     }
 
     StateID ExplosionPerformance::STATEFN_UPDATE(IDLE)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ExplosionPerformance, IDLE_UPDATE);
         return STATEID_INVALID;
     }
 
@@ -137,6 +166,8 @@ namespace euphoria
     //
     void ExplosionPerformance::STATEFN_ENTER(EXPLODING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ExplosionPerformance, EXPLODING_ENTER);
+        EUPHORIA_ENTER_STATE(EXPLODING);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "ExplosionPerformance::EXPLODING ENTERED\n");
 
         // Set conditions for recovery
@@ -144,39 +175,59 @@ namespace euphoria
 
         // Prepare overrides for the force behavior
         Vec3 vImpulse;
-        Vec3Set(vImpulse, mParams.mNormal);
-
-        // @note Hard-Coded tweaks!
-        const float npcMassInKG = 75.0f;
-        const float fudgeFactor = 5.0f;
-        const float maxMagnitude = 100.0f;
-
-        float magImpulse = RavenMath::Sqrt(mParams.mSourceMass / npcMassInKG) * mParams.mVelocity * fudgeFactor;
-        Vec3Mul(vImpulse, vImpulse, magImpulse);
-
-        // Keep the force magnitude within limits
-        float magnitude = Vec3Mag(vImpulse);
-        if (magnitude > maxMagnitude)
-        {
-            Vec3Mul(vImpulse, vImpulse, maxMagnitude/magnitude);
-        }
+        ComputeImpulse(mParams, vImpulse);
 
         // Add some lift to the force
         // Set overrides for force behavior
         ParameterOverrideDataInterface* pData = mpOwner->GetAnimationInterface()->GetPODI();
 
+        ApplyOverrideBlock(pData, msForceOverrides);
         pData->SetVector(0, vImpulse.x, vImpulse.y, vImpulse.z);
-        pData->SetFloat(0, 1.0f);                                    // Spread
-        pData->SetFloat(1, 0.1f);                                    // Duration
-        pData->SetPart(0, CRCINIT("Spine2"));
-        pData->SetBool(0, false);                                    // Apply total force each frame
 
         // Start force behavior
+        EUPHORIA_COUNT(eCountStartBehavior);
         mpOwner->GetAnimationInterface()->StartBehavior(EuphoriaBehaviorCRC::eForce, pData->GetPOD());
     }
 
+    /*!
+     * The force the explosion puts on an NPC, scaled by the source's mass and
+     * clamped. Also used for the passive ragdoll fallback.
+     */
+    void ExplosionPerformance::ComputeImpulse(const ExplosionParams& params, Vec3& outImpulse)
+    {
+        Vec3Set(outImpulse, params.mNormal);
+
+        // A batched explosion has already done the work for a unit normal
+        if (params.mImpulseScale > 0.0f)
+        {
+            Vec3Mul(outImpulse, outImpulse, params.mImpulseScale);
+            return;
+        }
+
+        float magImpulse = RavenMath::Sqrt(params.mSourceMass / kNpcMassInKG) * params.mVelocity * kImpulseFudgeFactor;
+        Vec3Mul(outImpulse, outImpulse, magImpulse);
+
+        // Keep the force magnitude within limits
+        float magnitude = Vec3Mag(outImpulse);
+        if (magnitude > kMaxImpulseMagnitude)
+        {
+            Vec3Mul(outImpulse, outImpulse, kMaxImpulseMagnitude/magnitude);
+        }
+    }
+
+    /*!
+     * The clamped impulse magnitude for a unit normal. The same for every NPC an
+     * explosion reaches, so EuphoriaManager::Explode works it out once.
+     */
+    float ExplosionPerformance::ComputeImpulseScale(float sourceMass, float velocity)
+    {
+        const float magImpulse = RavenMath::Sqrt(sourceMass / kNpcMassInKG) * velocity * kImpulseFudgeFactor;
+        return (magImpulse < kMaxImpulseMagnitude) ? magImpulse : kMaxImpulseMagnitude;
+    }
+
     StateID ExplosionPerformance::STATEFN_UPDATE(EXPLODING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ExplosionPerformance, EXPLODING_UPDATE);
         if (ShouldFallingPerformanceTakeOver(mpOwner))
         {
             FallingParams fp;
@@ -196,11 +247,14 @@ namespace euphoria
     //
     void ExplosionPerformance::STATEFN_ENTER(CLEANUP)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ExplosionPerformance, CLEANUP_ENTER);
+        EUPHORIA_ENTER_STATE(CLEANUP);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "ExplosionPerformance::CLEANUP\n");
     }
 
     StateID ExplosionPerformance::STATEFN_UPDATE(CLEANUP)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ExplosionPerformance, CLEANUP_UPDATE);
         // SM will always end in CLEANUP and start in IDLE. Does this have to be explicit?
         return STATEID(IDLE); 
     }
@@ -16,6 +16,7 @@ namespace euphoria
 {
     // FORWARD DECLARATIONS
     class ExplosionPerformance;
+    struct OverrideBlock;
 
     // TYPEDEFS
     typedef Ronin::StateMachine<ExplosionPerformance> ExplosionStateController;
@@ -30,9 +31,9 @@ namespace euphoria
     private:
         // STATIC MEMBERS
         static ExplosionStateController msStateController;
+        static const OverrideBlock msForceOverrides;
 
         // MEMBERS
-        Ronin::StateMachineInstance* mpStateMachine;
         ExplosionParams mParams;
 
         // UNIMPLEMENTED METHODS
@@ -64,6 +65,9 @@ namespace euphoria
 
         // ACCESSORS
 
+        // STATIC ACCESSORS
+        static void ComputeImpulse(const ExplosionParams& params, RavenMath::Vec3& outImpulse);
+        static float ComputeImpulseScale(float sourceMass, float velocity);
     } END_DECLARE_ALIGNED;
 }
 
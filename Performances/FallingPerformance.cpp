@@ -6,6 +6,11 @@
 #include "EdgeSystemManagerPlugInInterface.h"       // REMOVE??
 #include "EuphoriaBehaviorCRC.h"
 #include "EuphoriaComp.h"
+#include "EuphoriaDebugDraw.h"
+#include "EuphoriaNameCRC.h"
+#include "EuphoriaOverrideBlock.h"
+#include "EuphoriaProfiler.h"
+#include "EuphoriaReplay.h"
 #include "EuphoriaStruct.h"
 #include "EuphoriaUtilities.h"
 #include "FortuneGameCompPlugInInterface.h"
@@ -29,6 +34,12 @@ namespace euphoria
     // State controller
     FallingStateController FallingPerformance::msStateController;
 
+    // Behavior override blocks
+    // Spread, Duration | Apply total force each frame | Impulse (patched) | Part to apply the force to
+    const OverrideBlock FallingPerformance::msCarryOverrides = {
+        2, { 1.0f, 0.1f }, 0, { 0 }, 1, { false }, 1, { { 0.0f, 0.0f, 0.0f } }, 1, { EuphoriaNameCRC::eSpine2 }, 0, { NULL }
+    };
+
     // Define all of the states for this Performance
     DEFINE_STATE(FallingPerformance, IDLE);
     DEFINE_STATE(FallingPerformance, FALLING);
@@ -40,6 +51,17 @@ namespace euphoria
     DEFINE_STATE(FallingPerformance, GRABBING);
     DEFINE_STATE(FallingPerformance, CLEANUP);
 
+    EUPHORIA_PROFILE_DEFINE_PERFORMANCE(FallingPerformance);
+    EUPHORIA_PROFILE_DEFINE_STATE(FallingPerformance, IDLE);
+    EUPHORIA_PROFILE_DEFINE_STATE(FallingPerformance, FALLING);
+    EUPHORIA_PROFILE_DEFINE_STATE(FallingPerformance, CATCH_HEAD);
+    EUPHORIA_PROFILE_DEFINE_STATE(FallingPerformance, CATCH_FEET);
+    EUPHORIA_PROFILE_DEFINE_STATE(FallingPerformance, REACT);
+    EUPHORIA_PROFILE_DEFINE_STATE(FallingPerformance, HANGING);
+    EUPHORIA_PROFILE_DEFINE_STATE(FallingPerformance, SLIDING);
+    EUPHORIA_PROFILE_DEFINE_STATE(FallingPerformance, GRABBING);
+    EUPHORIA_PROFILE_DEFINE_STATE(FallingPerformance, CLEANUP);
+
     // This is not in GetStateController on purpose
     static bool sFallingControllerInitialized = false;
 
@@ -93,6 +115,7 @@ namespace euphoria
 
     void FallingPerformance::Think(float elapsedTime)
     {
+        EUPHORIA_PROFILE_SCOPE(FallingPerformance, Think);
         mpStateMachine->Advance(elapsedTime);
     }
 
@@ -101,6 +124,7 @@ namespace euphoria
      */
     void FallingPerformance::OnEvent(const EuphoriaEvent& event)
     {
+        EUPHORIA_PROFILE_SCOPE(FallingPerformance, OnEvent);
         mpStateMachine->OnEvent(event);
     }
 
@@ -172,7 +196,11 @@ namespace euphoria
         pCollisionSystem->AddRenToIgnore(renID, ci);
 
         CollisionSystem::CollisionResult cr;
-        bool bHit = pCollisionSystem->RayCastClosest(ci, cr);
+        EUPHORIA_COUNT(eCountRayCastClosest);
+        bool bHit = EUPHORIA_REPLAY_RESULT(bool, pCollisionSystem->RayCastClosest(ci, cr));
+        EUPHORIA_REPLAY_DATA(cr.mOutHitNormal);
+        EUPHORIA_REPLAY_DATA(cr.mOutHitDist);
+        EUPHORIA_DEBUG_LINE(eDrawProbeRays, rayFrom, rayTo, bHit ? kDebugColorRed : kDebugColorGreen);
         Vec4Set(outHitNormal, cr.mOutHitNormal);
         outHitDist = cr.mOutHitDist;
 
@@ -223,10 +251,13 @@ namespace euphoria
     //
     void FallingPerformance::STATEFN_ENTER(IDLE)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(FallingPerformance, IDLE_ENTER);
+        EUPHORIA_ENTER_STATE(IDLE);
     }
 
     StateID FallingPerformance::STATEFN_UPDATE(IDLE)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(FallingPerformance, IDLE_UPDATE);
         return STATEID_INVALID;
     }
 
@@ -248,6 +279,8 @@ namespace euphoria
      */
     void FallingPerformance::STATEFN_ENTER(FALLING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(FallingPerformance, FALLING_ENTER);
+        EUPHORIA_ENTER_STATE(FALLING);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Falling::FALLING\n");
 
         // Set conditions for recovery
@@ -258,8 +291,8 @@ namespace euphoria
         mGrabbedEdge.mpOwnerRPE = NULL;
 
         AnimationCompPlugInInterface* pAnimComp = mpOwner->GetAnimationInterface();
-        pAnimComp->StartOverlay(OverlayParameters::eLeftHand, CRCINIT("LEFT_HAND_OPEN"), CRC32_NULL);
-        pAnimComp->StartOverlay(OverlayParameters::eRightHand, CRCINIT("RIGHT_HAND_OPEN"), CRC32_NULL);
+        pAnimComp->StartOverlay(OverlayParameters::eLeftHand, EuphoriaNameCRC::eLeftHandOpen, CRC32_NULL);
+        pAnimComp->StartOverlay(OverlayParameters::eRightHand, EuphoriaNameCRC::eRightHandOpen, CRC32_NULL);
 
         ParameterOverrideDataInterface* pData = mpOwner->GetAnimationInterface()->GetPODI();
 
@@ -271,9 +304,21 @@ namespace euphoria
         //GetLookDirectionForFalling(vLookAtPos);
         //pData->SetVector(0, vLookAtPos.x, vLookAtPos.y, vLookAtPos.z);
         //pAnimComp->StartBehavior(msFlailBehavior, pData->GetPOD());
+        EUPHORIA_COUNT(eCountStartBehavior);
         bool bFlailStarted = pAnimComp->StartBehavior(EuphoriaBehaviorCRC::eFlail);
         LECASSERT(bFlailStarted);
         LECUNUSED(bFlailStarted);
+
+        // Taking over from a proxy ragdoll, keep it moving. Only on the way in.
+        if (Vec3MagSqr(mParams.mCarryImpulse) > 0.0f)
+        {
+            pData = pAnimComp->GetPODI();
+            ApplyOverrideBlock(pData, msCarryOverrides);
+            pData->SetVector(0, mParams.mCarryImpulse.x, mParams.mCarryImpulse.y, mParams.mCarryImpulse.z);
+            EUPHORIA_COUNT(eCountStartBehavior);
+            pAnimComp->StartBehavior(EuphoriaBehaviorCRC::eForce, pData->GetPOD());
+            Vec3SetZero(mParams.mCarryImpulse);
+        }
     }
 
     /*!
@@ -284,11 +329,14 @@ namespace euphoria
      */
     StateID FallingPerformance::STATEFN_UPDATE(FALLING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(FallingPerformance, FALLING_UPDATE);
         // @note THIS moved from OnEnter, MIGHT NOT need to be here, or maybe it should be somewhere ELSE?
         // Check to see if we are sliding down a slope
         PhysicsCompPlugInInterface* pPhysicsComp = mpOwner->GetPhysicsInterface();
         Vec3 vNormal;   //!< @note this is REUSED below a couple times
-        bool bIsSupported = pPhysicsComp->IsSupported(vNormal);
+        EUPHORIA_COUNT(eCountIsSupported);
+        bool bIsSupported = EUPHORIA_REPLAY_RESULT(bool, pPhysicsComp->IsSupported(vNormal));
+        EUPHORIA_REPLAY_DATA(vNormal);
         if (IsMovingFast() && bIsSupported)
         {
             if (IsSliding(vNormal))
@@ -338,6 +386,7 @@ namespace euphoria
 
     void FallingPerformance::STATEFN_EXIT(FALLING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_COUNT(eCountStopAllBehaviors);
         mpOwner->GetAnimationInterface()->StopAllBehaviors();
     }
 
@@ -351,8 +400,11 @@ namespace euphoria
     //
     void FallingPerformance::STATEFN_ENTER(CATCH_HEAD)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(FallingPerformance, CATCH_HEAD_ENTER);
+        EUPHORIA_ENTER_STATE(CATCH_HEAD);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Falling::CATCH_HEAD\n");
 
+        EUPHORIA_COUNT(eCountStartBehavior);
         bool bHeadFirstFallStarted = mpOwner->GetAnimationInterface()->StartBehavior(EuphoriaBehaviorCRC::eHeadFirstFall);
         LECASSERT(bHeadFirstFallStarted);
         LECUNUSED(bHeadFirstFallStarted);
@@ -363,6 +415,7 @@ namespace euphoria
      */
     StateID FallingPerformance::STATEFN_UPDATE(CATCH_HEAD)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(FallingPerformance, CATCH_HEAD_UPDATE);
         float time = 0.0f;
         float distance = 0.0f;
         bool bTimeResult = GetTimeAndDistanceToImpact(time, distance);
@@ -388,6 +441,7 @@ namespace euphoria
 
     void FallingPerformance::STATEFN_EXIT(CATCH_HEAD)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_COUNT(eCountStopAllBehaviors);
         mpOwner->GetAnimationInterface()->StopAllBehaviors();
     }
 
@@ -401,10 +455,13 @@ namespace euphoria
     //
     void FallingPerformance::STATEFN_ENTER(CATCH_FEET)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(FallingPerformance, CATCH_FEET_ENTER);
+        EUPHORIA_ENTER_STATE(CATCH_FEET);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Falling::CATCH_FEET\n");
 
         //! @note this was commented out on SW because the char was too stiff or something
         //bool bFeetFirstFallStarted = mpOwner->GetAnimationInterface()->StartBehavior(msFeetFirstFallBehavior);
+        EUPHORIA_COUNT(eCountStartBehavior);
         bool bFeetFirstFallStarted = mpOwner->GetAnimationInterface()->StartBehavior(EuphoriaBehaviorCRC::eFlail);
         LECASSERT(bFeetFirstFallStarted);
         LECUNUSED(bFeetFirstFallStarted);
@@ -412,6 +469,7 @@ namespace euphoria
 
     StateID FallingPerformance::STATEFN_UPDATE(CATCH_FEET)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(FallingPerformance, CATCH_FEET_UPDATE);
         float time = 0.0f;
         float distance = 0.0f;
         bool bTimeResult = GetTimeAndDistanceToImpact(time, distance);
@@ -447,6 +505,7 @@ namespace euphoria
     {
         // [3/12/2008 kguran]
         //! @todo Verify that this is OK. (removed from REACT enter)
+        EUPHORIA_COUNT(eCountStopAllBehaviors);
         mpOwner->GetAnimationInterface()->StopAllBehaviors();
     }
 
@@ -463,6 +522,8 @@ namespace euphoria
      */
     void FallingPerformance::STATEFN_ENTER(REACT)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(FallingPerformance, REACT_ENTER);
+        EUPHORIA_ENTER_STATE(REACT);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Falling::REACT\n");
 
         AnimationCompPlugInInterface* pAnimComp = mpOwner->GetAnimationInterface();
@@ -480,6 +541,7 @@ namespace euphoria
             pData->SetBool(0, false);
         }
 
+        EUPHORIA_COUNT(eCountStartBehavior);
         bool bReactionStarted = pAnimComp->StartBehavior(EuphoriaBehaviorCRC::eImpactReaction, pData->GetPOD());
         LECASSERT(bReactionStarted);
         LECUNUSED(bReactionStarted);
@@ -490,6 +552,7 @@ namespace euphoria
      */
     StateID FallingPerformance::STATEFN_UPDATE(REACT)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(FallingPerformance, REACT_UPDATE);
         RenID renID = mpOwner->GetRenID();
 
         Vec3 DZ_LOOKTARGET;
@@ -510,7 +573,9 @@ namespace euphoria
 
         Vec3 vNormal;
         PhysicsCompPlugInInterface* pPhysicsComp = mpOwner->GetPhysicsInterface();
-        bool bIsSupported = pPhysicsComp->IsSupported(vNormal);
+        EUPHORIA_COUNT(eCountIsSupported);
+        bool bIsSupported = EUPHORIA_REPLAY_RESULT(bool, pPhysicsComp->IsSupported(vNormal));
+        EUPHORIA_REPLAY_DATA(vNormal);
         if (IsMovingFast() && bIsSupported)
         {
             // Pass in a 0 height because we are touching the ground.
@@ -534,6 +599,7 @@ namespace euphoria
 
     void FallingPerformance::STATEFN_EXIT(REACT)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_COUNT(eCountStopAllBehaviors);
         mpOwner->GetAnimationInterface()->StopAllBehaviors();
     }
 
@@ -551,14 +617,16 @@ namespace euphoria
      */
     void FallingPerformance::STATEFN_ENTER(HANGING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(FallingPerformance, HANGING_ENTER);
+        EUPHORIA_ENTER_STATE(HANGING);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Falling::HANGING\n");
 
         // Turn off the ability to recover because the NPC won't move much while hanging
         mpOwner->DisableRecovery();
 
         AnimationCompPlugInInterface* pAnimComp = mpOwner->GetAnimationInterface();
-        pAnimComp->StartOverlay(OverlayParameters::eLeftHand, CRCINIT("LEFT_HAND_HANG"), CRC32_NULL);
-        pAnimComp->StartOverlay(OverlayParameters::eRightHand, CRCINIT("RIGHT_HAND_HANG"), CRC32_NULL);
+        pAnimComp->StartOverlay(OverlayParameters::eLeftHand, EuphoriaNameCRC::eLeftHandHang, CRC32_NULL);
+        pAnimComp->StartOverlay(OverlayParameters::eRightHand, EuphoriaNameCRC::eRightHandHang, CRC32_NULL);
 
         ParameterOverrideDataInterface* pPODI = pAnimComp->GetPODI();
 
@@ -585,6 +653,7 @@ namespace euphoria
         pPODI->SetBool(0, mpOwner->IsHandConstrained(eLeftArm));
         pPODI->SetBool(1, mpOwner->IsHandConstrained(eRightArm));
 
+        EUPHORIA_COUNT(eCountStartBehavior);
         bool bHangStarted = pAnimComp->StartBehavior(EuphoriaBehaviorCRC::eHang, pPODI->GetPOD());
         LECASSERT(bHangStarted);
         LECUNUSED(bHangStarted);
@@ -592,6 +661,7 @@ namespace euphoria
 
     StateID FallingPerformance::STATEFN_UPDATE(HANGING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(FallingPerformance, HANGING_UPDATE);
         // Fall if no longer holding on to anything
         if (!mpOwner->IsHandConstrained(eLeftArm) && !mpOwner->IsHandConstrained(eRightArm))
         {
@@ -604,6 +674,7 @@ namespace euphoria
     void FallingPerformance::STATEFN_EXIT(HANGING)(const StateDataDefault& krStateData)
     {
         mpOwner->EnableRecovery();
+        EUPHORIA_COUNT(eCountStopAllBehaviors);
         mpOwner->GetAnimationInterface()->StopAllBehaviors();
     }
 
@@ -623,12 +694,15 @@ namespace euphoria
     //
     void FallingPerformance::STATEFN_ENTER(SLIDING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(FallingPerformance, SLIDING_ENTER);
+        EUPHORIA_ENTER_STATE(SLIDING);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Falling::SLIDING\n");
 
         AnimationCompPlugInInterface* pAnimComp = mpOwner->GetAnimationInterface();
-        pAnimComp->StartOverlay(OverlayParameters::eLeftHand, CRCINIT("LEFT_HAND_OPEN"), CRC32_NULL);
-        pAnimComp->StartOverlay(OverlayParameters::eRightHand, CRCINIT("RIGHT_HAND_OPEN"), CRC32_NULL);
+        pAnimComp->StartOverlay(OverlayParameters::eLeftHand, EuphoriaNameCRC::eLeftHandOpen, CRC32_NULL);
+        pAnimComp->StartOverlay(OverlayParameters::eRightHand, EuphoriaNameCRC::eRightHandOpen, CRC32_NULL);
 
+        EUPHORIA_COUNT(eCountStartBehavior);
         bool bSlideStarted = pAnimComp->StartBehavior(EuphoriaBehaviorCRC::eSlide);
         LECASSERT(bSlideStarted);
         LECUNUSED(bSlideStarted);
@@ -640,6 +714,7 @@ namespace euphoria
      */
     StateID FallingPerformance::STATEFN_UPDATE(SLIDING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(FallingPerformance, SLIDING_UPDATE);
         AnimationCompPlugInInterface* pAnimComp = mpOwner->GetAnimationInterface();
 
         // Left hand
@@ -674,7 +749,8 @@ namespace euphoria
 
         // Check for FALLING conditions
         PhysicsCompPlugInInterface* pPhysicsComp = mpOwner->GetPhysicsInterface();
-        bool bIsSupported = pPhysicsComp->IsSupported();
+        EUPHORIA_COUNT(eCountIsSupported);
+        bool bIsSupported = EUPHORIA_REPLAY_RESULT(bool, pPhysicsComp->IsSupported());
         if (!bIsSupported)
         {
             return STATEID(FALLING);
@@ -686,6 +762,7 @@ namespace euphoria
 
     void FallingPerformance::STATEFN_EXIT(SLIDING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_COUNT(eCountStopAllBehaviors);
         mpOwner->GetAnimationInterface()->StopAllBehaviors();
     }
 
@@ -705,6 +782,8 @@ namespace euphoria
      */
     void FallingPerformance::STATEFN_ENTER(GRABBING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(FallingPerformance, GRABBING_ENTER);
+        EUPHORIA_ENTER_STATE(GRABBING);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Falling::GRABBING\n");
 
         AnimationCompPlugInInterface* pAnimComp = mpOwner->GetAnimationInterface();
@@ -718,14 +797,17 @@ namespace euphoria
         }
         pPODI->SetVector(0, mGrabbedEdge.mvStart.x, mGrabbedEdge.mvStart.y, mGrabbedEdge.mvStart.z);
         pPODI->SetVector(1, mGrabbedEdge.mvEnd.x, mGrabbedEdge.mvEnd.y, mGrabbedEdge.mvEnd.z);
+        EUPHORIA_COUNT(eCountStartBehavior);
         pAnimComp->StartBehavior(EuphoriaBehaviorCRC::eGrab, pPODI->GetPOD());
     }
 
     StateID FallingPerformance::STATEFN_UPDATE(GRABBING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(FallingPerformance, GRABBING_UPDATE);
         // Fall if not supported
         PhysicsCompPlugInInterface* pPhysicsComp = mpOwner->GetPhysicsInterface();
-        bool bIsSupported = pPhysicsComp->IsSupported();
+        EUPHORIA_COUNT(eCountIsSupported);
+        bool bIsSupported = EUPHORIA_REPLAY_RESULT(bool, pPhysicsComp->IsSupported());
         if (!bIsSupported)
         {
             return STATEID(FALLING);
@@ -736,6 +818,7 @@ namespace euphoria
 
     void FallingPerformance::STATEFN_EXIT(GRABBING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_COUNT(eCountStopAllBehaviors);
         mpOwner->GetAnimationInterface()->StopAllBehaviors();
     }
 
@@ -762,11 +845,14 @@ namespace euphoria
     //
     void FallingPerformance::STATEFN_ENTER(CLEANUP)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(FallingPerformance, CLEANUP_ENTER);
+        EUPHORIA_ENTER_STATE(CLEANUP);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Falling::CLEANUP\n");
     }
 
     StateID FallingPerformance::STATEFN_UPDATE(CLEANUP)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(FallingPerformance, CLEANUP_UPDATE);
         return STATEID_INVALID;
     }
 
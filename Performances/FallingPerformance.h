@@ -28,6 +28,7 @@ namespace euphoria
     // FORWARD DECLARATIONS
     class FallingPerformance;
     class GrabbedEdgeInfo;
+    struct OverrideBlock;
 
     // TYPEDEFS
     typedef Ronin::StateMachine<FallingPerformance, const Ronin::StateDataDefault, const EuphoriaEvent> FallingStateController;
@@ -39,13 +40,16 @@ namespace euphoria
     DECLARE_ALIGNED class FallingPerformance : public EuphoriaPerformance
     {
         LECALIGNEDCLASS(16);
+
+        // FRIENDS
+        friend class Bench;
     
     private:
         // STATIC MEMBERS
         static FallingStateController msStateController;
+        static const OverrideBlock msCarryOverrides;
 
         // MEMBERS
-        Ronin::StateMachineInstance* mpStateMachine;
         FallingParams mParams;
 
         // Reference to the owning component's GrabbedEdgeInfo for convenience
@@ -4,6 +4,7 @@ GunshotPerformance.cpp
 
 #include "GunshotPerformance.h"
 #include "EuphoriaComp.h"
+#include "EuphoriaProfiler.h"
 
 namespace euphoria
 {
@@ -21,6 +22,11 @@ namespace euphoria
     DEFINE_STATE(GunshotPerformance, FALLING);
     DEFINE_STATE(GunshotPerformance, CLEANUP);
 
+    EUPHORIA_PROFILE_DEFINE_PERFORMANCE(GunshotPerformance);
+    EUPHORIA_PROFILE_DEFINE_STATE(GunshotPerformance, IDLE);
+    EUPHORIA_PROFILE_DEFINE_STATE(GunshotPerformance, FALLING);
+    EUPHORIA_PROFILE_DEFINE_STATE(GunshotPerformance, CLEANUP);
+
     // This is not in GetStateController on purpose
     static bool sGunshotControllerInitialized = false;
 
@@ -56,11 +62,13 @@ namespace euphoria
 
     void GunshotPerformance::Think(float elapsedTime)
     {
+        EUPHORIA_PROFILE_SCOPE(GunshotPerformance, Think);
         mpStateMachine->Advance(elapsedTime);
     }
 
     void GunshotPerformance::OnEvent(const EuphoriaEvent& event)
     {
+        EUPHORIA_PROFILE_SCOPE(GunshotPerformance, OnEvent);
         mpStateMachine->OnEvent(event);
     }
 
@@ -99,10 +107,13 @@ namespace euphoria
     //
     void GunshotPerformance::STATEFN_ENTER(IDLE)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(GunshotPerformance, IDLE_ENTER);
+        EUPHORIA_ENTER_STATE(IDLE);
     }
 
     StateID GunshotPerformance::STATEFN_UPDATE(IDLE)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(GunshotPerformance, IDLE_UPDATE);
         return STATEID(FALLING);
     }
 
@@ -120,11 +131,14 @@ namespace euphoria
     //
     void GunshotPerformance::STATEFN_ENTER(FALLING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(GunshotPerformance, FALLING_ENTER);
+        EUPHORIA_ENTER_STATE(FALLING);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Gunshot::FALLING\n");
     }
 
     StateID GunshotPerformance::STATEFN_UPDATE(FALLING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(GunshotPerformance, FALLING_UPDATE);
         FallingParams fp;
         fp.mAttacker = RENID_NULL;
         mpOwner->StartPerformance(fp);
@@ -146,11 +160,14 @@ namespace euphoria
     //
     void GunshotPerformance::STATEFN_ENTER(CLEANUP)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(GunshotPerformance, CLEANUP_ENTER);
+        EUPHORIA_ENTER_STATE(CLEANUP);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Gunshot::CLEANUP\n");
     }
 
     StateID GunshotPerformance::STATEFN_UPDATE(CLEANUP)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(GunshotPerformance, CLEANUP_UPDATE);
         return STATEID_INVALID;
     }
 
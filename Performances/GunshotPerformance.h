@@ -29,7 +29,6 @@ namespace euphoria
         static GunshotStateController msStateController;
 
         // MEMBERS
-        Ronin::StateMachineInstance* mpStateMachine;
         GunshotParams mParams;
 
         // UNIMPLEMENTED METHODS
@@ -7,7 +7,9 @@ HitReactPerformance.cpp
 #include "EuphoriaEvent.h"
 #include "EuphoriaBehaviorCRC.h"
 #include "EuphoriaComp.h"
+#include "EuphoriaHotLoad.h"
 #include "EuphoriaManager.h"
+#include "EuphoriaProfiler.h"
 #include "PhysicsComponentPlugInInterface.h"
 // Schemas
 #include "DefEuphoriaPerformance.schema.h"
@@ -34,6 +36,13 @@ namespace euphoria
     DEFINE_STATE(HitReactPerformance, IMPACT);
     DEFINE_STATE(HitReactPerformance, CLEANUP);
 
+    EUPHORIA_PROFILE_DEFINE_PERFORMANCE(HitReactPerformance);
+    EUPHORIA_PROFILE_DEFINE_STATE(HitReactPerformance, IDLE);
+    EUPHORIA_PROFILE_DEFINE_STATE(HitReactPerformance, REACT);
+    EUPHORIA_PROFILE_DEFINE_STATE(HitReactPerformance, CRUNCH);
+    EUPHORIA_PROFILE_DEFINE_STATE(HitReactPerformance, IMPACT);
+    EUPHORIA_PROFILE_DEFINE_STATE(HitReactPerformance, CLEANUP);
+
     /*!
      *
      */
@@ -73,6 +82,7 @@ namespace euphoria
 	 */
 	void HitReactPerformance::Think(float elapsedTime)
 	{
+		EUPHORIA_PROFILE_SCOPE(HitReactPerformance, Think);
 		mpStateMachine->Advance(elapsedTime);
 	}
 
@@ -81,6 +91,7 @@ namespace euphoria
 	 */
 	void HitReactPerformance::OnEvent(const EuphoriaEvent& event)
 	{
+		EUPHORIA_PROFILE_SCOPE(HitReactPerformance, OnEvent);
 		mpStateMachine->OnEvent(event);
 	}
 
@@ -107,6 +118,30 @@ namespace euphoria
 		mParams = params;
 	}
 
+    /*!
+     * Saves the recover and crunch timers
+     */
+    void HitReactPerformance::SaveResumeData(unsigned char* pData) const
+    {
+        typedef char ResumeDataFits[(sizeof(ResumeData) <= PerformanceResumeState::kMaxDataSize) ? 1 : -1];
+        LECUNUSED(sizeof(ResumeDataFits));
+
+        ResumeData data;
+        data.recoverStartTime = mRecoverStartTime;
+        data.crunchStartTime = mCrunchStartTime;
+        data.recoverTransfer = mRecoverTransfer;
+        memcpy(pData, &data, sizeof(data));
+    }
+
+    void HitReactPerformance::LoadResumeData(const unsigned char* pData)
+    {
+        ResumeData data;
+        memcpy(&data, pData, sizeof(data));
+        mRecoverStartTime = data.recoverStartTime;
+        mCrunchStartTime = data.crunchStartTime;
+        mRecoverTransfer = data.recoverTransfer;
+    }
+
 	/*!
      * Returns the local static copy of the state controller. Initializes it if
      * necessary.
@@ -138,10 +173,13 @@ namespace euphoria
     //
     void HitReactPerformance::STATEFN_ENTER(IDLE)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(HitReactPerformance, IDLE_ENTER);
+        EUPHORIA_ENTER_STATE(IDLE);
     }
 
     StateID HitReactPerformance::STATEFN_UPDATE(IDLE)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(HitReactPerformance, IDLE_UPDATE);
         return STATEID_INVALID;
     }
 
@@ -159,9 +197,13 @@ namespace euphoria
     //
     void HitReactPerformance::STATEFN_ENTER(REACT)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(HitReactPerformance, REACT_ENTER);
+        EUPHORIA_ENTER_STATE(REACT);
 		LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "React");
         AnimationCompPlugInInterface* pAnimation = mpOwner->GetAnimationInterface();
+        EUPHORIA_COUNT(eCountStartBehavior);
         pAnimation->StartBehavior(EuphoriaBehaviorCRC::eReact, NULL, false, false);
+		EUPHORIA_COUNT(eCountStartBehavior);
 		pAnimation->StartBehavior(EuphoriaBehaviorCRC::eTransfer_HR, NULL, false, false);
 		mpOwner->SetTruncateMovementEnable(false);
 		mpOwner->DisableRecovery();
@@ -170,12 +212,13 @@ namespace euphoria
 
     StateID HitReactPerformance::STATEFN_UPDATE(REACT)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(HitReactPerformance, REACT_UPDATE);
 		// start recover after delay
         if (!mRecoverTransfer)
         {
-            mRecoverStartTime = mpStateMachine->GetTimeInCurrentState();
+            mRecoverStartTime = GetTimeInState();
         }
-        if ((mpStateMachine->GetTimeInCurrentState() - mRecoverStartTime) > msRecoverDelay)
+        if ((GetTimeInState() - mRecoverStartTime) > msRecoverDelay)
         {
             LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Recover");
             return STATEID(CLEANUP);
@@ -188,7 +231,9 @@ namespace euphoria
     void HitReactPerformance::STATEFN_EXIT(REACT)(const StateDataDefault& krStateData)
     {
         AnimationCompPlugInInterface* pAnimation = mpOwner->GetAnimationInterface();
+		EUPHORIA_COUNT(eCountStopBehavior);
 		pAnimation->StopBehavior(EuphoriaBehaviorCRC::eReact);
+		EUPHORIA_COUNT(eCountStopBehavior);
 		pAnimation->StopBehavior(EuphoriaBehaviorCRC::eTransfer_HR);
 		mpOwner->SetTruncateMovementEnable(true);
     }
@@ -238,16 +283,20 @@ namespace euphoria
 	//
 	void HitReactPerformance::STATEFN_ENTER(CRUNCH)(const StateDataDefault& krStateData)
 	{
+		EUPHORIA_PROFILE_SCOPE(HitReactPerformance, CRUNCH_ENTER);
+	    EUPHORIA_ENTER_STATE(CRUNCH);
 		LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Crunch");
         AnimationCompPlugInInterface* pAnimation = mpOwner->GetAnimationInterface();
+		EUPHORIA_COUNT(eCountStartBehavior);
 		pAnimation->StartBehavior(EuphoriaBehaviorCRC::eCrunch_HR);
-		mCrunchStartTime = mpStateMachine->GetTimeInCurrentState();
+		mCrunchStartTime = GetTimeInState();
 	}
 
 	StateID HitReactPerformance::STATEFN_UPDATE(CRUNCH)(const StateDataDefault& krStateData)
 	{
+		EUPHORIA_PROFILE_SCOPE(HitReactPerformance, CRUNCH_UPDATE);
 		// start impact after delay
-		if ((mpStateMachine->GetTimeInCurrentState() - mCrunchStartTime) > msCrunchDelay)
+		if ((GetTimeInState() - mCrunchStartTime) > msCrunchDelay)
 		{
 			return STATEID(IMPACT);
 		}
@@ -258,6 +307,7 @@ namespace euphoria
 	void HitReactPerformance::STATEFN_EXIT(CRUNCH)(const StateDataDefault& krStateData)
 	{
         AnimationCompPlugInInterface* pAnimation = mpOwner->GetAnimationInterface();
+		EUPHORIA_COUNT(eCountStopBehavior);
 		pAnimation->StopBehavior(EuphoriaBehaviorCRC::eCrunch_HR);
 	}
 
@@ -271,8 +321,11 @@ namespace euphoria
 	//
 	void HitReactPerformance::STATEFN_ENTER(IMPACT)(const StateDataDefault& krStateData)
 	{
+		EUPHORIA_PROFILE_SCOPE(HitReactPerformance, IMPACT_ENTER);
+	    EUPHORIA_ENTER_STATE(IMPACT);
 		LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Impact");
         AnimationCompPlugInInterface* pAnimation = mpOwner->GetAnimationInterface();
+		EUPHORIA_COUNT(eCountStartBehavior);
 		pAnimation->StartBehavior(EuphoriaBehaviorCRC::eImpact_HR);
         mpOwner->EnableRecovery();
 		mpOwner->SetStationaryTimer(mfStationarySpeedThreshold, mfStationaryWaitTime);
@@ -280,12 +333,14 @@ namespace euphoria
 
 	StateID HitReactPerformance::STATEFN_UPDATE(IMPACT)(const StateDataDefault& krStateData)
 	{
+		EUPHORIA_PROFILE_SCOPE(HitReactPerformance, IMPACT_UPDATE);
 		return STATEID_INVALID; 
 	}
 
 	void HitReactPerformance::STATEFN_EXIT(IMPACT)(const StateDataDefault& krStateData)
 	{
         AnimationCompPlugInInterface* pAnimation = mpOwner->GetAnimationInterface();
+		EUPHORIA_COUNT(eCountStopBehavior);
 		pAnimation->StopBehavior(EuphoriaBehaviorCRC::eImpact_HR);
 	}
 
@@ -299,14 +354,18 @@ namespace euphoria
     //
     void HitReactPerformance::STATEFN_ENTER(CLEANUP)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(HitReactPerformance, CLEANUP_ENTER);
+        EUPHORIA_ENTER_STATE(CLEANUP);
 		LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "..stopping HITREACT");
         AnimationCompPlugInInterface* pAnimation = mpOwner->GetAnimationInterface();
+		EUPHORIA_COUNT(eCountStopAllBehaviors);
 		pAnimation->StopAllBehaviors();
         pAnimation->EndBehaviorControl();
     }
 
     StateID HitReactPerformance::STATEFN_UPDATE(CLEANUP)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(HitReactPerformance, CLEANUP_UPDATE);
         // SM will always end in CLEANUP and start in IDLE. Does this have to be explicit?
         return STATEID(IDLE); 
     }
@@ -33,13 +33,20 @@ namespace euphoria
         static const float msCrunchDelay;
 
 		// MEMBERS
-        Ronin::StateMachineInstance* mpStateMachine;
 		HitReactParams mParams;
         Ronin::RenID mIncomingRenID;
         bool mRecoverTransfer;
         float mRecoverStartTime;
         float mCrunchStartTime;
 
+        //! What REACT and CRUNCH keep between updates, for a hot load
+        struct ResumeData
+        {
+            float recoverStartTime;
+            float crunchStartTime;
+            bool recoverTransfer;
+        };
+
         // UNIMPLEMENTED METHODS
         // Prevent copying and assignment
         HitReactPerformance(const HitReactPerformance&);
@@ -47,6 +54,8 @@ namespace euphoria
 
         // METHODS
         HitReactStateController& GetStateController();
+        virtual void SaveResumeData(unsigned char* pData) const;
+        virtual void LoadResumeData(const unsigned char* pData);
 
         // STATES
         DECLARE_STATE_EVENT(IDLE, const EuphoriaEvent);
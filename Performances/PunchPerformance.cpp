@@ -4,9 +4,13 @@ PunchPerformance.cpp
 
 #include "PunchPerformance.h"
 #include "AnimationComponentPlugInInterface.h"
+#include "BoneCRC.h"
 #include "EuphoriaBehaviorCRC.h"
 #include "EuphoriaEvent.h"
 #include "EuphoriaComp.h"
+#include "EuphoriaNameCRC.h"
+#include "EuphoriaOverrideBlock.h"
+#include "EuphoriaProfiler.h"
 #include "FortuneGamePlugInInterface.h"
 #include "ParameterOverrideDataInterface.h"
 // Schemas
@@ -23,12 +27,28 @@ namespace euphoria
     // State controller
     PunchStateController PunchPerformance::msStateController;
 
+    // Behavior override blocks
+    // Spread, Duration, Torque magnitude | Apply total each frame | Impulse (patched), Torque axis | Part to apply impulse to
+    const OverrideBlock PunchPerformance::msImpactOverrides = {
+        3, { 0.1f, 0.0f, 0.0f }, 0, { 0 }, 1, { false }, 2, { { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } }, 1, { CRC32_NULL }, 0, { NULL }
+    };
+    // Punch Behavior for Root, to prevent the character from folding. Torque settings are hard-coded for the "right hook"
+    const OverrideBlock PunchPerformance::msRootOverrides = {
+        3, { 0.3f, 0.3f, 0.0f }, 0, { 0 }, 1, { false }, 2, { { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } }, 1, { EuphoriaNameCRC::eRoot }, 0, { NULL }
+    };
+
     // Define all of the states for this Performance
     DEFINE_STATE(PunchPerformance, IDLE);
     DEFINE_STATE(PunchPerformance, ON_FEET);
     DEFINE_STATE(PunchPerformance, FALLING);
     DEFINE_STATE(PunchPerformance, CLEANUP);
 
+    EUPHORIA_PROFILE_DEFINE_PERFORMANCE(PunchPerformance);
+    EUPHORIA_PROFILE_DEFINE_STATE(PunchPerformance, IDLE);
+    EUPHORIA_PROFILE_DEFINE_STATE(PunchPerformance, ON_FEET);
+    EUPHORIA_PROFILE_DEFINE_STATE(PunchPerformance, FALLING);
+    EUPHORIA_PROFILE_DEFINE_STATE(PunchPerformance, CLEANUP);
+
     // This is not in GetStateController on purpose
     static bool sPunchControllerInitialized = false;
 
@@ -67,6 +87,7 @@ namespace euphoria
      */
     void PunchPerformance::Think(float elapsedTime)
     {
+        EUPHORIA_PROFILE_SCOPE(PunchPerformance, Think);
         mpStateMachine->Advance(elapsedTime);
     }
 
@@ -75,6 +96,7 @@ namespace euphoria
      */
     void PunchPerformance::OnEvent(const EuphoriaEvent& event)
     {
+        EUPHORIA_PROFILE_SCOPE(PunchPerformance, OnEvent);
 		mpStateMachine->OnEvent(event);
     }
 
@@ -129,10 +151,13 @@ namespace euphoria
     //
     void PunchPerformance::STATEFN_ENTER(IDLE)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(PunchPerformance, IDLE_ENTER);
+        EUPHORIA_ENTER_STATE(IDLE);
     }
 
     StateID PunchPerformance::STATEFN_UPDATE(IDLE)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(PunchPerformance, IDLE_UPDATE);
         return STATEID_INVALID;
     }
 
@@ -150,6 +175,8 @@ namespace euphoria
     //
     void PunchPerformance::STATEFN_ENTER(ON_FEET)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(PunchPerformance, ON_FEET_ENTER);
+        EUPHORIA_ENTER_STATE(ON_FEET);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "PunchPerformance::ON_FEET Entered\n");
 
         // Set conditions for recovery
@@ -158,18 +185,14 @@ namespace euphoria
         // Prepare overrides for the punch behavior
         ParameterOverrideDataInterface* pData = mpOwner->GetAnimationInterface()->GetPODI();
 
+        ApplyOverrideBlock(pData, msImpactOverrides);
         pData->SetVector(0,                                     // Impulse vector
             mParams.mForceNormal.x * mParams.mForceMagnitude,
             mParams.mForceNormal.y * mParams.mForceMagnitude,
             mParams.mForceNormal.z * mParams.mForceMagnitude);
-        pData->SetFloat(0, 0.1f);                               // Spread
-        pData->SetFloat(1, 0.0f);                               // Duration
-        pData->SetBool(0, false);                               // Apply total each frame
         pData->SetPart(0, mParams.mImpactBone);                 // Part to apply impulse to
-        // For torque (from original Lua)
-        pData->SetVector(1, 0.0f, 1.0f, 0.0f);
-        pData->SetFloat(2, 0);
 
+        EUPHORIA_COUNT(eCountStartBehavior);
         mpOwner->GetAnimationInterface()->StartBehavior(EuphoriaBehaviorCRC::ePunch, pData->GetPOD());
 
         // Punch Behavior for Root, to prevent the character from folding
@@ -181,7 +204,7 @@ namespace euphoria
         Vec3 posImpactBone;
         pRPE->GetPosition(posImpactBone);
 
-        pRPE = mpOwner->GetAnimationInterface()->GetBodyPartByBone(CRCINIT("Spine[3]"));
+        pRPE = mpOwner->GetAnimationInterface()->GetBodyPartByBone(BoneCRC::eSpine3);
         Vec3 posChest;
         pRPE->GetPosition(posChest);
 
@@ -190,29 +213,24 @@ namespace euphoria
         Vec3Normalize_UA(toImpactFromChest, toImpactFromChest);
 
         float scaleFactor = 4.0f;
+        ApplyOverrideBlock(pData, msRootOverrides);
         pData->SetVector(0,                                     // Impulse vector
             toImpactFromChest.x * scaleFactor,
             toImpactFromChest.y * scaleFactor,
             toImpactFromChest.z * scaleFactor);
-        pData->SetFloat(0, 0.3f);                               // Spread
-        pData->SetFloat(1, 0.3f);                               // Duration
-        pData->SetBool(0, false);                               // Apply total each frame
-        pData->SetPart(0, CRCINIT("Root"));                     // Part to apply impulse to
-
-        // Overrides for Add Torque
-        // These settings are hard-coded for the "right hook"
-        pData->SetVector(1, 0.0f, 1.0f, 0.0f);
-        pData->SetFloat(2, 0.0f);
 
         // Start punch
+        EUPHORIA_COUNT(eCountStartBehavior);
         mpOwner->GetAnimationInterface()->StartBehavior(EuphoriaBehaviorCRC::ePunch, pData->GetPOD());
 
         // Start stagger
+        EUPHORIA_COUNT(eCountStartBehavior);
         mpOwner->GetAnimationInterface()->StartBehavior(EuphoriaBehaviorCRC::eStaggerPunch, NULL);
     }
 
     StateID PunchPerformance::STATEFN_UPDATE(ON_FEET)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(PunchPerformance, ON_FEET_UPDATE);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "PunchPerformance::ON_FEET Updating\n");
         return STATEID_INVALID;
     }
@@ -239,13 +257,17 @@ namespace euphoria
     //
     void PunchPerformance::STATEFN_ENTER(FALLING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(PunchPerformance, FALLING_ENTER);
+        EUPHORIA_ENTER_STATE(FALLING);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "PunchPerformance::FALLING Entered\n");
 
+        EUPHORIA_COUNT(eCountStartBehavior);
         mpOwner->GetAnimationInterface()->StartBehavior(EuphoriaBehaviorCRC::eFall, NULL);
     }
 
     StateID PunchPerformance::STATEFN_UPDATE(FALLING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(PunchPerformance, FALLING_UPDATE);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "PunchPerformance::FALLING Updating\n");
         return STATEID_INVALID;
     }
@@ -264,11 +286,14 @@ namespace euphoria
     //
     void PunchPerformance::STATEFN_ENTER(CLEANUP)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(PunchPerformance, CLEANUP_ENTER);
+        EUPHORIA_ENTER_STATE(CLEANUP);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "PunchPerformance::CLEANUP\n");
     }
 
     StateID PunchPerformance::STATEFN_UPDATE(CLEANUP)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(PunchPerformance, CLEANUP_UPDATE);
         // SM will always end in CLEANUP and start in IDLE. Does this have to be explicit?
         return STATEID(IDLE); 
     }
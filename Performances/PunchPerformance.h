@@ -12,6 +12,7 @@ namespace euphoria
 {
     // FORWARD DECLARATIONS
     class PunchPerformance;
+    struct OverrideBlock;
 
     // TYPEDEFS
     typedef Ronin::StateMachine<PunchPerformance, const Ronin::StateDataDefault, const EuphoriaEvent> PunchStateController;
@@ -26,9 +27,10 @@ namespace euphoria
     private:
         // STATIC MEMBERS
         static PunchStateController msStateController;
+        static const OverrideBlock msImpactOverrides;
+        static const OverrideBlock msRootOverrides;
 
         // MEMBERS
-        Ronin::StateMachineInstance* mpStateMachine;
         PunchParams mParams;
 
         // UNIMPLEMENTED METHODS
@@ -7,6 +7,7 @@ ShovePerformance.cpp
 #include "EuphoriaBehaviorCRC.h"
 #include "EuphoriaEvent.h"
 #include "EuphoriaComp.h"
+#include "EuphoriaProfiler.h"
 #include "FortuneGamePlugInInterface.h"
 // Schemas
 #include "DefEuphoriaPerformance.schema.h"
@@ -28,6 +29,12 @@ namespace euphoria
     DEFINE_STATE(ShovePerformance, FALLING);
     DEFINE_STATE(ShovePerformance, CLEANUP);
 
+    EUPHORIA_PROFILE_DEFINE_PERFORMANCE(ShovePerformance);
+    EUPHORIA_PROFILE_DEFINE_STATE(ShovePerformance, IDLE);
+    EUPHORIA_PROFILE_DEFINE_STATE(ShovePerformance, STAGGERING);
+    EUPHORIA_PROFILE_DEFINE_STATE(ShovePerformance, FALLING);
+    EUPHORIA_PROFILE_DEFINE_STATE(ShovePerformance, CLEANUP);
+
     // This is not in GetStateController on purpose
     static bool sShoveControllerInitialized = false;
 
@@ -66,6 +73,7 @@ namespace euphoria
      */
     void ShovePerformance::Think(float elapsedTime)
     {
+        EUPHORIA_PROFILE_SCOPE(ShovePerformance, Think);
         mpStateMachine->Advance(elapsedTime);
     }
 
@@ -74,6 +82,7 @@ namespace euphoria
      */
     void ShovePerformance::OnEvent(const EuphoriaEvent& event)
     {
+        EUPHORIA_PROFILE_SCOPE(ShovePerformance, OnEvent);
         mpStateMachine->OnEvent(event);
     }
 
@@ -128,10 +137,13 @@ namespace euphoria
     //
     void ShovePerformance::STATEFN_ENTER(IDLE)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ShovePerformance, IDLE_ENTER);
+        EUPHORIA_ENTER_STATE(IDLE);
     }
 
     StateID ShovePerformance::STATEFN_UPDATE(IDLE)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ShovePerformance, IDLE_UPDATE);
         return STATEID_INVALID;
     }
 
@@ -149,6 +161,8 @@ namespace euphoria
     //
     void ShovePerformance::STATEFN_ENTER(STAGGERING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ShovePerformance, STAGGERING_ENTER);
+        EUPHORIA_ENTER_STATE(STAGGERING);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Shove::STAGGERING\n");
 
         // Set conditions for recovery
@@ -168,11 +182,13 @@ namespace euphoria
         pData->SetVector(0, 0, 0, 0);
 
         // Start stagger behavior
+        EUPHORIA_COUNT(eCountStartBehavior);
         mpOwner->GetAnimationInterface()->StartBehavior(EuphoriaBehaviorCRC::eStagger, pData->GetPOD());
     }
 
     StateID ShovePerformance::STATEFN_UPDATE(STAGGERING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ShovePerformance, STAGGERING_UPDATE);
         return STATEID_INVALID;
     }
 
@@ -180,6 +196,7 @@ namespace euphoria
     {
         // @todo Make sure StopAllBehaviors is only called when necessary. It seems to be in a lot of places (in the Lua versions)
         // @todo It can probably be replaced with StopBehavior() in most cases
+        EUPHORIA_COUNT(eCountStopBehavior);
         mpOwner->GetAnimationInterface()->StopBehavior(EuphoriaBehaviorCRC::eStagger);
     }
 
@@ -199,19 +216,24 @@ namespace euphoria
     //
     void ShovePerformance::STATEFN_ENTER(FALLING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ShovePerformance, FALLING_ENTER);
+        EUPHORIA_ENTER_STATE(FALLING);
         // @note This state doesn't seem to get used much (if at all)
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Shove::FALLING\n");
 
+        EUPHORIA_COUNT(eCountStartBehavior);
         mpOwner->GetAnimationInterface()->StartBehavior(EuphoriaBehaviorCRC::eCatchFall, NULL);
     }
 
     StateID ShovePerformance::STATEFN_UPDATE(FALLING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ShovePerformance, FALLING_UPDATE);
         return STATEID_INVALID;
     }
 
     void ShovePerformance::STATEFN_EXIT(FALLING)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_COUNT(eCountStopBehavior);
         mpOwner->GetAnimationInterface()->StopBehavior(EuphoriaBehaviorCRC::eCatchFall);
     }
 
@@ -225,14 +247,18 @@ namespace euphoria
     //
     void ShovePerformance::STATEFN_ENTER(CLEANUP)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ShovePerformance, CLEANUP_ENTER);
+        EUPHORIA_ENTER_STATE(CLEANUP);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Shove::CLEANUP\n");
 
         // @todo Make sure StopAllBehaviors is only called when necessary. It seems to be in a lot of places (in the Lua versions)
+        EUPHORIA_COUNT(eCountStopAllBehaviors);
         mpOwner->GetAnimationInterface()->StopAllBehaviors();
     }
 
     StateID ShovePerformance::STATEFN_UPDATE(CLEANUP)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ShovePerformance, CLEANUP_UPDATE);
         // SM will always end in CLEANUP and start in IDLE. Does this have to be explicit?
         return STATEID(IDLE); 
     }
@@ -35,7 +35,6 @@ namespace euphoria
         static ShoveStateController msStateController;
 
         // MEMBERS
-        Ronin::StateMachineInstance* mpStateMachine;
         ShoveParams mParams;
 
         // UNIMPLEMENTED METHODS
@@ -7,6 +7,8 @@ ThrowPerformance.cpp
 #include "EuphoriaBehaviorCRC.h"
 #include "EuphoriaEvent.h"
 #include "EuphoriaComp.h"
+#include "EuphoriaHotLoad.h"
+#include "EuphoriaProfiler.h"
 #include "EuphoriaUtilities.h"
 // Schemas
 #include "DefEuphoriaPerformance.schema.h"
@@ -34,6 +36,14 @@ namespace euphoria
 	DEFINE_STATE(ThrowPerformance, IMPACT);
 	DEFINE_STATE(ThrowPerformance, CLEANUP);
 
+	EUPHORIA_PROFILE_DEFINE_PERFORMANCE(ThrowPerformance);
+	EUPHORIA_PROFILE_DEFINE_STATE(ThrowPerformance, IDLE);
+	EUPHORIA_PROFILE_DEFINE_STATE(ThrowPerformance, FLY);
+	EUPHORIA_PROFILE_DEFINE_STATE(ThrowPerformance, BREAK);
+	EUPHORIA_PROFILE_DEFINE_STATE(ThrowPerformance, CRUNCH);
+	EUPHORIA_PROFILE_DEFINE_STATE(ThrowPerformance, IMPACT);
+	EUPHORIA_PROFILE_DEFINE_STATE(ThrowPerformance, CLEANUP);
+
     // This is not in GetStateController on purpose
     static bool sThrowControllerInitialized = false;
 
@@ -79,6 +89,7 @@ namespace euphoria
 	 */
 	void ThrowPerformance::Think(float elapsedTime)
 	{
+		EUPHORIA_PROFILE_SCOPE(ThrowPerformance, Think);
 		mpStateMachine->Advance(elapsedTime);
 	}
 
@@ -87,6 +98,7 @@ namespace euphoria
 	 */
 	void ThrowPerformance::OnEvent(const EuphoriaEvent& event)
 	{
+		EUPHORIA_PROFILE_SCOPE(ThrowPerformance, OnEvent);
 		mpStateMachine->OnEvent(event);
 	}
 
@@ -113,6 +125,28 @@ namespace euphoria
 		mParams = rParams;
 	}
 
+    /*!
+     * Saves the collision check and crunch timers
+     */
+    void ThrowPerformance::SaveResumeData(unsigned char* pData) const
+    {
+        typedef char ResumeDataFits[(sizeof(ResumeData) <= PerformanceResumeState::kMaxDataSize) ? 1 : -1];
+        LECUNUSED(sizeof(ResumeDataFits));
+
+        ResumeData data;
+        data.checkStartTime = mCheckStartTime;
+        data.crunchStartTime = mCrunchStartTime;
+        memcpy(pData, &data, sizeof(data));
+    }
+
+    void ThrowPerformance::LoadResumeData(const unsigned char* pData)
+    {
+        ResumeData data;
+        memcpy(&data, pData, sizeof(data));
+        mCheckStartTime = data.checkStartTime;
+        mCrunchStartTime = data.crunchStartTime;
+    }
+
 	/*!
      * Returns the local static copy of the state controller. Initializes it if
      * necessary.
@@ -143,10 +177,13 @@ namespace euphoria
     //
     void ThrowPerformance::STATEFN_ENTER(IDLE)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ThrowPerformance, IDLE_ENTER);
+        EUPHORIA_ENTER_STATE(IDLE);
     }
 
     StateID ThrowPerformance::STATEFN_UPDATE(IDLE)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ThrowPerformance, IDLE_UPDATE);
         return STATEID_INVALID;
     }
 
@@ -164,6 +201,8 @@ namespace euphoria
     //
     void ThrowPerformance::STATEFN_ENTER(FLY)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ThrowPerformance, FLY_ENTER);
+        EUPHORIA_ENTER_STATE(FLY);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Throw::FLY ENTERED\n");
 
         // Set recovery params for the Throw, but not the FLY state
@@ -171,14 +210,17 @@ namespace euphoria
         mpOwner->DisableRecovery();
 
         AnimationCompPlugInInterface* pAnimation = mpOwner->GetAnimationInterface();
+        EUPHORIA_COUNT(eCountStartBehavior);
         pAnimation->StartBehavior(EuphoriaBehaviorCRC::eFly, NULL, false);
+		EUPHORIA_COUNT(eCountStartBehavior);
 		pAnimation->StartBehavior(EuphoriaBehaviorCRC::eTransfer, NULL, false);
 		mpOwner->SetTruncateMovementEnable(false);
-		mCheckStartTime = mpStateMachine->GetTimeInCurrentState();
+		mCheckStartTime = GetTimeInState();
     }
 
     StateID ThrowPerformance::STATEFN_UPDATE(FLY)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ThrowPerformance, FLY_UPDATE);
         if (ShouldFallingPerformanceTakeOver(mpOwner))
         {
             FallingParams fp;
@@ -209,7 +251,9 @@ namespace euphoria
         mpOwner->EnableRecovery();
 
         AnimationCompPlugInInterface* pAnimation = mpOwner->GetAnimationInterface();
+		EUPHORIA_COUNT(eCountStopBehavior);
 		pAnimation->StopBehavior(EuphoriaBehaviorCRC::eFly);
+		EUPHORIA_COUNT(eCountStopBehavior);
 		pAnimation->StopBehavior(EuphoriaBehaviorCRC::eTransfer);
 		mpOwner->SetTruncateMovementEnable(true);
     }
@@ -225,7 +269,7 @@ namespace euphoria
 
 			// check for collisions
 			case EuphoriaEvent::eBehaviorCollision:
-				if ((mpStateMachine->GetTimeInCurrentState() - mCheckStartTime) > msCheckCollisionDelay)
+				if ((GetTimeInState() - mCheckStartTime) > msCheckCollisionDelay)
 				{
 					LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Collision\n");
 					return STATEID(CRUNCH);
@@ -234,7 +278,7 @@ namespace euphoria
 
 			// check motion transfer to see if character has been over deformed
 			case EuphoriaEvent::eBehaviorMotionTransferOut:
-				if ((mpStateMachine->GetTimeInCurrentState() - mCheckStartTime) > msCheckTransferDelay)
+				if ((GetTimeInState() - mCheckStartTime) > msCheckTransferDelay)
 				{
 					LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "MotionTransfer\n");
                     return STATEID(CRUNCH);
@@ -250,14 +294,18 @@ namespace euphoria
     //
     void ThrowPerformance::STATEFN_ENTER(BREAK)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ThrowPerformance, BREAK_ENTER);
+        EUPHORIA_ENTER_STATE(BREAK);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Throw::BREAK ENTERED\n");
 
         AnimationCompPlugInInterface* pAnimation = mpOwner->GetAnimationInterface();
+		EUPHORIA_COUNT(eCountStartBehavior);
 		pAnimation->StartBehavior(EuphoriaBehaviorCRC::eBreak);
     }
 
     StateID ThrowPerformance::STATEFN_UPDATE(BREAK)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ThrowPerformance, BREAK_UPDATE);
         // Check velocity against gravity up...if the angle is greater than 45 degrees
         // then we will switch into the Falling performance
         if (ShouldFallingPerformanceTakeOver(mpOwner))
@@ -273,6 +321,7 @@ namespace euphoria
     void ThrowPerformance::STATEFN_EXIT(BREAK)(const StateDataDefault& krStateData)
     {
         AnimationCompPlugInInterface* pAnimation = mpOwner->GetAnimationInterface();
+		EUPHORIA_COUNT(eCountStopBehavior);
 		pAnimation->StopBehavior(EuphoriaBehaviorCRC::eBreak);
     }
 
@@ -294,16 +343,21 @@ namespace euphoria
 	//
 	void ThrowPerformance::STATEFN_ENTER(CRUNCH)(const StateDataDefault& krStateData)
 	{
+		EUPHORIA_PROFILE_SCOPE(ThrowPerformance, CRUNCH_ENTER);
+	    EUPHORIA_ENTER_STATE(CRUNCH);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Throw::CRUNCH ENTERED\n");
 
         AnimationCompPlugInInterface* pAnimation = mpOwner->GetAnimationInterface();
+		EUPHORIA_COUNT(eCountStartBehavior);
 		pAnimation->StartBehavior(EuphoriaBehaviorCRC::eCrunch);
+		EUPHORIA_COUNT(eCountStartBehavior);
 		pAnimation->StartBehavior(EuphoriaBehaviorCRC::eTorque);
-		mCrunchStartTime = mpStateMachine->GetTimeInCurrentState();
+		mCrunchStartTime = GetTimeInState();
 	}
 
 	StateID ThrowPerformance::STATEFN_UPDATE(CRUNCH)(const StateDataDefault& krStateData)
 	{
+		EUPHORIA_PROFILE_SCOPE(ThrowPerformance, CRUNCH_UPDATE);
         // Check velocity against gravity up...if the angle is greater than 45 degrees
         // then we will switch into the Falling performance
         if (ShouldFallingPerformanceTakeOver(mpOwner))
@@ -324,7 +378,7 @@ namespace euphoria
         }
 
         // start impact after delay
-		if ((mpStateMachine->GetTimeInCurrentState() - mCrunchStartTime) > msCrunchDelay)
+		if ((GetTimeInState() - mCrunchStartTime) > msCrunchDelay)
 		{
 			return STATEID(IMPACT);
 		}
@@ -335,6 +389,7 @@ namespace euphoria
 	void ThrowPerformance::STATEFN_EXIT(CRUNCH)(const StateDataDefault& krStateData)
 	{
         AnimationCompPlugInInterface* pAnimation = mpOwner->GetAnimationInterface();
+		EUPHORIA_COUNT(eCountStopBehavior);
 		pAnimation->StopBehavior(EuphoriaBehaviorCRC::eCrunch);
 	}
 
@@ -348,20 +403,25 @@ namespace euphoria
 	//
 	void ThrowPerformance::STATEFN_ENTER(IMPACT)(const StateDataDefault& krStateData)
 	{
+		EUPHORIA_PROFILE_SCOPE(ThrowPerformance, IMPACT_ENTER);
+	    EUPHORIA_ENTER_STATE(IMPACT);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Throw::IMPACT ENTERED\n");
 
         AnimationCompPlugInInterface* pAnimation = mpOwner->GetAnimationInterface();
+		EUPHORIA_COUNT(eCountStartBehavior);
 		pAnimation->StartBehavior(EuphoriaBehaviorCRC::eImpact);
 	}
 
 	StateID ThrowPerformance::STATEFN_UPDATE(IMPACT)(const StateDataDefault& krStateData)
 	{
+		EUPHORIA_PROFILE_SCOPE(ThrowPerformance, IMPACT_UPDATE);
 		return STATEID_INVALID; 
 	}
 
 	void ThrowPerformance::STATEFN_EXIT(IMPACT)(const StateDataDefault& krStateData)
 	{
         AnimationCompPlugInInterface* pAnimation = mpOwner->GetAnimationInterface();
+		EUPHORIA_COUNT(eCountStopBehavior);
 		pAnimation->StopBehavior(EuphoriaBehaviorCRC::eImpact);
 	}
 
@@ -375,14 +435,18 @@ namespace euphoria
     //
     void ThrowPerformance::STATEFN_ENTER(CLEANUP)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ThrowPerformance, CLEANUP_ENTER);
+        EUPHORIA_ENTER_STATE(CLEANUP);
         LECTRACECH(LecTraceChannel::CHANNEL_EUPHORIA, "Throw::CLEANUP ENTERED\n");
 
         AnimationCompPlugInInterface* pAnimation = mpOwner->GetAnimationInterface();
+		EUPHORIA_COUNT(eCountStopAllBehaviors);
 		pAnimation->StopAllBehaviors();
     }
 
     StateID ThrowPerformance::STATEFN_UPDATE(CLEANUP)(const StateDataDefault& krStateData)
     {
+        EUPHORIA_PROFILE_SCOPE(ThrowPerformance, CLEANUP_UPDATE);
         // SM will always end in CLEANUP and start in IDLE. Does this have to be explicit?
         return STATEID(IDLE); 
     }
@@ -34,7 +34,6 @@ namespace euphoria
 		static const float msCrunchDelay;
 
 		// MEMBERS
-        Ronin::StateMachineInstance* mpStateMachine;
 		ThrowParams mParams;
 
         // Reference to the owning component's GrabbedEdgeInfo for convenience
@@ -43,6 +42,13 @@ namespace euphoria
         float mCheckStartTime;
 		float mCrunchStartTime;
 
+        //! What FLY and CRUNCH keep between updates, for a hot load
+        struct ResumeData
+        {
+            float checkStartTime;
+            float crunchStartTime;
+        };
+
         // UNIMPLEMENTED METHODS
         // Prevent copying and assignment
         ThrowPerformance(const ThrowPerformance&);
@@ -50,6 +56,8 @@ namespace euphoria
 
         // METHODS
         ThrowStateController& GetStateController();
+        virtual void SaveResumeData(unsigned char* pData) const;
+        virtual void LoadResumeData(const unsigned char* pData);
 
         // STATES
         DECLARE_STATE_EVENT(IDLE, const EuphoriaEvent);
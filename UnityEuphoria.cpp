@@ -1,5 +1,18 @@
+#include "EuphoriaAgentArbiter.cpp"
+#include "EuphoriaAgentPool.cpp"
+#include "EuphoriaBench.cpp"
 #include "EuphoriaComp.cpp"
+#include "EuphoriaDebugDraw.cpp"
 #include "EuphoriaManager.cpp"
+#include "EuphoriaOverrideBlock.cpp"
+#include "EuphoriaProfiler.cpp"
+#include "EuphoriaProxyRagdoll.cpp"
+#include "EuphoriaReplay.cpp"
+#include "EuphoriaScenario.cpp"
+#include "EuphoriaSettingsBundle.cpp"
+#include "EuphoriaSpatialHash.cpp"
+#include "EuphoriaTimeline.cpp"
+#include "EuphoriaTrace.cpp"
 #include "Performances/EuphoriaPerformance.cpp"
 #include "Performances/BalancePerformance.cpp"
 #include "Performances/BlendPerformance.cpp"